@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.18 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/fmt.hpp"
+#include "pfs/griotte/flex_layout.hpp"
+#include <chrono>
+
+using solver_type = pfs::griotte::flex_solver<int>;
+using rect_type = pfs::griotte::rect<int>;
+using size_type = pfs::griotte::size<int>;
+using pfs::griotte::orientation;
+
+static constexpr int ITEMS_COUNT = 10000;
+static constexpr int ITERATIONS = 100;
+
+// Root container with all items in wrapped lines
+static void build_wide (solver_type & s)
+{
+    auto root = s.add_container(solver_type::null_id, orientation::horizontal, true);
+    s.set_gap(root, 2);
+
+    for (int i = 1; i < ITEMS_COUNT; i++) {
+        auto id = s.add_item(root);
+        s.set_size_hint(id, size_type{20 + i % 30, 16});
+        s.set_grow(id, static_cast<float>(i % 3));
+    }
+}
+
+// Nested rows and columns: each container holds 4 items and next container
+static void build_deep (solver_type & s)
+{
+    auto parent = s.add_container(solver_type::null_id, orientation::vertical);
+    int count = 1;
+
+    while (count < ITEMS_COUNT) {
+        for (int i = 0; i < 4 && count < ITEMS_COUNT; i++, count++) {
+            auto id = s.add_item(parent);
+            s.set_size_hint(id, size_type{10, 10});
+            s.set_grow(id, 1);
+        }
+
+        auto dir = (count / 5) % 2 ? orientation::horizontal : orientation::vertical;
+        parent = s.add_container(parent, dir);
+        s.set_shrink(parent, 1);
+        count++;
+    }
+}
+
+template <typename Builder>
+static void run (char const * title, Builder && build)
+{
+    solver_type s;
+    s.reserve(ITEMS_COUNT);
+    build(s);
+
+    using clock_type = std::chrono::steady_clock;
+    auto start = clock_type::now();
+
+    for (int i = 0; i < ITERATIONS; i++)
+        s.solve(rect_type{0, 0, 1920 + i, 1080});
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - start).count();
+
+    fmt::print("{}: {} items, {} us per solve\n"
+        , title
+        , s.count()
+        , static_cast<double>(elapsed) / ITERATIONS);
+}
+
+int main ()
+{
+    run("Wide tree", build_wide);
+    run("Deep tree", build_deep);
+    return 0;
+}
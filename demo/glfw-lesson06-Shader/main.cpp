@@ -138,11 +138,11 @@ int main ()
             }
 
             // Poll for and process events
-            glfwPollEvents();
+            pfs::griotte::context::poll_events();
         }
 
         if (window) {
-            glfwDestroyWindow(window);
+            pfs::griotte::context::destroy_window(window);
             window = nullptr;
         }
 
@@ -142,72 +142,56 @@ int main ()
 //     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 //     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    return app.run( [] {
-        // Create a windowed mode window and its OpenGL context
-        GLFWwindow * window = glfwCreateWindow(WINDOW_WIDTH
-                , WINDOW_HEIGHT
-                , "Lesson 07"
-                , nullptr, nullptr);
-
-        if (!window)
-            return -1;
-
-        glfwSetWindowPos(window, 100, 200);
-
-        pfs::griotte::context::set_key_handler(window, [] (
-                  GLFWwindow * window
-                , int key
-                , int /*scancode*/
-                , int action
-                , int /*mods*/) {
-
-            switch (key) {
-                case GLFW_KEY_ESCAPE:
-                    if (action == GLFW_PRESS)
-                        glfwSetWindowShouldClose(window, GLFW_TRUE);
-                    break;
-
-                default:
-                    break;
-            }
-        });
-
-        fmt::print("Press ESC to close window (and thus quit application) ...\n");
-
-        // Before you can use the OpenGL API, you must have a current OpenGL
-        // context. The context will remain current until you make another
-        // context current or until the window owning the current context is
-        // destroyed.
-        // Make the window's context current.
-        glfwMakeContextCurrent(window);
-
-        // Initialize draw context
-        initialize();
-
-        auto title {fmt::format("Text render")};
-        glfwSetWindowTitle(window, title.c_str());
-
-        bool update {true};
-
-        while (!glfwWindowShouldClose(window)) {
-            if (update) {
-                // Render here
-                draw();
-
-                // Swap front and back buffers
-                glfwSwapBuffers(window);
-                update = false;
-            }
-
-            // Poll for and process events
-            glfwPollEvents();
-        }
+    // Create a windowed mode window and its OpenGL context
+    GLFWwindow * window = glfwCreateWindow(WINDOW_WIDTH
+            , WINDOW_HEIGHT
+            , "Lesson 07"
+            , nullptr, nullptr);
 
-        if (window) {
-            glfwDestroyWindow(window);
-            window = nullptr;
-        }
+    if (!window)
+        return -1;
+
+    glfwSetWindowPos(window, 100, 200);
 
-        return 0;
+    pfs::griotte::context::set_key_handler(window, [] (
+              GLFWwindow * window
+            , int key
+            , int /*scancode*/
+            , int action
+            , int /*mods*/) {
+
+        switch (key) {
+            case GLFW_KEY_ESCAPE:
+                if (action == GLFW_PRESS)
+                    glfwSetWindowShouldClose(window, GLFW_TRUE);
+                break;
+
+            default:
+                break;
+        }
     });
+
+    fmt::print("Press ESC to close window (and thus quit application) ...\n");
+
+    // Before you can use the OpenGL API, you must have a current OpenGL
+    // context. The context will remain current until you make another
+    // context current or until the window owning the current context is
+    // destroyed.
+    // Make the window's context current.
+    glfwMakeContextCurrent(window);
+
+    // Initialize draw context
+    initialize();
+
+    auto title {fmt::format("Text render")};
+    glfwSetWindowTitle(window, title.c_str());
+
+    // Render loop sleeps until window needs to be redrawn (no animation)
+    int result = app.run(window
+        , [] (double /*dt*/) { return false; }
+        , [] (double /*alpha*/) { draw(); });
+
+    app.destroy_window(window);
+
+    return result;
 }
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/fmt.hpp"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/parallel_tessellator.hpp"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using path_type = pfs::griotte::path<float>;
+using pen_type = pfs::griotte::pen<float>;
+using pfs::griotte::mesh;
+
+static constexpr int POLYLINES_COUNT = 4000;
+static constexpr int POINTS_COUNT = 500;
+static constexpr int ITERATIONS = 20;
+
+// Telemetry-like plots: long polylines with round joins
+static void build (std::vector<path_type> & paths, std::vector<pen_type> & pens)
+{
+    for (int i = 0; i < POLYLINES_COUNT; i++) {
+        path_type p;
+        p.move_to(0, 0);
+
+        for (int x = 1; x < POINTS_COUNT; x++)
+            p.line_to(x * 2.0f, 100 * std::sin(x * 0.05f + i));
+
+        paths.push_back(std::move(p));
+        pens.emplace_back(pfs::griotte::color{i % 256, 0, 0}, 1.5f
+            , pfs::griotte::cap_style::round
+            , pfs::griotte::join_style::round);
+    }
+}
+
+template <typename F>
+static double measure (F && f)
+{
+    using clock_type = std::chrono::steady_clock;
+    auto start = clock_type::now();
+
+    for (int i = 0; i < ITERATIONS; i++)
+        f();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - start).count();
+
+    return static_cast<double>(elapsed) / ITERATIONS / 1000;
+}
+
+int main ()
+{
+    std::vector<path_type> paths;
+    std::vector<pen_type> pens;
+    build(paths, pens);
+
+    mesh out;
+    pfs::griotte::tessellator<float> t;
+
+    double sequential = measure([&] {
+        out.clear();
+
+        for (std::size_t i = 0; i < paths.size(); i++)
+            t.stroke(paths[i], pens[i], out);
+    });
+
+    fmt::print("Sequential: {} triangles, {} ms per frame\n"
+        , out.indices.size() / 3, sequential);
+
+    unsigned int max_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int nthreads = 1; nthreads <= max_threads; nthreads *= 2) {
+        // Calling thread participates in jobs execution
+        pfs::griotte::job_system jobs {nthreads - 1};
+        pfs::griotte::parallel_tessellator<float> pt {jobs};
+
+        double parallel = measure([&] {
+            for (std::size_t i = 0; i < paths.size(); i++)
+                pt.stroke(paths[i], pens[i]);
+
+            pt.run(out);
+        });
+
+        fmt::print("Parallel ({} threads): {} ms per frame, speedup {:.2f}\n"
+            , nthreads, parallel, sequential / parallel);
+    }
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.28 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class frame_arena
+ * @brief Bump allocator for transient per-frame data.
+ *
+ * Memory is taken from large blocks by advancing a pointer, deallocation is
+ * a no-op, and all memory is released at once by reset() at the start of
+ * the next frame. After the first frames the arena reaches its working size
+ * and frames are built without any heap traffic.
+ *
+ * @note Not thread-safe: use an arena per thread, so threads building paths
+ *       do not contend for the heap or for each other.
+ */
+class frame_arena
+{
+    struct block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<block> _blocks;
+    std::size_t _current {0}; // index of the current block
+    std::size_t _offset {0};  // offset in the current block
+    std::size_t _block_size;
+    std::size_t _used {0};
+    std::size_t _peak {0};
+
+private:
+    void * allocate_in_block (std::size_t size, std::size_t alignment)
+    {
+        block & b = _blocks[_current];
+        auto base = reinterpret_cast<std::uintptr_t>(b.data.get());
+        std::uintptr_t p = (base + _offset + alignment - 1) & ~(std::uintptr_t{alignment} - 1);
+
+        if (p + size > base + b.size)
+            return nullptr;
+
+        _used += (p + size) - (base + _offset);
+        _offset = static_cast<std::size_t>(p + size - base);
+        return reinterpret_cast<void *>(p);
+    }
+
+public:
+    /**
+     * @param block_size Size of memory blocks requested from the heap.
+     */
+    explicit frame_arena (std::size_t block_size = 64 * 1024)
+        : _block_size(block_size)
+    {}
+
+    frame_arena (frame_arena const &) = delete;
+    frame_arena & operator = (frame_arena const &) = delete;
+
+    /**
+     * @brief Allocates @a size bytes aligned to @a alignment (power of two).
+     */
+    void * allocate (std::size_t size
+        , std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (!_blocks.empty()) {
+            void * p = allocate_in_block(size, alignment);
+
+            if (p)
+                return p;
+
+            // Try the next already allocated block
+            while (_current + 1 < _blocks.size()) {
+                ++_current;
+                _offset = 0;
+                p = allocate_in_block(size, alignment);
+
+                if (p)
+                    return p;
+            }
+        }
+
+        std::size_t bsize = (std::max)(_block_size, size + alignment);
+        _blocks.push_back(block{std::unique_ptr<char[]>{new char[bsize]}, bsize});
+        _current = _blocks.size() - 1;
+        _offset = 0;
+
+        return allocate_in_block(size, alignment);
+    }
+
+    /**
+     * @brief Does nothing, memory is reclaimed by reset().
+     */
+    void deallocate (void *, std::size_t) noexcept
+    {}
+
+    /**
+     * @brief Reclaims all allocated memory keeping blocks for reuse.
+     * @note Objects allocated in the arena must be destroyed (or be
+     *       trivially destructible) before reset.
+     */
+    void reset () noexcept
+    {
+        _peak = (std::max)(_peak, _used);
+        _current = 0;
+        _offset = 0;
+        _used = 0;
+    }
+
+    /**
+     * @brief Releases all blocks back to the heap.
+     */
+    void release () noexcept
+    {
+        reset();
+        _blocks.clear();
+    }
+
+    /**
+     * @return Number of bytes allocated since the last reset.
+     */
+    std::size_t used () const noexcept
+    {
+        return _used;
+    }
+
+    /**
+     * @return Maximum number of bytes allocated during a frame.
+     */
+    std::size_t peak () const noexcept
+    {
+        return (std::max)(_peak, _used);
+    }
+
+    /**
+     * @return Total size of blocks owned by the arena.
+     */
+    std::size_t capacity () const noexcept
+    {
+        std::size_t result = 0;
+
+        for (auto const & b: _blocks)
+            result += b.size;
+
+        return result;
+    }
+};
+
+/**
+ * @class arena_allocator
+ * @brief Standard allocator taking memory from frame_arena.
+ */
+template <typename T>
+class arena_allocator
+{
+    template <typename U>
+    friend class arena_allocator;
+
+    frame_arena * _arena;
+
+public:
+    using value_type = T;
+
+    arena_allocator (frame_arena & arena) noexcept
+        : _arena(& arena)
+    {}
+
+    template <typename U>
+    arena_allocator (arena_allocator<U> const & other) noexcept
+        : _arena(other._arena)
+    {}
+
+    T * allocate (std::size_t n)
+    {
+        if (n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+            throw std::bad_alloc{};
+
+        return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate (T * p, std::size_t n) noexcept
+    {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    frame_arena & arena () const noexcept
+    {
+        return *_arena;
+    }
+
+    template <typename U>
+    bool operator == (arena_allocator<U> const & rhs) const noexcept
+    {
+        return _arena == rhs._arena;
+    }
+
+    template <typename U>
+    bool operator != (arena_allocator<U> const & rhs) const noexcept
+    {
+        return _arena != rhs._arena;
+    }
+};
+
+}} // namespace pfs::griotte
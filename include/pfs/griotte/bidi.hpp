@@ -0,0 +1,700 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.06 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/shaped_run.hpp"
+#include "pfs/griotte/utf8.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Bidirectional character types of Unicode Standard Annex #9.
+ */
+enum class bidi_class : std::uint8_t
+{
+      l   ///< Left-to-right
+    , r   ///< Right-to-left (Hebrew)
+    , al  ///< Arabic letter
+    , en  ///< European number
+    , es  ///< European number separator
+    , et  ///< European number terminator
+    , an  ///< Arabic number
+    , cs  ///< Common number separator
+    , nsm ///< Nonspacing mark
+    , bn  ///< Boundary neutral (and explicit formatting characters)
+    , b   ///< Paragraph separator
+    , s   ///< Segment separator
+    , ws  ///< Whitespace
+    , on  ///< Other neutrals
+};
+
+/**
+ * @return Bidirectional type of code point @a cp.
+ */
+inline bidi_class bidi_class_of (char32_t cp) noexcept
+{
+    using c = bidi_class;
+
+    if (cp < 0x80) {
+        if (cp >= '0' && cp <= '9')
+            return c::en;
+
+        if ((cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z'))
+            return c::l;
+
+        switch (cp) {
+            case '\n': case '\r': case 0x1C: case 0x1D: case 0x1E: return c::b;
+            case '\t': case 0x0B: case 0x1F: return c::s;
+            case ' ': case 0x0C: return c::ws;
+            case '+': case '-': return c::es;
+            case '#': case '$': case '%': return c::et;
+            case ',': case '.': case '/': case ':': return c::cs;
+            default:
+                break;
+        }
+
+        return cp < 0x20 || cp == 0x7F ? c::bn : c::on;
+    }
+
+    switch (cp) {
+        case 0x0085: case 0x2029: return c::b;
+        case 0x00A0: case 0x060C: case 0x202F: case 0x2044: return c::cs;
+        case 0x00AD: case 0xFEFF: return c::bn;
+        case 0x00B2: case 0x00B3: case 0x00B9: return c::en;
+        case 0x00B0: case 0x00B1: case 0x0609: case 0x060A: case 0x066A: return c::et;
+        case 0x00AA: case 0x00B5: case 0x00BA: return c::l;
+        case 0x1680: case 0x2028: case 0x205F: case 0x3000: return c::ws;
+        case 0x200E: return c::l;  // LRM
+        case 0x200F: return c::r;  // RLM
+        case 0x061C: return c::al; // ALM
+        case 0x066B: case 0x066C: case 0x06DD: return c::an;
+        case 0x0670: case 0x05BF: case 0x05C7: return c::nsm;
+        default:
+            break;
+    }
+
+    if (cp < 0x0100)
+        return (cp >= 0x00C0 && cp != 0x00D7 && cp != 0x00F7) ? c::l
+            : (cp >= 0x00A2 && cp <= 0x00A5) ? c::et
+            : (cp >= 0x0080 && cp <= 0x009F) ? c::bn
+            : c::on;
+
+    // Nonspacing marks
+    if ((cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x0483 && cp <= 0x0489)
+            || (cp >= 0x0591 && cp <= 0x05BD) || (cp >= 0x05C1 && cp <= 0x05C2)
+            || (cp >= 0x05C4 && cp <= 0x05C5) || (cp >= 0x0610 && cp <= 0x061A)
+            || (cp >= 0x064B && cp <= 0x065F) || (cp >= 0x06D6 && cp <= 0x06DC)
+            || (cp >= 0x06DF && cp <= 0x06E4) || (cp >= 0x06E7 && cp <= 0x06E8)
+            || (cp >= 0x06EA && cp <= 0x06ED) || (cp >= 0x08D3 && cp <= 0x08FF)
+            || (cp >= 0x1AB0 && cp <= 0x1AFF) || (cp >= 0x1DC0 && cp <= 0x1DFF)
+            || (cp >= 0x20D0 && cp <= 0x20FF) || (cp >= 0xFE00 && cp <= 0xFE0F)
+            || (cp >= 0xFE20 && cp <= 0xFE2F) || cp == 0xFB1E) {
+        return c::nsm;
+    }
+
+    // Arabic digits and number signs
+    if ((cp >= 0x0600 && cp <= 0x0605) || (cp >= 0x0660 && cp <= 0x0669))
+        return c::an;
+
+    if (cp >= 0x06F0 && cp <= 0x06F9)
+        return c::en;
+
+    // Hebrew, NKo, Samaritan, ...
+    if ((cp >= 0x0590 && cp <= 0x05FF) || (cp >= 0x07C0 && cp <= 0x085F)
+            || (cp >= 0xFB1D && cp <= 0xFB4F) || (cp >= 0x10800 && cp <= 0x10FFF)
+            || (cp >= 0x1E800 && cp <= 0x1EFFF)) {
+        return c::r;
+    }
+
+    // Arabic, Syriac, Thaana and presentation forms
+    if ((cp >= 0x0600 && cp <= 0x07BF) || (cp >= 0x0860 && cp <= 0x08FF)
+            || (cp >= 0xFB50 && cp <= 0xFDFF) || (cp >= 0xFE70 && cp <= 0xFEFE)) {
+        return c::al;
+    }
+
+    // Zero width and explicit formatting characters (embeddings, overrides
+    // and isolates are not supported and ignored)
+    if ((cp >= 0x200B && cp <= 0x200D) || (cp >= 0x202A && cp <= 0x202E)
+            || (cp >= 0x2060 && cp <= 0x206F)) {
+        return c::bn;
+    }
+
+    if (cp >= 0x2000 && cp <= 0x200A)
+        return c::ws;
+
+    if ((cp >= 0x2070 && cp <= 0x2079 && cp != 0x2071) || (cp >= 0x2080 && cp <= 0x2089)
+            || (cp >= 0xFF10 && cp <= 0xFF19)) {
+        return c::en;
+    }
+
+    if (cp == 0x207A || cp == 0x207B || cp == 0x208A || cp == 0x208B
+            || cp == 0xFB29 || cp == 0xFE62 || cp == 0xFE63 || cp == 0xFF0B || cp == 0xFF0D) {
+        return c::es;
+    }
+
+    if ((cp >= 0x2030 && cp <= 0x2034) || (cp >= 0x20A0 && cp <= 0x20CF)
+            || (cp >= 0xFF03 && cp <= 0xFF05) || cp == 0xFFE0 || cp == 0xFFE1
+            || cp == 0xFFE5 || cp == 0xFFE6) {
+        return c::et;
+    }
+
+    if (cp == 0xFE50 || cp == 0xFE52 || cp == 0xFE55 || cp == 0xFF0C
+            || cp == 0xFF0E || cp == 0xFF0F || cp == 0xFF1A) {
+        return c::cs;
+    }
+
+    // Punctuation, symbols, arrows, math operators, box drawing, ...
+    if ((cp >= 0x2010 && cp <= 0x2027) || (cp >= 0x2035 && cp <= 0x205E)
+            || (cp >= 0x2100 && cp <= 0x2BFF && !(cp >= 0x2102 && cp <= 0x2139))
+            || (cp >= 0x3001 && cp <= 0x3004) || (cp >= 0x3008 && cp <= 0x3020)
+            || (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF01 && cp <= 0xFF02)
+            || (cp >= 0xFF06 && cp <= 0xFF0A) || (cp >= 0xFF1B && cp <= 0xFF20)
+            || (cp >= 0x1F000 && cp <= 0x1FAFF)) {
+        return c::on;
+    }
+
+    return c::l;
+}
+
+/**
+ * @brief Run of characters of the same embedding level.
+ */
+struct visual_run
+{
+    std::size_t  first; ///< Byte offset of the first character
+    std::size_t  last;  ///< Byte offset past the last character
+    std::uint8_t level; ///< Embedding level, odd levels are right-to-left
+
+    text_direction direction () const noexcept
+    {
+        return level % 2 ? text_direction::rtl : text_direction::ltr;
+    }
+};
+
+/**
+ * @class bidi_paragraph
+ * @brief Resolves embedding levels of a text by Unicode Bidirectional
+ *        Algorithm (UAX #9) and reorders lines into visual runs.
+ *
+ * Text is split into paragraphs at paragraph separators, the base level of
+ * every paragraph is taken from its first strong character unless the
+ * base direction is specified. Implemented rules: P1-P3, W1-W7, N1-N2,
+ * I1-I2, L1-L2. Explicit embeddings, overrides and isolates (X1-X8) are
+ * not supported: their control characters are ignored as boundary
+ * neutrals (X9).
+ *
+ * Visual runs are passed to the shaper with the run direction, which also
+ * mirrors brackets (L4) and places combining marks (L3) of right-to-left
+ * runs.
+ */
+class bidi_paragraph
+{
+    std::vector<std::size_t>  _offsets;     // byte offsets of code points (n + 1)
+    std::vector<bidi_class>   _classes;     // original classes
+    std::vector<std::uint8_t> _levels;      // resolved levels
+    std::vector<std::uint8_t> _base_levels; // paragraph level of code points
+    bool _rtl {false};                      // text contains right-to-left characters
+
+private:
+    static bool is_strong_rtl (bidi_class c) noexcept
+    {
+        return c == bidi_class::r || c == bidi_class::al;
+    }
+
+    static bool is_neutral (bidi_class c) noexcept
+    {
+        return c == bidi_class::b || c == bidi_class::s
+            || c == bidi_class::ws || c == bidi_class::on;
+    }
+
+    /**
+     * @brief Resolves levels of the paragraph [@a first, @a last).
+     */
+    void resolve (std::size_t first, std::size_t last, text_direction base);
+
+    std::size_t index_of (std::size_t offset) const noexcept
+    {
+        return static_cast<std::size_t>(std::lower_bound(_offsets.begin(), _offsets.end(), offset)
+            - _offsets.begin());
+    }
+
+public:
+    bidi_paragraph () = default;
+
+    bidi_paragraph (char const * text, std::size_t len
+        , text_direction base = text_direction::automatic)
+    {
+        analyze(text, len, base);
+    }
+
+    /**
+     * @brief Resolves embedding levels of UTF-8 @a text of @a len bytes.
+     *
+     * @param base Direction of paragraphs (text_direction::ltr or
+     *        text_direction::rtl), text_direction::automatic to detect it
+     *        from the first strong character of a paragraph.
+     */
+    void analyze (char const * text, std::size_t len
+        , text_direction base = text_direction::automatic);
+
+    /**
+     * @return @c true if the text is left-to-right only (and so a line
+     *         consists of a single visual run).
+     */
+    bool is_ltr () const noexcept
+    {
+        return !_rtl;
+    }
+
+    /**
+     * @return Embedding levels of code points.
+     */
+    std::vector<std::uint8_t> const & get_levels () const noexcept
+    {
+        return _levels;
+    }
+
+    /**
+     * @return Level of the paragraph containing the character at byte
+     *         @a offset.
+     */
+    std::uint8_t get_base_level (std::size_t offset = 0) const noexcept
+    {
+        std::size_t i = index_of(offset);
+        return i < _base_levels.size() ? _base_levels[i]
+            : _base_levels.empty() ? 0 : _base_levels.back();
+    }
+
+    /**
+     * @brief Appends visual runs of the line [@a first, @a last) (byte
+     *        offsets within one paragraph) to @a out in visual order
+     *        (left to right).
+     */
+    void visual_runs (std::size_t first, std::size_t last, std::vector<visual_run> & out) const;
+};
+
+inline void bidi_paragraph::analyze (char const * text, std::size_t len, text_direction base)
+{
+    _offsets.clear();
+    _classes.clear();
+    _rtl = base == text_direction::rtl;
+
+    std::size_t pos = 0;
+
+    while (pos < len) {
+        _offsets.push_back(pos);
+        bidi_class c = bidi_class_of(utf8_decode(text, len, pos));
+        _classes.push_back(c);
+        _rtl = _rtl || is_strong_rtl(c) || c == bidi_class::an;
+    }
+
+    _offsets.push_back(len);
+
+    std::size_t n = _classes.size();
+    _levels.assign(n, 0);
+    _base_levels.assign(n, 0);
+
+    // Left-to-right text: all levels are zero
+    if (!_rtl)
+        return;
+
+    // P1: split into paragraphs (separator belongs to the preceding one)
+    std::size_t first = 0;
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (_classes[i] == bidi_class::b) {
+            resolve(first, i + 1, base);
+            first = i + 1;
+        }
+    }
+
+    if (first < n)
+        resolve(first, n, base);
+}
+
+inline void bidi_paragraph::resolve (std::size_t first, std::size_t last, text_direction base)
+{
+    using c = bidi_class;
+
+    // P2, P3: paragraph level
+    std::uint8_t level = 0;
+
+    if (base == text_direction::rtl) {
+        level = 1;
+    } else if (base != text_direction::ltr) {
+        for (std::size_t i = first; i < last; i++) {
+            if (_classes[i] == c::l)
+                break;
+
+            if (is_strong_rtl(_classes[i])) {
+                level = 1;
+                break;
+            }
+        }
+    }
+
+    std::fill(_base_levels.begin() + first, _base_levels.begin() + last, level);
+
+    // X9: boundary neutrals are removed, the rules below operate on the
+    // remaining characters (indices in 'chars')
+    std::vector<std::size_t> chars;
+    std::vector<c> types;
+    chars.reserve(last - first);
+    types.reserve(last - first);
+
+    for (std::size_t i = first; i < last; i++) {
+        if (_classes[i] != c::bn) {
+            chars.push_back(i);
+            types.push_back(_classes[i]);
+        }
+    }
+
+    // X10: single isolating run sequence with sos and eos of the paragraph
+    // direction
+    c sos = level % 2 ? c::r : c::l;
+    std::size_t n = types.size();
+
+    // W1: nonspacing marks take the type of the previous character
+    for (std::size_t i = 0; i < n; i++) {
+        if (types[i] == c::nsm)
+            types[i] = i > 0 ? types[i - 1] : sos;
+    }
+
+    // W2: European numbers after Arabic letters are Arabic numbers,
+    // W3: Arabic letters are right-to-left
+    c last_strong = sos;
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (types[i] == c::l || types[i] == c::r || types[i] == c::al)
+            last_strong = types[i];
+        else if (types[i] == c::en && last_strong == c::al)
+            types[i] = c::an;
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (types[i] == c::al)
+            types[i] = c::r;
+    }
+
+    // W4: single separators between numbers
+    for (std::size_t i = 1; i + 1 < n; i++) {
+        if (types[i] == c::es && types[i - 1] == c::en && types[i + 1] == c::en)
+            types[i] = c::en;
+        else if (types[i] == c::cs && types[i - 1] == types[i + 1]
+                && (types[i - 1] == c::en || types[i - 1] == c::an))
+            types[i] = types[i - 1];
+    }
+
+    // W5: terminators adjacent to European numbers
+    for (std::size_t i = 0; i < n; i++) {
+        if (types[i] != c::et)
+            continue;
+
+        std::size_t j = i;
+
+        while (j < n && types[j] == c::et)
+            ++j;
+
+        bool en = (i > 0 && types[i - 1] == c::en) || (j < n && types[j] == c::en);
+
+        if (en)
+            std::fill(types.begin() + i, types.begin() + j, c::en);
+
+        i = j - 1;
+    }
+
+    // W6: remaining separators and terminators are neutrals,
+    // W7: European numbers after left-to-right are left-to-right
+    last_strong = sos;
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (types[i] == c::es || types[i] == c::et || types[i] == c::cs)
+            types[i] = c::on;
+
+        if (types[i] == c::l || types[i] == c::r)
+            last_strong = types[i];
+        else if (types[i] == c::en && last_strong == c::l)
+            types[i] = c::l;
+    }
+
+    // N1, N2: neutrals between characters of the same direction take it
+    // (numbers are right-to-left), otherwise the paragraph direction
+    auto strong_of = [] (c t) {
+        return t == c::l ? c::l : c::r;
+    };
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (!is_neutral(types[i]))
+            continue;
+
+        std::size_t j = i;
+
+        while (j < n && is_neutral(types[j]))
+            ++j;
+
+        c before = i > 0 ? strong_of(types[i - 1]) : sos;
+        c after = j < n ? strong_of(types[j]) : sos;
+        c t = before == after ? before : sos;
+
+        std::fill(types.begin() + i, types.begin() + j, t);
+        i = j - 1;
+    }
+
+    // I1, I2: implicit levels
+    for (std::size_t k = 0; k < n; k++) {
+        std::uint8_t l = level;
+
+        if (level % 2 == 0)
+            l += types[k] == c::r ? 1 : (types[k] == c::an || types[k] == c::en) ? 2 : 0;
+        else
+            l += types[k] != c::r ? 1 : 0;
+
+        _levels[chars[k]] = l;
+    }
+
+    // Removed characters take the level of the preceding character
+    for (std::size_t i = first; i < last; i++) {
+        if (_classes[i] == c::bn)
+            _levels[i] = i > first ? _levels[i - 1] : level;
+    }
+}
+
+inline void bidi_paragraph::visual_runs (std::size_t first_offset
+    , std::size_t last_offset
+    , std::vector<visual_run> & out) const
+{
+    std::size_t first = index_of(first_offset);
+    std::size_t last = (std::min)(index_of(last_offset), _classes.size());
+
+    if (first >= last)
+        return;
+
+    std::uint8_t base = _base_levels[first];
+
+    if (!_rtl) {
+        out.push_back(visual_run{_offsets[first], _offsets[last], base});
+        return;
+    }
+
+    // L1: separators and trailing whitespace are reset to the paragraph level
+    std::size_t trailing = last;
+
+    while (trailing > first) {
+        bidi_class c = _classes[trailing - 1];
+
+        if (c != bidi_class::ws && c != bidi_class::bn
+                && c != bidi_class::s && c != bidi_class::b)
+            break;
+
+        --trailing;
+    }
+
+    auto level_of = [&] (std::size_t i) -> std::uint8_t {
+        if (i >= trailing)
+            return base;
+
+        if (_classes[i] == bidi_class::s || _classes[i] == bidi_class::b)
+            return base;
+
+        // Whitespace before a segment separator
+        if (_classes[i] == bidi_class::ws || _classes[i] == bidi_class::bn) {
+            std::size_t j = i;
+
+            while (j < trailing && (_classes[j] == bidi_class::ws || _classes[j] == bidi_class::bn))
+                ++j;
+
+            if (j < trailing && _classes[j] == bidi_class::s)
+                return base;
+        }
+
+        return _levels[i];
+    };
+
+    // Level runs in logical order
+    std::size_t begin = out.size();
+    std::uint8_t max_level = 0;
+    std::uint8_t min_odd = 0xFF;
+
+    for (std::size_t i = first; i < last;) {
+        std::uint8_t l = level_of(i);
+        std::size_t j = i + 1;
+
+        while (j < last && level_of(j) == l)
+            ++j;
+
+        out.push_back(visual_run{_offsets[i], _offsets[j], l});
+        max_level = (std::max)(max_level, l);
+
+        if (l % 2)
+            min_odd = (std::min)(min_odd, l);
+
+        i = j;
+    }
+
+    // L2: reverse sequences of runs at every level from the highest to the
+    // lowest odd level
+    for (std::uint8_t l = max_level; l >= min_odd && l > 0; l--) {
+        for (std::size_t i = begin; i < out.size();) {
+            if (out[i].level < l) {
+                ++i;
+                continue;
+            }
+
+            std::size_t j = i;
+
+            while (j < out.size() && out[j].level >= l)
+                ++j;
+
+            std::reverse(out.begin() + i, out.begin() + j);
+            i = j;
+        }
+    }
+}
+
+/**
+ * @brief Visual runs of a single-line text.
+ */
+struct bidi_text
+{
+    std::uint8_t base_level {0};
+    std::vector<visual_run> runs; ///< In visual order
+};
+
+/**
+ * @class visual_run_cache
+ * @brief LRU cache of visual runs of single-line texts (labels) keyed by
+ *        text and base direction.
+ *
+ * Used together with shaped_run_cache: every visual run is shaped with its
+ * direction, so a bidirectional label is analyzed and shaped once and
+ * drawn at the cost of two lookups afterwards.
+ *
+ * @note Not thread-safe.
+ */
+class visual_run_cache
+{
+public:
+    using text_pointer = std::shared_ptr<bidi_text const>;
+
+private:
+    struct entry
+    {
+        std::size_t    hash;
+        text_direction base;
+        std::string    text;
+        text_pointer   value;
+    };
+
+    using entry_list = std::list<entry>;
+
+    std::size_t _capacity;
+    entry_list _entries; // most recently used first
+    std::unordered_map<std::size_t, entry_list::iterator> _index;
+    bidi_paragraph _bidi;
+    std::size_t _hits {0};
+    std::size_t _misses {0};
+
+public:
+    /**
+     * @param capacity Maximum number of cached texts.
+     */
+    explicit visual_run_cache (std::size_t capacity = 1024)
+        : _capacity(capacity > 0 ? capacity : 1)
+    {}
+
+    std::size_t size () const noexcept
+    {
+        return _entries.size();
+    }
+
+    std::size_t hits () const noexcept
+    {
+        return _hits;
+    }
+
+    std::size_t misses () const noexcept
+    {
+        return _misses;
+    }
+
+    void clear ()
+    {
+        _index.clear();
+        _entries.clear();
+    }
+
+    /**
+     * @return Visual runs of UTF-8 @a text of @a len bytes.
+     */
+    text_pointer get (char const * text, std::size_t len
+        , text_direction base = text_direction::automatic);
+
+    text_pointer get (std::string const & text
+        , text_direction base = text_direction::automatic)
+    {
+        return get(text.data(), text.size(), base);
+    }
+};
+
+inline visual_run_cache::text_pointer
+visual_run_cache::get (char const * text, std::size_t len, text_direction base)
+{
+    std::size_t h = details::hash_combine(details::hash_bytes(text, len)
+        , static_cast<std::size_t>(base));
+
+    auto pos = _index.find(h);
+
+    if (pos != _index.end()) {
+        entry const & e = *pos->second;
+
+        if (e.base == base && e.text.size() == len
+                && (len == 0 || std::memcmp(e.text.data(), text, len) == 0)) {
+            ++_hits;
+            _entries.splice(_entries.begin(), _entries, pos->second);
+            return e.value;
+        }
+
+        // Hash collision: the slot is reused for the new text
+        _entries.erase(pos->second);
+        _index.erase(pos);
+    }
+
+    ++_misses;
+
+    auto value = std::make_shared<bidi_text>();
+    _bidi.analyze(text, len, base);
+    value->base_level = _bidi.get_base_level();
+    _bidi.visual_runs(0, len, value->runs);
+
+    if (_entries.size() >= _capacity) {
+        auto last = std::prev(_entries.end());
+        auto it = _index.find(last->hash);
+
+        if (it != _index.end() && it->second == last)
+            _index.erase(it);
+
+        _entries.erase(last);
+    }
+
+    _entries.push_front(entry{h, base, std::string{text, len}, value});
+    _index[h] = _entries.begin();
+
+    return value;
+}
+
+}} // namespace pfs::griotte
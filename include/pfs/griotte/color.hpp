@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 namespace pfs {
 namespace griotte {
@@ -32,6 +33,17 @@ public:
     constexpr int get_red ()   const noexcept { return _red; }
     constexpr int get_green () const noexcept { return _green; }
     constexpr int get_blue ()  const noexcept { return _blue; }
+
+    constexpr bool operator == (rgba_color const & rhs) const noexcept
+    {
+        return _alpha == rhs._alpha && _red == rhs._red
+            && _green == rhs._green && _blue == rhs._blue;
+    }
+
+    constexpr bool operator != (rgba_color const & rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
 };
 
 using color = rgba_color;
@@ -5,11 +5,28 @@
 //
 // Changelog:
 //      2020.04.26 Initial version
+//      2021.07.07 Added font_collection.
+//      2021.07.13 request_redraw() does not access windows.
+//      2021.07.13 run_windows() moves vsync to the first open window.
 ////////////////////////////////////////////////////////////////////////////////
+#pragma once
 #include "pfs/fmt.hpp"
+#include "pfs/griotte/event_queue.hpp"
 #include "pfs/griotte/font.hpp"
+#include "pfs/griotte/font_collection.hpp"
+#include "pfs/griotte/frame_scheduler.hpp"
+#include "pfs/griotte/small_function.hpp"
+#include "pfs/griotte/triple_buffer.hpp"
 #include "GLFW/glfw3.h"
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // * Do not include the OpenGL header yourself, as GLFW does this for you in a
 //   platform-independent way
@@ -24,23 +41,71 @@
 namespace pfs {
 namespace griotte {
 
+using error_handler_type = small_function<void (int, char const *)>;
+
+using key_handler_type = small_function<void (GLFWwindow * /*window*/
+    , int /*key*/
+    , int /*scancode*/
+    , int /*action*/
+    , int /*modsint*/)>;
+
+using framebuffer_size_handler_type = small_function<void (GLFWwindow * /*window*/
+    , int /*width*/
+    , int /*height*/)>;
+
+using monitor_handler_type = small_function<void (GLFWmonitor * /*monitor*/
+    , int /*event*/)>;
+
+using event_handler_type = small_function<void (event const &)>;
+
+//
+// Per-window data, accessible from GLFW callbacks through the window user
+// pointer.
+//
+struct window_data
+{
+    key_handler_type key_handler;
+
+    // Empty handler means default behaviour (see context::dispatch_events)
+    framebuffer_size_handler_type framebuffer_size_handler;
+
+    // Called for every input event of the window after specific handlers
+    event_handler_type event_handler;
+
+    // Window needs to be redrawn
+    std::atomic<bool> dirty {true};
+
+    // OpenGL context of the window is owned by the render thread
+    // (see context::run_threaded), so the default viewport rearrangement is
+    // deferred to it.
+    std::atomic<bool> threaded {false};
+
+    static constexpr std::uint64_t no_viewport = ~std::uint64_t{0};
+
+    // Pending viewport size packed as (width << 32 | height)
+    std::atomic<std::uint64_t> pending_viewport {no_viewport};
+
+    // Swap interval set to the OpenGL context of the window by the render
+    // loop, negative if not set yet
+    int swap_interval {-1};
+};
+
 template <typename dummy>
 struct context_static_members
 {
-    static std::function<void (int, char const *)> error_handler;
+    static error_handler_type error_handler;
+    static monitor_handler_type monitor_handler;
+    static frame_scheduler scheduler;
 
-    static std::function<void (GLFWwindow * /*window*/
-        , int /*key*/
-        , int /*scancode*/
-        , int /*action*/
-        , int /*modsint*/)> key_handler;
+    // Input events pending dispatch
+    static event_queue events;
 
-    static std::function<void (GLFWwindow * /*window*/
-        , int /*width*/
-        , int /*height*/)> framebuffer_size_handler;
+    // Registered windows in creation order
+    static std::vector<std::pair<GLFWwindow *, std::unique_ptr<window_data>>> windows;
 
-    static std::function<void (GLFWmonitor * /*monitor*/
-        , int /*event*/)> monitor_handler;
+    // All windows need to be redrawn (set by request_redraw() from any
+    // thread, windows are accessed by the main thread only)
+    static std::atomic<bool> redraw_all;
 };
 
 class context : public context_static_members<int>
@@ -99,6 +164,9 @@ public:
 
     ~context ()
     {
+        while (!windows.empty())
+            destroy_window(windows.back().first);
+
         FT_Done_FreeType(_font_library);
         glfwTerminate();
     }
@@ -120,6 +188,155 @@ public:
         return result;
     }
 
+    /**
+     * @brief Runs event-driven render loop for @a window until the window
+     *        should close.
+     *
+     * The loop blocks waiting for events while there is nothing to redraw or
+     * animate, so an idle application consumes no CPU time. Frames are paced
+     * by vertical synchronization if @a vsync is @c true or by the frame
+     * budget (according to the monitor refresh rate) otherwise.
+     *
+     * @param update Animation tick handler with signature 'bool (double dt)',
+     *        called with fixed timestep while animation is running. Returns
+     *        @c false to stop animation.
+     * @param render Frame render handler with signature 'void (double alpha)',
+     *        where @a alpha is an interpolation factor between the previous and
+     *        the current animation state.
+     *
+     * @see request_redraw(), start_animation().
+     */
+    template <typename Update, typename Render>
+    int run (GLFWwindow * window, Update && update, Render && render, bool vsync = true);
+
+    /**
+     * @brief Runs event-driven render loop for all windows created by
+     *        create_window() until all of them should close.
+     *
+     * Only windows requested to redraw (or all windows while animation is
+     * running) are rendered. Only the first open window waits for the
+     * vertical retrace, so the frame rate does not drop with number of
+     * windows. Frames without such a swap (e.g. the first window is closed
+     * and hidden) are paced by the frame budget.
+     *
+     * @param update Animation tick handler with signature 'bool (double dt)'.
+     * @param render Window render handler with signature
+     *        'void (GLFWwindow * window, double alpha)', called with the window
+     *        OpenGL context made current.
+     */
+    template <typename Update, typename Render>
+    int run_windows (Update && update, Render && render, bool vsync = true);
+
+    /**
+     * @brief Runs render loop for @a window with OpenGL submission on
+     *        a dedicated render thread.
+     *
+     * The calling (main) thread processes events, runs animation ticks and
+     * builds frame descriptions of type @a Frame. The render thread owns the
+     * OpenGL context of the window and renders the latest built frame,
+     * so blocking buffer swap does not delay input handling and building of
+     * the next frame overlaps with rendering of the previous one. Frames are
+     * handed off through the lock-free triple buffer, frames not rendered in
+     * time are dropped.
+     *
+     * @param update Animation tick handler with signature 'bool (double dt)'.
+     * @param build Frame build handler with signature
+     *        'void (Frame & frame, double alpha)', called on the main thread.
+     * @param render Frame render handler with signature
+     *        'void (Frame const & frame)', called on the render thread.
+     *
+     * @note Handlers called on the main thread must not use OpenGL.
+     */
+    template <typename Frame, typename Update, typename Build, typename Render>
+    int run_threaded (GLFWwindow * window
+        , Update && update
+        , Build && build
+        , Render && render
+        , bool vsync = true);
+
+    /**
+     * @brief Creates window and its OpenGL context.
+     *
+     * The context of the new window shares objects (textures, buffers, etc)
+     * with the context of the first created window, so glyph textures loaded
+     * once may be used to render any window.
+     *
+     * @param monitor Monitor to use for full screen mode, or @c nullptr for
+     *        windowed mode.
+     * @return Window handle or @c nullptr on error.
+     */
+    GLFWwindow * create_window (int width
+        , int height
+        , std::string const & title
+        , GLFWmonitor * monitor = nullptr)
+    {
+        GLFWwindow * share = windows.empty() ? nullptr : windows.front().first;
+        GLFWwindow * window = glfwCreateWindow(width, height, title.c_str()
+            , monitor, share);
+
+        if (window)
+            register_window(window);
+
+        return window;
+    }
+
+    /**
+     * @brief Destroys @a window and its handlers.
+     */
+    static void destroy_window (GLFWwindow * window)
+    {
+        auto pos = find_window(window);
+
+        if (pos != windows.end()) {
+            glfwSetWindowUserPointer(window, nullptr);
+            glfwDestroyWindow(window);
+            windows.erase(pos);
+        }
+    }
+
+    /**
+     * @brief Requests rendering of the next frame and wakes up the render loop.
+     * @note Can be called from any thread.
+     */
+    static void request_redraw ()
+    {
+        redraw_all.store(true, std::memory_order_release);
+        scheduler.request_redraw();
+        glfwPostEmptyEvent();
+    }
+
+    /**
+     * @brief Requests rendering of the next frame of @a window only.
+     * @note Can be called from any thread while @a window exists.
+     */
+    static void request_redraw (GLFWwindow * window)
+    {
+        window_data * d = static_cast<window_data *>(glfwGetWindowUserPointer(window));
+
+        if (d)
+            d->dirty.store(true, std::memory_order_release);
+
+        scheduler.request_redraw();
+        glfwPostEmptyEvent();
+    }
+
+    /**
+     * @brief Starts running animation ticks by the render loop.
+     */
+    static void start_animation ()
+    {
+        scheduler.set_animating(true);
+        request_redraw();
+    }
+
+    /**
+     * @return Frame scheduler used by the render loop.
+     */
+    static frame_scheduler & get_scheduler ()
+    {
+        return scheduler;
+    }
+
     std::string const & errorstr () const
     {
         return _errorstr;
@@ -184,25 +401,134 @@ public:
         glfwSetErrorCallback(error_callback);
     }
 
+    /**
+     * @brief Sets key handler for @a window (other windows are not affected).
+     */
     template <typename KeyHandler>
     static void set_key_handler (GLFWwindow * window, KeyHandler && handler)
     {
-        if (window) {
-            key_handler = std::forward<KeyHandler>(handler);
-            glfwSetKeyCallback(window, key_callback);
-        }
+        if (window)
+            register_window(window)->key_handler = std::forward<KeyHandler>(handler);
     }
 
+    /**
+     * @brief Sets framebuffer size handler for @a window (other windows are
+     *        not affected).
+     */
     template <typename FramebufferSizeHandler>
     static void set_framebuffer_size_handler (GLFWwindow * window
         , FramebufferSizeHandler && handler)
     {
         if (window) {
-            framebuffer_size_handler = std::forward<FramebufferSizeHandler>(handler);
-            glfwSetFramebufferSizeCallback(window, framebuffersize_callback);
+            register_window(window)->framebuffer_size_handler
+                = std::forward<FramebufferSizeHandler>(handler);
         }
     }
 
+    /**
+     * @brief Sets handler for all input events of @a window.
+     */
+    template <typename EventHandler>
+    static void set_event_handler (GLFWwindow * window, EventHandler && handler)
+    {
+        if (window)
+            register_window(window)->event_handler = std::forward<EventHandler>(handler);
+    }
+
+    /**
+     * @brief Processes events already in the GLFW event queue and dispatches
+     *        them to handlers.
+     */
+    static void poll_events ()
+    {
+        glfwPollEvents();
+        dispatch_events();
+    }
+
+    /**
+     * @brief Waits until at least one event is available or @a timeout
+     *        (in seconds) expires and dispatches events to handlers.
+     *
+     * Negative @a timeout means wait without time limit.
+     */
+    static void wait_events (double timeout = -1.0)
+    {
+        if (timeout < 0)
+            glfwWaitEvents();
+        else if (timeout > 0)
+            glfwWaitEventsTimeout(timeout);
+        else
+            glfwPollEvents();
+
+        dispatch_events();
+    }
+
+    /**
+     * @brief Dispatches queued input events to window handlers.
+     *
+     * GLFW callbacks only enqueue events (coalescing bursts of cursor moves,
+     * scrolls and resizes), so handlers are called here, once per frame,
+     * outside of the GLFW event processing.
+     *
+     * @return Number of dispatched events.
+     */
+    static std::size_t dispatch_events ()
+    {
+        return events.drain([] (event const & ev) {
+            // Window might be destroyed by one of the previous handlers
+            auto pos = find_window(ev.window);
+
+            if (pos == windows.end())
+                return;
+
+            window_data * d = pos->second.get();
+
+            switch (ev.type) {
+                case event_type::key:
+                    if (d->key_handler) {
+                        d->key_handler(ev.window, ev.key.key, ev.key.scancode
+                            , ev.key.action, ev.key.mods);
+                    }
+                    break;
+
+                case event_type::framebuffer_size:
+                    if (d->framebuffer_size_handler) {
+                        d->framebuffer_size_handler(ev.window
+                            , ev.framebuffer_size.width
+                            , ev.framebuffer_size.height);
+                    } else if (d->threaded.load(std::memory_order_acquire)) {
+                        d->pending_viewport.store(
+                              std::uint64_t(ev.framebuffer_size.width) << 32
+                            | std::uint32_t(ev.framebuffer_size.height)
+                            , std::memory_order_release);
+                    } else {
+                        // By default rearranges OpenGL viewport of the window
+                        // to the current framebuffer size.
+                        GLFWwindow * current = glfwGetCurrentContext();
+
+                        if (current != ev.window)
+                            glfwMakeContextCurrent(ev.window);
+
+                        glViewport(0, 0, ev.framebuffer_size.width
+                            , ev.framebuffer_size.height);
+
+                        if (current != ev.window)
+                            glfwMakeContextCurrent(current);
+                    }
+
+                    d->dirty.store(true, std::memory_order_release);
+                    scheduler.request_redraw();
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (d->event_handler)
+                d->event_handler(ev);
+        });
+    }
+
     template <typename MonitorHandler>
     static void set_monitor_handler (MonitorHandler && handler)
     {
@@ -211,9 +537,58 @@ public:
     }
 
 private:
+    using window_iterator = decltype(windows)::iterator;
+
+    static window_iterator find_window (GLFWwindow * window)
+    {
+        return std::find_if(windows.begin(), windows.end()
+            , [window] (std::pair<GLFWwindow *, std::unique_ptr<window_data>> const & w) {
+                return w.first == window;
+            });
+    }
+
+    /**
+     * @brief Attaches dispatch data to @a window if it is not attached yet.
+     * @note Windows created by glfwCreateWindow() directly are registered on
+     *       first handler assignment, destroy them by destroy_window().
+     */
+    static window_data * register_window (GLFWwindow * window)
+    {
+        window_data * d = static_cast<window_data *>(glfwGetWindowUserPointer(window));
+
+        if (d)
+            return d;
+
+        windows.emplace_back(window, std::unique_ptr<window_data>{new window_data});
+        d = windows.back().second.get();
+
+        glfwSetWindowUserPointer(window, d);
+        glfwSetKeyCallback(window, key_callback);
+        glfwSetCharCallback(window, char_callback);
+        glfwSetMouseButtonCallback(window, mouse_button_callback);
+        glfwSetCursorPosCallback(window, cursor_pos_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetFramebufferSizeCallback(window, framebuffersize_callback);
+        glfwSetWindowCloseCallback(window, close_callback);
+
+        // Window contents damaged (e.g. uncovered) and need to be refreshed
+        glfwSetWindowRefreshCallback(window, refresh_callback);
+
+        return d;
+    }
+
     static void error_callback (int error, char const * description)
     {
-        error_handler(error, description);
+        if (error_handler)
+            error_handler(error, description);
+    }
+
+    static event make_event (event_type type, GLFWwindow * window)
+    {
+        event ev;
+        ev.type = type;
+        ev.window = window;
+        return ev;
     }
 
     static void key_callback (GLFWwindow * window
@@ -222,19 +597,70 @@ private:
             , int action
             , int mods)
     {
-        key_handler(window, key, scancode, action, mods);
+        event ev = make_event(event_type::key, window);
+        ev.key = key_event{key, scancode, action, mods};
+        events.push(ev);
+    }
+
+    static void char_callback (GLFWwindow * window, unsigned int codepoint)
+    {
+        event ev = make_event(event_type::character, window);
+        ev.character = character_event{codepoint};
+        events.push(ev);
+    }
+
+    static void mouse_button_callback (GLFWwindow * window
+            , int button
+            , int action
+            , int mods)
+    {
+        event ev = make_event(event_type::mouse_button, window);
+        ev.mouse_button = mouse_button_event{button, action, mods};
+        events.push(ev);
+    }
+
+    static void cursor_pos_callback (GLFWwindow * window, double x, double y)
+    {
+        event ev = make_event(event_type::cursor_pos, window);
+        ev.cursor_pos = cursor_pos_event{x, y};
+        events.push(ev);
+    }
+
+    static void scroll_callback (GLFWwindow * window, double dx, double dy)
+    {
+        event ev = make_event(event_type::scroll, window);
+        ev.scroll = scroll_event{dx, dy};
+        events.push(ev);
     }
 
     static void framebuffersize_callback (GLFWwindow * window
             , int width
             , int height)
     {
-        framebuffer_size_handler(window, width, height);
+        event ev = make_event(event_type::framebuffer_size, window);
+        ev.framebuffer_size = framebuffer_size_event{width, height};
+        events.push(ev);
+    }
+
+    static void close_callback (GLFWwindow * window)
+    {
+        events.push(make_event(event_type::window_close, window));
     }
 
     static void monitor_callback (GLFWmonitor * monitor, int event)
     {
-        monitor_handler(monitor, event);
+        if (monitor_handler)
+            monitor_handler(monitor, event);
+    }
+
+    static void refresh_callback (GLFWwindow * window)
+    {
+        window_data * d = static_cast<window_data *>(glfwGetWindowUserPointer(window));
+
+        if (d)
+            d->dirty.store(true, std::memory_order_release);
+
+        scheduler.request_redraw();
     }
 
 private:
@@ -243,30 +669,260 @@ private:
     FT_Library _font_library;
 };
 
+/**
+ * @brief Font fallback chain loading faces by the context.
+ */
+using font_collection = basic_font_collection<context, font>;
+
 template <typename dummy>
-std::function<void (int, char const *)> context_static_members<dummy>::error_handler;
+error_handler_type context_static_members<dummy>::error_handler;
 
 template <typename dummy>
-std::function<void (GLFWwindow * /*window*/
-    , int /*key*/
-    , int /*scancode*/
-    , int /*action*/
-    , int /*modsint*/)> context_static_members<dummy>::key_handler;
+monitor_handler_type context_static_members<dummy>::monitor_handler;
 
 template <typename dummy>
-std::function<void (GLFWwindow * /*window*/
-    , int /*width*/
-    , int /*height*/)> context_static_members<dummy>::framebuffer_size_handler {[] (
-          GLFWwindow * /*window*/
-        , int width
-        , int height) {
-            // By defualt rearranges OpenGL viewport to the current
-            // framebuffer size.
-            glViewport(0, 0, width, height);
-    }};
+frame_scheduler context_static_members<dummy>::scheduler;
+
+template <typename dummy>
+event_queue context_static_members<dummy>::events;
 
 template <typename dummy>
-std::function<void (GLFWmonitor * /*monitor*/
-    , int /*event*/)> context_static_members<dummy>::monitor_handler;
+std::vector<std::pair<GLFWwindow *, std::unique_ptr<window_data>>>
+context_static_members<dummy>::windows;
+
+template <typename dummy>
+std::atomic<bool> context_static_members<dummy>::redraw_all {false};
+
+template <typename Update, typename Render>
+int context::run (GLFWwindow * window, Update && update, Render && render, bool vsync)
+{
+    if (!_initialized || !window)
+        return -1;
+
+    register_window(window);
+    glfwMakeContextCurrent(window);
+
+    // Swap buffers blocks until the vertical retrace
+    glfwSwapInterval(vsync ? 1 : 0);
+
+    GLFWmonitor * monitor = glfwGetWindowMonitor(window);
+
+    if (!monitor)
+        monitor = glfwGetPrimaryMonitor();
+
+    GLFWvidmode const * mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    if (mode)
+        scheduler.set_refresh_rate(mode->refreshRate);
+
+    scheduler.reset(glfwGetTime());
+    scheduler.request_redraw();
+
+    while (!glfwWindowShouldClose(window)) {
+        // Handlers of queued input events are called once per frame
+        wait_events(scheduler.wait_timeout(glfwGetTime()));
+
+        int ticks = scheduler.begin_frame(glfwGetTime());
+
+        for (int i = 0; i < ticks && scheduler.animating(); i++)
+            scheduler.set_animating(update(scheduler.tick_interval()));
+
+        if (!scheduler.need_render())
+            continue;
+
+        render(scheduler.alpha());
+        glfwSwapBuffers(window);
+
+        scheduler.end_frame(glfwGetTime());
+
+        // Without vertical synchronization wait for the end of the frame
+        // budget, but still wake up on input
+        double remaining = scheduler.pacing_delay(glfwGetTime(), vsync);
+
+        if (remaining > 0)
+            glfwWaitEventsTimeout(remaining);
+    }
+
+    return 0;
+}
+
+template <typename Update, typename Render>
+int context::run_windows (Update && update, Render && render, bool vsync)
+{
+    if (!_initialized || windows.empty())
+        return -1;
+
+    GLFWmonitor * monitor = glfwGetPrimaryMonitor();
+    GLFWvidmode const * mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    if (mode)
+        scheduler.set_refresh_rate(mode->refreshRate);
+
+    scheduler.reset(glfwGetTime());
+    request_redraw();
+
+    auto is_open = [] (std::pair<GLFWwindow *, std::unique_ptr<window_data>> const & w) {
+        return !glfwWindowShouldClose(w.first);
+    };
+
+    while (std::any_of(windows.begin(), windows.end(), is_open)) {
+        // Handlers of queued input events are called once per frame
+        wait_events(scheduler.wait_timeout(glfwGetTime()));
+
+        int ticks = scheduler.begin_frame(glfwGetTime());
+
+        for (int i = 0; i < ticks && scheduler.animating(); i++)
+            scheduler.set_animating(update(scheduler.tick_interval()));
+
+        if (!scheduler.need_render())
+            continue;
+
+        bool animating = scheduler.animating();
+        bool all = redraw_all.exchange(false, std::memory_order_acq_rel);
+
+        // Only the first open window waits for the vertical retrace, it
+        // changes when that window is closed
+        auto first_open = std::find_if(windows.begin(), windows.end(), is_open);
+        GLFWwindow * synced_window = first_open != windows.end() ? first_open->first : nullptr;
+        bool synced = false;
+
+        for (auto const & w: windows) {
+            bool dirty = w.second->dirty.exchange(false, std::memory_order_acq_rel);
+
+            if (glfwWindowShouldClose(w.first) || !(dirty || all || animating))
+                continue;
+
+            int swap_interval = vsync && w.first == synced_window ? 1 : 0;
+
+            glfwMakeContextCurrent(w.first);
+
+            if (w.second->swap_interval != swap_interval) {
+                glfwSwapInterval(swap_interval);
+                w.second->swap_interval = swap_interval;
+            }
+
+            render(w.first, scheduler.alpha());
+            glfwSwapBuffers(w.first);
+            synced = synced || swap_interval > 0;
+        }
+
+        scheduler.end_frame(glfwGetTime());
+
+        // Frames without synchronized swap wait for the end of the frame
+        // budget, but still wake up on input
+        double remaining = scheduler.pacing_delay(glfwGetTime(), synced);
+
+        if (remaining > 0)
+            glfwWaitEventsTimeout(remaining);
+    }
+
+    return 0;
+}
+
+template <typename Frame, typename Update, typename Build, typename Render>
+int context::run_threaded (GLFWwindow * window
+    , Update && update
+    , Build && build
+    , Render && render
+    , bool vsync)
+{
+    if (!_initialized || !window)
+        return -1;
+
+    window_data * d = register_window(window);
+
+    GLFWmonitor * monitor = glfwGetWindowMonitor(window);
+
+    if (!monitor)
+        monitor = glfwGetPrimaryMonitor();
+
+    GLFWvidmode const * mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    if (mode)
+        scheduler.set_refresh_rate(mode->refreshRate);
+
+    triple_buffer<Frame> frames;
+    std::mutex mtx;
+    std::condition_variable frame_ready;
+    bool stop = false;
+
+    // OpenGL context can be current on one thread only
+    glfwMakeContextCurrent(nullptr);
+    d->threaded.store(true, std::memory_order_release);
+
+    std::thread render_thread {[&] {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(vsync ? 1 : 0);
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                frame_ready.wait(lock, [&] { return stop || frames.has_fresh(); });
+
+                if (stop)
+                    break;
+            }
+
+            auto vp = d->pending_viewport.exchange(window_data::no_viewport
+                , std::memory_order_acq_rel);
+
+            if (vp != window_data::no_viewport) {
+                glViewport(0, 0, static_cast<int>(vp >> 32)
+                    , static_cast<int>(vp & 0xFFFFFFFF));
+            }
+
+            frames.fetch();
+            render(frames.front());
+            glfwSwapBuffers(window);
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }};
+
+    scheduler.reset(glfwGetTime());
+    scheduler.request_redraw();
+
+    while (!glfwWindowShouldClose(window)) {
+        wait_events(scheduler.wait_timeout(glfwGetTime()));
+
+        int ticks = scheduler.begin_frame(glfwGetTime());
+
+        for (int i = 0; i < ticks && scheduler.animating(); i++)
+            scheduler.set_animating(update(scheduler.tick_interval()));
+
+        if (!scheduler.need_render())
+            continue;
+
+        build(frames.back(), scheduler.alpha());
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            frames.publish();
+        }
+
+        frame_ready.notify_one();
+        scheduler.end_frame(glfwGetTime());
+
+        // Main thread is not throttled by the buffer swap, so pace frame
+        // building by the frame budget, but still wake up on input
+        double remaining = scheduler.pacing_delay(glfwGetTime(), false);
+
+        if (remaining > 0)
+            glfwWaitEventsTimeout(remaining);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+
+    frame_ready.notify_one();
+    render_thread.join();
+
+    d->threaded.store(false, std::memory_order_release);
+    glfwMakeContextCurrent(window);
+
+    return 0;
+}
 
 }} // namespace pfs::griotte
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.07 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class coverage_bitmap
+ * @brief Set of Unicode code points (e.g. code points having glyphs in
+ *        a font).
+ *
+ * Two-level bitmap: code points are grouped in pages of 256, empty pages
+ * share a single zero page, so testing takes constant time without
+ * branches and a typical font coverage takes ~10 KiB.
+ */
+class coverage_bitmap
+{
+public:
+    static constexpr char32_t max_code_point = 0x10FFFF;
+
+private:
+    static constexpr std::size_t page_size = 256;
+    static constexpr std::size_t pages_count = (max_code_point + 1) / page_size;
+
+    using page_type = std::array<std::uint64_t, page_size / 64>;
+
+    std::vector<std::uint16_t> _index; // page number in _pages, 0 is the zero page
+    std::vector<page_type> _pages;
+    std::size_t _count {0};
+
+public:
+    coverage_bitmap ()
+        : _index(pages_count, 0)
+        , _pages(1, page_type{})
+    {}
+
+    /**
+     * @return Number of code points in the set.
+     */
+    std::size_t count () const noexcept
+    {
+        return _count;
+    }
+
+    bool empty () const noexcept
+    {
+        return _count == 0;
+    }
+
+    void set (char32_t cp)
+    {
+        if (cp > max_code_point)
+            return;
+
+        std::uint16_t & page = _index[cp / page_size];
+
+        if (page == 0) {
+            page = static_cast<std::uint16_t>(_pages.size());
+            _pages.push_back(page_type{});
+        }
+
+        std::uint64_t & word = _pages[page][(cp % page_size) / 64];
+        std::uint64_t bit = std::uint64_t{1} << (cp % 64);
+
+        if (!(word & bit)) {
+            word |= bit;
+            ++_count;
+        }
+    }
+
+    bool test (char32_t cp) const noexcept
+    {
+        if (cp > max_code_point)
+            return false;
+
+        return (_pages[_index[cp / page_size]][(cp % page_size) / 64] >> (cp % 64)) & 1;
+    }
+};
+
+}} // namespace pfs::griotte
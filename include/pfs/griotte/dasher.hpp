@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.30 Initial version
+//      2021.07.13 Zero length dashes, dashes across the start of closed
+//                 polylines.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/mesh.hpp"
+#include "pfs/griotte/pen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Flattened subpath: range of points in a point buffer.
+ */
+struct contour
+{
+    std::size_t first;
+    std::size_t count;
+    bool        closed;
+
+    // Unit direction of a zero length dash (two equal points), so its caps
+    // can be oriented, zero for other contours
+    mesh_vertex dir;
+};
+
+/**
+ * @class dasher
+ * @brief Splits flattened polylines into dashes according to the pen dash
+ *        array and dash offset.
+ *
+ * The dash pattern is converted into a table of cumulative interval ends,
+ * so the interval for any phase is found by binary search. For every
+ * polyline a table of cumulative vertex distances is built, so the start of
+ * every dash is found by binary search too, and gaps are skipped without
+ * visiting the vertices they cover.
+ *
+ * Zero length dashes (e.g. dash array {0, N} drawing dots with round or
+ * square caps) are emitted as two equal points with the direction of the
+ * polyline at that point. On a closed polyline a dash running across the
+ * start vertex is emitted as one contour, so it gets a join there instead
+ * of two caps.
+ *
+ * Phase state is kept between calls of dash(): by default every subpath
+ * starts at the pen dash offset (as in SVG), in continuous mode the pattern
+ * flows from one subpath into the next.
+ */
+template <typename UnitT>
+class dasher
+{
+public:
+    using unit_type = UnitT;
+
+    // Polylines requiring more dashes are not dashed (emitted as is)
+    static constexpr float max_dash_count = 1000000.0f;
+
+private:
+    std::vector<float> _bounds;  // cumulative ends of the pattern intervals
+    std::vector<float> _lengths; // cumulative distances of polyline vertices
+    float _period {0};
+    float _offset {0};
+    bool _continuous {false};
+
+    // Phase state
+    std::size_t _index {0};  // current interval, even intervals are dashes
+    float _consumed {0};     // consumed length of the current interval
+
+private:
+    mesh_vertex interpolate (mesh_vertex const * points
+        , std::size_t n
+        , std::size_t seg
+        , float d) const
+    {
+        mesh_vertex const & a = points[seg % n];
+        mesh_vertex const & b = points[(seg + 1) % n];
+        float len = _lengths[seg + 1] - _lengths[seg];
+        float t = len > 0 ? (d - _lengths[seg]) / len : 0;
+        return mesh_vertex{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+    }
+
+    mesh_vertex direction (mesh_vertex const * points
+        , std::size_t n
+        , std::size_t seg) const
+    {
+        mesh_vertex const & a = points[seg % n];
+        mesh_vertex const & b = points[(seg + 1) % n];
+        float len = _lengths[seg + 1] - _lengths[seg];
+        return len > 0
+            ? mesh_vertex{(b.x - a.x) / len, (b.y - a.y) / len}
+            : mesh_vertex{1, 0};
+    }
+
+    /**
+     * @brief Joins the first dash @a head of a closed polyline to the last
+     *        one (both touch the start vertex).
+     */
+    static void join_dashes (std::vector<mesh_vertex> & out_points
+        , std::vector<contour> & out_contours
+        , std::size_t head);
+
+    static void add_point (std::vector<mesh_vertex> & out_points
+        , contour & c
+        , mesh_vertex const & v)
+    {
+        if (c.count > 0) {
+            mesh_vertex const & last = out_points.back();
+
+            if (last.x == v.x && last.y == v.y)
+                return;
+        }
+
+        out_points.push_back(v);
+        ++c.count;
+    }
+
+public:
+    dasher () = default;
+
+    /**
+     * @brief Sets dash pattern and offset of @a apen and restarts the
+     *        phase.
+     * @return @c false if @a apen has no valid dash array (solid line).
+     */
+    bool set_pattern (pen<unit_type> const & apen);
+
+    /**
+     * @brief Resets the phase to the dash offset.
+     */
+    void restart () noexcept;
+
+    bool is_continuous () const noexcept
+    {
+        return _continuous;
+    }
+
+    /**
+     * @brief Sets whether the dash phase continues across subpaths.
+     */
+    void set_continuous (bool enable) noexcept
+    {
+        _continuous = enable;
+    }
+
+    float get_period () const noexcept
+    {
+        return _period;
+    }
+
+    /**
+     * @brief Appends dashes of polyline @a points (@a count points, closed
+     *        if @a closed) to @a out_points as open contours @a out_contours.
+     */
+    void dash (mesh_vertex const * points
+        , std::size_t count
+        , bool closed
+        , std::vector<mesh_vertex> & out_points
+        , std::vector<contour> & out_contours);
+};
+
+template <typename UnitT>
+constexpr float dasher<UnitT>::max_dash_count;
+
+template <typename UnitT>
+bool dasher<UnitT>::set_pattern (pen<unit_type> const & apen)
+{
+    auto dashes = apen.get_dasharray();
+
+    _bounds.clear();
+    _period = 0;
+
+    if (dashes.empty())
+        return false;
+
+    // Odd number of values is repeated to yield an even number of values
+    std::size_t n = dashes.size() % 2 ? dashes.size() * 2 : dashes.size();
+
+    for (std::size_t i = 0; i < n; i++) {
+        float d = static_cast<float>(dashes[i % dashes.size()]);
+
+        if (d < 0) {
+            _bounds.clear();
+            return false;
+        }
+
+        _period += d;
+        _bounds.push_back(_period);
+    }
+
+    if (!(_period > 0)) {
+        _bounds.clear();
+        _period = 0;
+        return false;
+    }
+
+    _offset = static_cast<float>(apen.get_dash_offset());
+    restart();
+
+    return true;
+}
+
+template <typename UnitT>
+void dasher<UnitT>::restart () noexcept
+{
+    if (_bounds.empty())
+        return;
+
+    float phase = std::fmod(_offset, _period);
+
+    if (phase < 0)
+        phase += _period;
+
+    // Interval containing the phase, a zero length interval at the phase
+    // is not skipped (dot at the start)
+    _index = static_cast<std::size_t>(
+        std::lower_bound(_bounds.begin(), _bounds.end(), phase) - _bounds.begin());
+
+    if (_index == _bounds.size())
+        _index = 0, phase = 0;
+
+    _consumed = phase - (_index > 0 ? _bounds[_index - 1] : 0.0f);
+}
+
+template <typename UnitT>
+void dasher<UnitT>::dash (mesh_vertex const * points
+    , std::size_t count
+    , bool closed
+    , std::vector<mesh_vertex> & out_points
+    , std::vector<contour> & out_contours)
+{
+    if (count < 2)
+        return;
+
+    if (!_continuous)
+        restart();
+
+    // Number of segments, closing segment returns to the first point
+    std::size_t nsegments = closed ? count : count - 1;
+
+    _lengths.resize(nsegments + 1);
+    _lengths[0] = 0;
+
+    for (std::size_t i = 0; i < nsegments; i++) {
+        mesh_vertex const & a = points[i];
+        mesh_vertex const & b = points[(i + 1) % count];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        _lengths[i + 1] = _lengths[i] + std::sqrt(dx * dx + dy * dy);
+    }
+
+    float total = _lengths[nsegments];
+
+    if (_bounds.empty() || total / _period > max_dash_count) {
+        out_contours.push_back(contour{out_points.size(), 0, closed, mesh_vertex{0, 0}});
+
+        for (std::size_t i = 0; i < count; i++)
+            add_point(out_points, out_contours.back(), points[i]);
+
+        return;
+    }
+
+    auto first_length = _lengths.begin();
+    auto last_length = _lengths.end();
+    std::size_t seg = 0;
+    std::size_t head = out_contours.size();
+    bool head_on = false; // the first dash starts at the start vertex
+    bool tail_on = false; // the last dash ends at the start vertex
+    float s = 0;
+
+    while (s < total) {
+        float interval = _bounds[_index] - (_index > 0 ? _bounds[_index - 1] : 0.0f);
+        float e = s + (interval - _consumed);
+        bool finished = e <= total;
+
+        if (!finished)
+            e = total;
+
+        if (_index % 2 == 0 && (e > s || interval == 0)) {
+            // Segment containing the dash start
+            auto it = std::upper_bound(first_length + seg, last_length, s);
+            seg = static_cast<std::size_t>(it - first_length);
+            seg = seg > 0 ? seg - 1 : 0;
+            seg = (std::min)(seg, nsegments - 1);
+
+            out_contours.push_back(contour{out_points.size(), 0, false, mesh_vertex{0, 0}});
+            contour & c = out_contours.back();
+
+            add_point(out_points, c, interpolate(points, count, seg, s));
+
+            while (seg + 1 < nsegments && _lengths[seg + 1] < e) {
+                ++seg;
+                add_point(out_points, c, points[seg % count]);
+            }
+
+            add_point(out_points, c, interpolate(points, count, seg, e));
+
+            // Zero length dash is a dot: its caps are drawn along the
+            // polyline
+            if (c.count < 2) {
+                out_points.push_back(out_points.back());
+                c.count = 2;
+                c.dir = direction(points, count, seg);
+            }
+
+            if (s == 0)
+                head_on = true;
+
+            tail_on = e == total;
+        } else {
+            tail_on = false;
+        }
+
+        if (finished) {
+            _index = (_index + 1) % _bounds.size();
+            _consumed = 0;
+        } else {
+            _consumed += e - s;
+        }
+
+        s = e;
+    }
+
+    if (closed && head_on && tail_on)
+        join_dashes(out_points, out_contours, head);
+}
+
+template <typename UnitT>
+void dasher<UnitT>::join_dashes (std::vector<mesh_vertex> & out_points
+    , std::vector<contour> & out_contours
+    , std::size_t head)
+{
+    contour & last = out_contours.back();
+
+    // The only dash covers the whole polyline
+    if (out_contours.size() == head + 1) {
+        mesh_vertex const & a = out_points[last.first];
+        mesh_vertex const & b = out_points.back();
+
+        if (last.count > 2 && a.x == b.x && a.y == b.y) {
+            out_points.pop_back();
+            --last.count;
+            last.closed = true;
+        }
+
+        return;
+    }
+
+    // Head points are appended to the last dash (the start vertex is
+    // shared), then removed with the head contour
+    contour h = out_contours[head];
+
+    for (std::size_t i = 0; i < h.count; i++)
+        add_point(out_points, last, out_points[h.first + i]);
+
+    last.dir = mesh_vertex{0, 0};
+
+    auto first = out_points.begin() + static_cast<std::ptrdiff_t>(h.first);
+    out_points.erase(first, first + static_cast<std::ptrdiff_t>(h.count));
+    out_contours.erase(out_contours.begin() + static_cast<std::ptrdiff_t>(head));
+
+    for (std::size_t i = head; i < out_contours.size(); i++)
+        out_contours[i].first -= h.count;
+}
+
+}} // namespace pfs::griotte
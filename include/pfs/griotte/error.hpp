@@ -9,6 +9,9 @@ enum class errc
 {
       success = 0
     , bad_path
+    , freetype_error
+    , atlas_full
+    , bad_variation
 };
 
 class error_category : public std::error_category
@@ -64,6 +67,9 @@ std::string error_category::message (int ev) const
     switch (static_cast<griotte::errc>(ev)) {
     case griotte::errc::success: return std::string("no error");
     case griotte::errc::bad_path: return std::string("bad path");
+    case griotte::errc::freetype_error: return std::string("FreeType error");
+    case griotte::errc::atlas_full: return std::string("glyph atlas is full");
+    case griotte::errc::bad_variation: return std::string("bad font variation");
     default: return std::string("unknown pfs::griotte error");
     }
 }
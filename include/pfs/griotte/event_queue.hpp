@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.24 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace pfs {
+namespace griotte {
+
+enum class event_type : std::uint8_t
+{
+      key
+    , character
+    , mouse_button
+    , cursor_pos
+    , scroll
+    , framebuffer_size
+    , window_close
+};
+
+struct key_event
+{
+    int key;
+    int scancode;
+    int action;
+    int mods;
+};
+
+struct character_event
+{
+    unsigned int codepoint;
+};
+
+struct mouse_button_event
+{
+    int button;
+    int action;
+    int mods;
+};
+
+struct cursor_pos_event
+{
+    double x;
+    double y;
+};
+
+struct scroll_event
+{
+    double dx;
+    double dy;
+};
+
+struct framebuffer_size_event
+{
+    int width;
+    int height;
+};
+
+/**
+ * @brief Compact POD input event.
+ */
+struct event
+{
+    event_type   type;
+    GLFWwindow * window;
+
+    union {
+        key_event              key;
+        character_event        character;
+        mouse_button_event     mouse_button;
+        cursor_pos_event       cursor_pos;
+        scroll_event           scroll;
+        framebuffer_size_event framebuffer_size;
+    };
+};
+
+/**
+ * @class event_queue
+ * @brief Ring buffer of input events with coalescing of bursts.
+ *
+ * Consecutive cursor moves of the same window are replaced by the latest one,
+ * consecutive scroll offsets are accumulated. Framebuffer size event replaces
+ * any pending framebuffer size event of the same window, so a window resize
+ * causes one relayout per frame.
+ *
+ * @note Not thread-safe, GLFW callbacks are called from the main thread only.
+ */
+class event_queue
+{
+    std::vector<event> _events;
+    std::size_t _head {0};  // index of the first event
+    std::size_t _size {0};
+    std::size_t _coalesced {0};
+
+private:
+    event & at (std::size_t i)
+    {
+        return _events[(_head + i) & (_events.size() - 1)];
+    }
+
+    void grow ()
+    {
+        std::vector<event> events(_events.size() * 2);
+
+        for (std::size_t i = 0; i < _size; i++)
+            events[i] = at(i);
+
+        _events.swap(events);
+        _head = 0;
+    }
+
+    bool coalesce (event const & ev)
+    {
+        if (ev.type == event_type::framebuffer_size) {
+            for (std::size_t i = 0; i < _size; i++) {
+                event & e = at(i);
+
+                if (e.type == event_type::framebuffer_size && e.window == ev.window) {
+                    e.framebuffer_size = ev.framebuffer_size;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        if (_size == 0)
+            return false;
+
+        // Only adjacent events are coalesced to keep ordering with buttons
+        // and keys
+        event & last = at(_size - 1);
+
+        if (last.type != ev.type || last.window != ev.window)
+            return false;
+
+        switch (ev.type) {
+            case event_type::cursor_pos:
+                last.cursor_pos = ev.cursor_pos;
+                return true;
+
+            case event_type::scroll:
+                last.scroll.dx += ev.scroll.dx;
+                last.scroll.dy += ev.scroll.dy;
+                return true;
+
+            default:
+                break;
+        }
+
+        return false;
+    }
+
+public:
+    /**
+     * @brief Constructs event queue with initial @a capacity (rounded up to
+     *        a power of two).
+     */
+    event_queue (std::size_t capacity = 256)
+    {
+        std::size_t n = 1;
+
+        while (n < capacity)
+            n <<= 1;
+
+        _events.resize(n);
+    }
+
+    /**
+     * @brief Appends event @a ev to the queue or coalesces it with the pending
+     *        one.
+     */
+    void push (event const & ev)
+    {
+        if (coalesce(ev)) {
+            ++_coalesced;
+            return;
+        }
+
+        if (_size == _events.size())
+            grow();
+
+        at(_size) = ev;
+        ++_size;
+    }
+
+    /**
+     * @brief Removes the first event from the queue and stores it in @a ev.
+     * @return @c false if queue is empty.
+     */
+    bool pop (event & ev)
+    {
+        if (_size == 0)
+            return false;
+
+        ev = at(0);
+        _head = (_head + 1) & (_events.size() - 1);
+        --_size;
+        return true;
+    }
+
+    /**
+     * @brief Calls @a f for every queued event in order and empties the queue.
+     * @return Number of processed events.
+     *
+     * Events pushed by @a f are processed on the next call.
+     */
+    template <typename F>
+    std::size_t drain (F && f)
+    {
+        std::size_t n = _size;
+        event ev;
+
+        for (std::size_t i = 0; i < n && pop(ev); i++)
+            f(ev);
+
+        return n;
+    }
+
+    void clear () noexcept
+    {
+        _head = 0;
+        _size = 0;
+    }
+
+    bool empty () const noexcept
+    {
+        return _size == 0;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _size;
+    }
+
+    std::size_t capacity () const noexcept
+    {
+        return _events.size();
+    }
+
+    /**
+     * @return Total number of events merged into the pending ones.
+     */
+    std::size_t coalesced () const noexcept
+    {
+        return _coalesced;
+    }
+};
+
+}} // namespace pfs::griotte
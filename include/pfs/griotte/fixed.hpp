@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.03 Initial version
+//      2021.07.13 std::hash specialization.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class fixed_point
+ * @brief Signed fixed-point number with @a FracBits fractional bits stored
+ *        in @a Rep.
+ *
+ * Unit type for geometry templates (point, rect, path, ...) giving
+ * deterministic subpixel arithmetic without floating point. Products and
+ * quotients are computed in 64 bits and rounded to the nearest
+ * representable value.
+ *
+ * Conversion from integers is implicit (exact), from floating point is
+ * explicit, conversion to arithmetic types is explicit.
+ */
+template <int FracBits, typename Rep = std::int32_t>
+class fixed_point
+{
+    static_assert(std::is_integral<Rep>::value && std::is_signed<Rep>::value
+        , "fixed_point representation must be a signed integer");
+    static_assert(sizeof(Rep) <= 4, "fixed_point representation must be at most 32 bits");
+    static_assert(FracBits > 0 && FracBits < 8 * static_cast<int>(sizeof(Rep)) - 1
+        , "bad number of fractional bits");
+
+public:
+    using rep_type = Rep;
+
+    static constexpr int frac_bits = FracBits;
+    static constexpr rep_type one = rep_type{1} << FracBits;
+
+private:
+    using wide_type = std::int64_t;
+
+    rep_type _v;
+
+private:
+    struct raw_tag {};
+
+    constexpr fixed_point (rep_type v, raw_tag) noexcept
+        : _v(v)
+    {}
+
+    // Division of wide value rounded to the nearest (half away from zero)
+    static constexpr wide_type rounded_div (wide_type a, wide_type b) noexcept
+    {
+        return ((a < 0) != (b < 0))
+            ? (a - b / 2) / b
+            : (a + b / 2) / b;
+    }
+
+public:
+    constexpr fixed_point () noexcept
+        : _v(0)
+    {}
+
+    constexpr fixed_point (int v) noexcept
+        : _v(static_cast<rep_type>(static_cast<wide_type>(v) * one))
+    {}
+
+    explicit fixed_point (double v) noexcept
+        : _v(static_cast<rep_type>(std::lround(v * one)))
+    {}
+
+    explicit fixed_point (float v) noexcept
+        : _v(static_cast<rep_type>(std::lround(static_cast<double>(v) * one)))
+    {}
+
+    /**
+     * @brief Constructs number from raw representation @a v (e.g. FreeType
+     *        26.6 value for fixed26_6).
+     */
+    static constexpr fixed_point from_raw (rep_type v) noexcept
+    {
+        return fixed_point{v, raw_tag{}};
+    }
+
+    constexpr rep_type raw () const noexcept
+    {
+        return _v;
+    }
+
+    /**
+     * @return Largest integer not greater than this number.
+     */
+    constexpr int floor () const noexcept
+    {
+        return static_cast<int>(_v >= 0 ? _v / one : -((-static_cast<wide_type>(_v) + one - 1) / one));
+    }
+
+    /**
+     * @return Smallest integer not less than this number.
+     */
+    constexpr int ceil () const noexcept
+    {
+        return -fixed_point::from_raw(-_v).floor();
+    }
+
+    /**
+     * @return Nearest integer (half away from zero).
+     */
+    constexpr int round () const noexcept
+    {
+        return static_cast<int>(rounded_div(_v, one));
+    }
+
+    explicit constexpr operator int () const noexcept
+    {
+        return static_cast<int>(_v / one); // toward zero as for floating point
+    }
+
+    explicit constexpr operator float () const noexcept
+    {
+        return static_cast<float>(_v) / one;
+    }
+
+    explicit constexpr operator double () const noexcept
+    {
+        return static_cast<double>(_v) / one;
+    }
+
+    constexpr fixed_point operator - () const noexcept
+    {
+        return from_raw(static_cast<rep_type>(-_v));
+    }
+
+    constexpr fixed_point operator + () const noexcept
+    {
+        return *this;
+    }
+
+    fixed_point & operator += (fixed_point const & rhs) noexcept
+    {
+        _v += rhs._v;
+        return *this;
+    }
+
+    fixed_point & operator -= (fixed_point const & rhs) noexcept
+    {
+        _v -= rhs._v;
+        return *this;
+    }
+
+    fixed_point & operator *= (fixed_point const & rhs) noexcept
+    {
+        _v = static_cast<rep_type>(rounded_div(static_cast<wide_type>(_v) * rhs._v, one));
+        return *this;
+    }
+
+    fixed_point & operator /= (fixed_point const & rhs) noexcept
+    {
+        _v = static_cast<rep_type>(rounded_div(static_cast<wide_type>(_v) * one, rhs._v));
+        return *this;
+    }
+
+    fixed_point & operator *= (int rhs) noexcept
+    {
+        _v = static_cast<rep_type>(_v * rhs);
+        return *this;
+    }
+
+    fixed_point & operator /= (int rhs) noexcept
+    {
+        _v = static_cast<rep_type>(rounded_div(_v, rhs));
+        return *this;
+    }
+
+    fixed_point & operator *= (double rhs) noexcept
+    {
+        _v = static_cast<rep_type>(std::lround(_v * rhs));
+        return *this;
+    }
+
+    friend constexpr fixed_point operator + (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(a._v + b._v));
+    }
+
+    friend constexpr fixed_point operator - (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(a._v - b._v));
+    }
+
+    friend constexpr fixed_point operator * (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(rounded_div(static_cast<wide_type>(a._v) * b._v, one)));
+    }
+
+    friend constexpr fixed_point operator / (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(rounded_div(static_cast<wide_type>(a._v) * one, b._v)));
+    }
+
+    friend constexpr fixed_point operator * (fixed_point const & a, int b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(a._v * b));
+    }
+
+    friend constexpr fixed_point operator * (int a, fixed_point const & b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(a * b._v));
+    }
+
+    friend constexpr fixed_point operator / (fixed_point const & a, int b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(rounded_div(a._v, b)));
+    }
+
+    friend fixed_point operator * (fixed_point const & a, double b) noexcept
+    {
+        return from_raw(static_cast<rep_type>(std::lround(a._v * b)));
+    }
+
+    friend fixed_point operator * (fixed_point const & a, float b) noexcept
+    {
+        return a * static_cast<double>(b);
+    }
+
+    friend constexpr bool operator == (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v == b._v;
+    }
+
+    friend constexpr bool operator != (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v != b._v;
+    }
+
+    friend constexpr bool operator < (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v < b._v;
+    }
+
+    friend constexpr bool operator <= (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v <= b._v;
+    }
+
+    friend constexpr bool operator > (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v > b._v;
+    }
+
+    friend constexpr bool operator >= (fixed_point const & a, fixed_point const & b) noexcept
+    {
+        return a._v >= b._v;
+    }
+};
+
+template <int FracBits, typename Rep>
+constexpr int fixed_point<FracBits, Rep>::frac_bits;
+
+template <int FracBits, typename Rep>
+constexpr typename fixed_point<FracBits, Rep>::rep_type fixed_point<FracBits, Rep>::one;
+
+/**
+ * @brief FreeType 26.6 format (e.g. glyph advances and outline coordinates).
+ */
+using fixed26_6 = fixed_point<6>;
+
+/**
+ * @brief FreeType 16.16 format (e.g. FT_Fixed, transformation matrices).
+ */
+using fixed16_16 = fixed_point<16>;
+
+}} // namespace pfs::griotte
+
+namespace std {
+
+template <int FracBits, typename Rep>
+struct hash<pfs::griotte::fixed_point<FracBits, Rep>>
+{
+    std::size_t operator () (pfs::griotte::fixed_point<FracBits, Rep> const & v) const noexcept
+    {
+        return std::hash<Rep>{}(v.raw());
+    }
+};
+
+} // namespace std
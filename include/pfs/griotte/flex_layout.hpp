@@ -0,0 +1,748 @@
+#pragma once
+#include <pfs/griotte/constants.hpp>
+#include <pfs/griotte/indents.hpp>
+#include <pfs/griotte/layout.hpp>
+#include <pfs/griotte/rect.hpp>
+#include <pfs/griotte/size.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+//
+// Flex layout (a subset of CSS Flexible Box Layout) with grow/shrink/wrap
+// semantics.
+//
+// See [Layout](https://github.com/randrew/layout)
+// See [CSS Flexible Box Layout Module Level 1](https://www.w3.org/TR/css-flexbox-1/#layout-algorithm)
+//
+// Solver stores items as structure of arrays. Items of a container are
+// gathered into contiguous scratch arrays and resolved by loops without
+// data-dependent branches, then results are scattered back.
+//
+
+namespace pfs {
+namespace griotte {
+
+template <typename UnitT>
+class flex_solver
+{
+public:
+    using unit_type     = UnitT;
+    using size_type     = size<unit_type>;
+    using rect_type     = rect<unit_type>;
+    using margins_type  = margins<unit_type>;
+    using paddings_type = paddings<unit_type>;
+    using id_type       = int;
+
+    static constexpr id_type null_id = -1;
+
+    /**
+     * @brief Value of basis for items which basis is their content size.
+     */
+    static constexpr float auto_basis = -1.0f;
+
+private:
+    enum flag_enum : std::uint8_t
+    {
+          container_flag = 0x01
+        , column_flag    = 0x02
+        , wrap_flag      = 0x04
+    };
+
+    // Topology
+    std::vector<id_type> _parent;
+    std::vector<id_type> _first_child;
+    std::vector<id_type> _last_child;
+    std::vector<id_type> _next_sibling;
+    std::vector<std::uint8_t> _flags;
+
+    // Item inputs (main axis is the parent container's direction)
+    std::vector<float> _basis;
+    std::vector<float> _grow;
+    std::vector<float> _shrink;
+    std::vector<float> _min;
+    std::vector<float> _max;
+    std::vector<float> _hint_w;
+    std::vector<float> _hint_h;
+    std::vector<indents<float>> _margins;
+
+    // Container inputs
+    std::vector<float> _gap;
+    std::vector<indents<float>> _paddings;
+
+    // Content size calculated by measure pass
+    std::vector<float> _content_w;
+    std::vector<float> _content_h;
+
+    // Outputs
+    std::vector<unit_type> _x;
+    std::vector<unit_type> _y;
+    std::vector<unit_type> _w;
+    std::vector<unit_type> _h;
+
+    // Scratch arrays for items of the container being solved
+    std::vector<id_type> _s_id;
+    std::vector<float> _s_base;
+    std::vector<float> _s_factor;
+    std::vector<float> _s_min;
+    std::vector<float> _s_max;
+    std::vector<float> _s_margin;
+    std::vector<float> _s_size;
+    std::vector<float> _s_frozen;
+    std::vector<float> _s_violation;
+
+public:
+    flex_solver () = default;
+
+    std::size_t count () const noexcept
+    {
+        return _parent.size();
+    }
+
+    void reserve (std::size_t n);
+
+    /**
+     * @brief Removes all items.
+     */
+    void clear ();
+
+    /**
+     * @brief Adds container laying out its items along @a dir orientation.
+     * @param parent Parent container or @c null_id for the root container.
+     * @param wrap Whether items are wrapped onto multiple lines.
+     * @return Container identifier.
+     */
+    id_type add_container (id_type parent, orientation dir, bool wrap = false)
+    {
+        id_type id = add_node(parent);
+        _flags[id] = container_flag
+            | (dir == orientation::vertical ? column_flag : 0)
+            | (wrap ? wrap_flag : 0);
+        return id;
+    }
+
+    /**
+     * @brief Adds leaf item to the container @a parent.
+     * @return Item identifier.
+     */
+    id_type add_item (id_type parent)
+    {
+        assert(parent != null_id);
+        return add_node(parent);
+    }
+
+    /**
+     * @brief Sets initial main size of the item (@c auto_basis by default).
+     */
+    void set_basis (id_type id, float basis)
+    {
+        _basis[id] = basis;
+    }
+
+    /**
+     * @brief Sets how much the item grows relative to its siblings
+     *        (@c 0 by default).
+     */
+    void set_grow (id_type id, float grow)
+    {
+        _grow[id] = grow;
+    }
+
+    /**
+     * @brief Sets how much the item shrinks relative to its siblings
+     *        (@c 1 by default).
+     */
+    void set_shrink (id_type id, float shrink)
+    {
+        _shrink[id] = shrink;
+    }
+
+    /**
+     * @brief Sets main size constraints of the item.
+     */
+    void set_min_max (id_type id, float min, float max)
+    {
+        _min[id] = min;
+        _max[id] = max;
+    }
+
+    /**
+     * @brief Sets content size of the leaf item or fixed content size
+     *        of the container (zero means calculated).
+     */
+    void set_size_hint (id_type id, size_type const & s)
+    {
+        _hint_w[id] = static_cast<float>(s.get_width());
+        _hint_h[id] = static_cast<float>(s.get_height());
+    }
+
+    void set_margins (id_type id, margins_type const & m)
+    {
+        _margins[id] = to_float(m);
+    }
+
+    void set_paddings (id_type id, paddings_type const & p)
+    {
+        _paddings[id] = to_float(p);
+    }
+
+    /**
+     * @brief Sets spacing between items and lines of the container.
+     */
+    void set_gap (id_type id, unit_type gap)
+    {
+        _gap[id] = static_cast<float>(gap);
+    }
+
+    /**
+     * @return Content size of the item calculated by the last measure pass.
+     */
+    size_type get_content_size (id_type id) const
+    {
+        return size_type{to_unit(_content_w[id]), to_unit(_content_h[id])};
+    }
+
+    /**
+     * @return Geometry of the item calculated by the last solve.
+     */
+    rect_type get_rect (id_type id) const
+    {
+        return rect_type{_x[id], _y[id], _w[id], _h[id]};
+    }
+
+    /**
+     * @brief Calculates content sizes bottom-up.
+     */
+    void measure ();
+
+    /**
+     * @brief Calculates geometry of all items if root container
+     *        geometry is @a r.
+     */
+    void solve (rect_type const & r)
+    {
+        if (_parent.empty())
+            return;
+
+        measure();
+        arrange(r);
+    }
+
+    /**
+     * @brief Calculates geometry of all items if root container
+     *        geometry is @a r, using content sizes of the last measure pass.
+     */
+    void arrange (rect_type const & r);
+
+private:
+    id_type add_node (id_type parent);
+    void solve_container (id_type c);
+    void resolve_line (std::size_t first, std::size_t last, float avail);
+
+    bool is_container (id_type id) const noexcept
+    {
+        return _flags[id] & container_flag;
+    }
+
+    bool is_column (id_type id) const noexcept
+    {
+        return _flags[id] & column_flag;
+    }
+
+    static indents<float> to_float (indents<unit_type> const & x)
+    {
+        return indents<float>{static_cast<float>(x.get_top())
+            , static_cast<float>(x.get_right())
+            , static_cast<float>(x.get_bottom())
+            , static_cast<float>(x.get_left())};
+    }
+
+    template <typename U = unit_type>
+    static typename std::enable_if<std::is_integral<U>::value, U>::type
+    to_unit (float x)
+    {
+        return static_cast<U>(std::lround(x));
+    }
+
+    template <typename U = unit_type>
+    static typename std::enable_if<!std::is_integral<U>::value, U>::type
+    to_unit (float x)
+    {
+        return static_cast<U>(x);
+    }
+};
+
+template <typename UnitT>
+constexpr typename flex_solver<UnitT>::id_type flex_solver<UnitT>::null_id;
+
+template <typename UnitT>
+constexpr float flex_solver<UnitT>::auto_basis;
+
+template <typename UnitT>
+void flex_solver<UnitT>::reserve (std::size_t n)
+{
+    _parent.reserve(n);
+    _first_child.reserve(n);
+    _last_child.reserve(n);
+    _next_sibling.reserve(n);
+    _flags.reserve(n);
+    _basis.reserve(n);
+    _grow.reserve(n);
+    _shrink.reserve(n);
+    _min.reserve(n);
+    _max.reserve(n);
+    _hint_w.reserve(n);
+    _hint_h.reserve(n);
+    _margins.reserve(n);
+    _gap.reserve(n);
+    _paddings.reserve(n);
+    _content_w.reserve(n);
+    _content_h.reserve(n);
+    _x.reserve(n);
+    _y.reserve(n);
+    _w.reserve(n);
+    _h.reserve(n);
+}
+
+template <typename UnitT>
+void flex_solver<UnitT>::clear ()
+{
+    _parent.clear();
+    _first_child.clear();
+    _last_child.clear();
+    _next_sibling.clear();
+    _flags.clear();
+    _basis.clear();
+    _grow.clear();
+    _shrink.clear();
+    _min.clear();
+    _max.clear();
+    _hint_w.clear();
+    _hint_h.clear();
+    _margins.clear();
+    _gap.clear();
+    _paddings.clear();
+    _content_w.clear();
+    _content_h.clear();
+    _x.clear();
+    _y.clear();
+    _w.clear();
+    _h.clear();
+}
+
+template <typename UnitT>
+typename flex_solver<UnitT>::id_type
+flex_solver<UnitT>::add_node (id_type parent)
+{
+    assert(parent == null_id || (parent < static_cast<id_type>(count()) && is_container(parent)));
+    assert(parent != null_id || _parent.empty()); // the only root container
+
+    id_type id = static_cast<id_type>(_parent.size());
+
+    _parent.push_back(parent);
+    _first_child.push_back(null_id);
+    _last_child.push_back(null_id);
+    _next_sibling.push_back(null_id);
+    _flags.push_back(0);
+    _basis.push_back(auto_basis);
+    _grow.push_back(0.0f);
+    _shrink.push_back(1.0f);
+    _min.push_back(0.0f);
+    _max.push_back((std::numeric_limits<float>::max)());
+    _hint_w.push_back(0.0f);
+    _hint_h.push_back(0.0f);
+    _margins.emplace_back();
+    _gap.push_back(0.0f);
+    _paddings.emplace_back();
+    _content_w.push_back(0.0f);
+    _content_h.push_back(0.0f);
+    _x.push_back(0);
+    _y.push_back(0);
+    _w.push_back(0);
+    _h.push_back(0);
+
+    if (parent != null_id) {
+        if (_last_child[parent] == null_id)
+            _first_child[parent] = id;
+        else
+            _next_sibling[_last_child[parent]] = id;
+
+        _last_child[parent] = id;
+    }
+
+    return id;
+}
+
+template <typename UnitT>
+void flex_solver<UnitT>::measure ()
+{
+    // Children always follow their parents, so reverse order is bottom-up
+    for (id_type i = static_cast<id_type>(count()) - 1; i >= 0; i--) {
+        if (!is_container(i)) {
+            _content_w[i] = _hint_w[i];
+            _content_h[i] = _hint_h[i];
+            continue;
+        }
+
+        bool column = is_column(i);
+        float main = 0;
+        float cross = 0;
+        int n = 0;
+
+        for (id_type k = _first_child[i]; k != null_id; k = _next_sibling[k], n++) {
+            auto const & m = _margins[k];
+            float content_main = column ? _content_h[k] : _content_w[k];
+            float content_cross = column ? _content_w[k] : _content_h[k];
+            float base = _basis[k] < 0 ? content_main : _basis[k];
+
+            base = (std::min)((std::max)(base, _min[k]), _max[k]);
+
+            main += base + (column
+                ? m.get_top() + m.get_bottom()
+                : m.get_left() + m.get_right());
+
+            cross = (std::max)(cross, content_cross + (column
+                ? m.get_left() + m.get_right()
+                : m.get_top() + m.get_bottom()));
+        }
+
+        if (n > 1)
+            main += _gap[i] * (n - 1);
+
+        auto const & p = _paddings[i];
+        float w = (column ? cross : main) + p.get_left() + p.get_right();
+        float h = (column ? main : cross) + p.get_top() + p.get_bottom();
+
+        _content_w[i] = _hint_w[i] > 0 ? _hint_w[i] : w;
+        _content_h[i] = _hint_h[i] > 0 ? _hint_h[i] : h;
+    }
+}
+
+template <typename UnitT>
+void flex_solver<UnitT>::arrange (rect_type const & r)
+{
+    if (_parent.empty())
+        return;
+
+    _x[0] = r.get_x();
+    _y[0] = r.get_y();
+    _w[0] = r.get_width();
+    _h[0] = r.get_height();
+
+    // Parents always precede their children, so direct order is top-down
+    for (id_type i = 0, n = static_cast<id_type>(count()); i < n; i++) {
+        if (is_container(i) && _first_child[i] != null_id)
+            solve_container(i);
+    }
+}
+
+template <typename UnitT>
+void flex_solver<UnitT>::solve_container (id_type c)
+{
+    bool column = is_column(c);
+    bool wrap = _flags[c] & wrap_flag;
+    auto const & p = _paddings[c];
+    float gap = _gap[c];
+
+    float origin_main  = static_cast<float>(column ? _y[c] : _x[c]) + (column ? p.get_top() : p.get_left());
+    float origin_cross = static_cast<float>(column ? _x[c] : _y[c]) + (column ? p.get_left() : p.get_top());
+    float avail_main   = static_cast<float>(column ? _h[c] : _w[c])
+        - (column ? p.get_top() + p.get_bottom() : p.get_left() + p.get_right());
+    float avail_cross  = static_cast<float>(column ? _w[c] : _h[c])
+        - (column ? p.get_left() + p.get_right() : p.get_top() + p.get_bottom());
+
+    // Gather items into contiguous scratch arrays
+    _s_id.clear();
+
+    for (id_type k = _first_child[c]; k != null_id; k = _next_sibling[k])
+        _s_id.push_back(k);
+
+    std::size_t n = _s_id.size();
+
+    _s_base.resize(n);
+    _s_factor.resize(n);
+    _s_min.resize(n);
+    _s_max.resize(n);
+    _s_margin.resize(n);
+    _s_size.resize(n);
+    _s_frozen.resize(n);
+    _s_violation.resize(n);
+
+    for (std::size_t j = 0; j < n; j++) {
+        id_type k = _s_id[j];
+        auto const & m = _margins[k];
+        float content_main = column ? _content_h[k] : _content_w[k];
+
+        _s_base[j]   = _basis[k] < 0 ? content_main : _basis[k];
+        _s_min[j]    = _min[k];
+        _s_max[j]    = _max[k];
+        _s_margin[j] = column ? m.get_top() + m.get_bottom() : m.get_left() + m.get_right();
+    }
+
+    // Break items into lines and resolve flexible lengths of each line
+    float line_cross_pos = origin_cross;
+    std::size_t first = 0;
+
+    while (first < n) {
+        std::size_t last = first + 1;
+        float used = (std::min)((std::max)(_s_base[first], _s_min[first]), _s_max[first])
+            + _s_margin[first];
+
+        if (wrap) {
+            while (last < n) {
+                float outer = (std::min)((std::max)(_s_base[last], _s_min[last]), _s_max[last])
+                    + _s_margin[last];
+
+                if (used + gap + outer > avail_main)
+                    break;
+
+                used += gap + outer;
+                ++last;
+            }
+        } else {
+            last = n;
+        }
+
+        resolve_line(first, last, avail_main - gap * (last - first - 1));
+
+        // Cross size of the line: container cross size for single line,
+        // maximum item outer cross size otherwise
+        float line_cross = 0;
+
+        if (!wrap) {
+            line_cross = avail_cross;
+        } else {
+            for (std::size_t j = first; j < last; j++) {
+                id_type k = _s_id[j];
+                auto const & m = _margins[k];
+                float outer = (column ? _content_w[k] + m.get_left() + m.get_right()
+                    : _content_h[k] + m.get_top() + m.get_bottom());
+                line_cross = (std::max)(line_cross, outer);
+            }
+        }
+
+        // Scatter results (items are stretched along the cross axis)
+        float pos = origin_main;
+
+        for (std::size_t j = first; j < last; j++) {
+            id_type k = _s_id[j];
+            auto const & m = _margins[k];
+            float lead_main   = column ? m.get_top() : m.get_left();
+            float lead_cross  = column ? m.get_left() : m.get_top();
+            float cross_margin = column ? m.get_left() + m.get_right() : m.get_top() + m.get_bottom();
+
+            float main_start  = pos + lead_main;
+            float main_end    = main_start + _s_size[j];
+            float cross_start = line_cross_pos + lead_cross;
+            float cross_end   = cross_start + (std::max)(line_cross - cross_margin, 0.0f);
+
+            // Round edges rather than sizes to avoid gaps between items
+            unit_type ms = to_unit(main_start);
+            unit_type cs = to_unit(cross_start);
+            unit_type msize = to_unit(main_end) - ms;
+            unit_type csize = to_unit(cross_end) - cs;
+
+            if (column) {
+                _x[k] = cs; _y[k] = ms; _w[k] = csize; _h[k] = msize;
+            } else {
+                _x[k] = ms; _y[k] = cs; _w[k] = msize; _h[k] = csize;
+            }
+
+            pos = main_end + _s_margin[j] - lead_main + gap;
+        }
+
+        line_cross_pos += line_cross + gap;
+        first = last;
+    }
+}
+
+//
+// Resolves flexible lengths of items [first, last) into _s_size.
+// See https://www.w3.org/TR/css-flexbox-1/#resolve-flexible-lengths
+//
+template <typename UnitT>
+void flex_solver<UnitT>::resolve_line (std::size_t first, std::size_t last, float avail)
+{
+    float * base     = _s_base.data();
+    float * factor   = _s_factor.data();
+    float * fmin     = _s_min.data();
+    float * fmax     = _s_max.data();
+    float * margin   = _s_margin.data();
+    float * sz       = _s_size.data();
+    float * frozen   = _s_frozen.data();
+    float * violation = _s_violation.data();
+
+    float sum_base = 0;
+    float sum_margin = 0;
+
+    for (std::size_t j = first; j < last; j++) {
+        sum_base += base[j];
+        sum_margin += margin[j];
+    }
+
+    avail -= sum_margin;
+
+    bool growing = avail - sum_base > 0;
+
+    // Inflexible items are frozen at their hypothetical main size
+    for (std::size_t j = first; j < last; j++) {
+        id_type k = _s_id[j];
+        factor[j] = growing ? _grow[k] : _shrink[k] * base[j];
+        frozen[j] = factor[j] > 0 ? 0.0f : 1.0f;
+        sz[j]     = (std::min)((std::max)(base[j], fmin[j]), fmax[j]);
+    }
+
+    // Every iteration freezes at least one item
+    for (std::size_t iter = first; iter <= last; iter++) {
+        float sum_frozen = 0;
+        float sum_unfrozen_base = 0;
+        float sum_factor = 0;
+
+        for (std::size_t j = first; j < last; j++) {
+            sum_frozen        += frozen[j] * sz[j];
+            sum_unfrozen_base += (1.0f - frozen[j]) * base[j];
+            sum_factor        += (1.0f - frozen[j]) * factor[j];
+        }
+
+        if (sum_factor <= 0)
+            break;
+
+        float remaining = avail - sum_frozen - sum_unfrozen_base;
+        float ratio = remaining / sum_factor;
+        float total_violation = 0;
+
+        for (std::size_t j = first; j < last; j++) {
+            float target  = base[j] + ratio * factor[j];
+            float clamped = (std::min)((std::max)(target, fmin[j]), fmax[j]);
+            float f = frozen[j];
+
+            violation[j] = (1.0f - f) * (clamped - target);
+            sz[j] = f * sz[j] + (1.0f - f) * clamped;
+            total_violation += violation[j];
+        }
+
+        if (std::abs(total_violation) < 1e-3f)
+            break;
+
+        // Freeze min violations if total is positive, max violations otherwise
+        float dir = total_violation > 0 ? 1.0f : -1.0f;
+
+        for (std::size_t j = first; j < last; j++)
+            frozen[j] = (std::max)(frozen[j], dir * violation[j] > 0 ? 1.0f : 0.0f);
+    }
+}
+
+/**
+ * @class flex_layout
+ * @brief Lays out items with flexible sizes (grow, shrink and wrap).
+ */
+template <typename UnitT>
+class flex_layout : public layout<UnitT>
+{
+    using base_class = layout<UnitT>;
+
+public:
+    using unit_type   = UnitT;
+    using item_type   = typename base_class::item_type;
+    using size_type   = typename base_class::size_type;
+    using rect_type   = typename base_class::rect_type;
+    using solver_type = flex_solver<UnitT>;
+
+    struct flex_params
+    {
+        float grow   {0.0f};
+        float shrink {1.0f};
+        float basis  {solver_type::auto_basis};
+        float min    {0.0f};
+        float max    {(std::numeric_limits<float>::max)()};
+    };
+
+private:
+    orientation _orientation;
+    bool _wrap;
+    std::vector<flex_params> _params; // parallel to items
+    solver_type _solver;
+
+public:
+    flex_layout (orientation o = orientation::horizontal, bool wrap = false)
+        : _orientation(o)
+        , _wrap(wrap)
+    {}
+
+    /**
+     * @brief Adds @a item with flex parameters @a params to the end of
+     *        this layout.
+     */
+    void add_item (item_type * item, flex_params const & params = flex_params{})
+    {
+        base_class::add_item(item);
+        _params.back() = params;
+    }
+
+    void set_flex_params (std::size_t index, flex_params const & params)
+    {
+        assert(index < _params.size());
+        _params[index] = params;
+        this->invalidate();
+    }
+
+protected:
+    // Items may be added and removed through the base class too
+    void on_item_added (std::size_t index) override
+    {
+        _params.insert(_params.begin() + static_cast<std::ptrdiff_t>(index), flex_params{});
+    }
+
+    void on_item_removed (std::size_t index) override
+    {
+        _params.erase(_params.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+
+    size_type do_measure () override
+    {
+        rebuild();
+        _solver.measure();
+        return _solver.get_content_size(0);
+    }
+
+    void do_arrange (rect_type const & r) override
+    {
+        _solver.arrange(r);
+
+        auto const & items = this->items();
+
+        for (std::size_t i = 0; i < items.size(); i++)
+            items[i]->arrange(_solver.get_rect(static_cast<int>(i) + 1));
+    }
+
+private:
+    void rebuild ()
+    {
+        auto const & items = this->items();
+
+        _solver.clear();
+
+        auto root = _solver.add_container(solver_type::null_id, _orientation, _wrap);
+        _solver.set_paddings(root, this->get_paddings());
+        _solver.set_gap(root, this->get_spacing());
+
+        for (std::size_t i = 0; i < items.size(); i++) {
+            auto const & p = _params[i];
+            auto id = _solver.add_item(root);
+
+            // Returns cached result for items not invalidated
+            _solver.set_size_hint(id, items[i]->measure());
+            _solver.set_margins(id, items[i]->get_margins());
+            _solver.set_basis(id, p.basis);
+            _solver.set_grow(id, p.grow);
+            _solver.set_shrink(id, p.shrink);
+            _solver.set_min_max(id, p.min, p.max);
+        }
+    }
+};
+
+}} // namespace pfs::griotte
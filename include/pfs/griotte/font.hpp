@@ -5,17 +5,75 @@
 //
 // Changelog:
 //      2020.04.26 Initial version
+//      2021.07.04 Added native_handle().
+//      2021.07.05 Added font_metrics.
+//      2021.07.07 Added get_coverage().
+//      2021.07.09 Added glyph_outline().
+//      2021.07.11 Added variation axes and font_instance.
+//      2021.07.12 Added ink bounds to font_metrics and measure_text().
+//      2021.07.13 Added render mode to load_glyph().
+//      2021.07.13 Font can be constructed from FreeType face.
+//      2021.07.13 Instances are activated by font_instance only.
+//      2021.07.13 Text is measured with font_metrics only.
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include "coverage.hpp"
+#include "error.hpp"
 #include "glyph.hpp"
+#include "glyph_outline.hpp"
+#include "render_mode.hpp"
+#include "text_metrics.hpp"
 #include "ft2build.h"
 #include FT_FREETYPE_H
+#include FT_MULTIPLE_MASTERS_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace pfs {
 namespace griotte {
 
 class context;
+class font_instance;
+
+/**
+ * @brief OpenType variation axis tag (e.g. 'wght', 'wdth', 'slnt').
+ */
+using axis_tag = std::uint32_t;
+
+constexpr axis_tag make_axis_tag (char c1, char c2, char c3, char c4) noexcept
+{
+    return static_cast<axis_tag>(static_cast<std::uint8_t>(c1)) << 24
+        | static_cast<axis_tag>(static_cast<std::uint8_t>(c2)) << 16
+        | static_cast<axis_tag>(static_cast<std::uint8_t>(c3)) << 8
+        | static_cast<axis_tag>(static_cast<std::uint8_t>(c4));
+}
+
+/**
+ * @brief Variation axis of a variable font (values in design units).
+ */
+struct variation_axis
+{
+    axis_tag tag;
+    std::string name;
+    double minimum;
+    double default_value;
+    double maximum;
+};
+
+/**
+ * @brief Value of a variation axis.
+ */
+struct axis_value
+{
+    axis_tag tag;
+    double value;
+};
 
 enum class font_style
 {
@@ -28,17 +86,95 @@ enum class font_style
 class font
 {
     friend class context;
+    friend class font_instance;
 
     FT_Face _face {nullptr};
 
+    // Outlines in font units by instance and glyph index (shared by all
+    // sizes)
+    mutable std::unordered_map<std::uint64_t, outline_path> _outlines;
+
+    // Design coordinates of instances, instance identifier is the index
+    // plus one (zero is the default instance)
+    mutable std::vector<std::vector<FT_Fixed>> _instances;
+    mutable std::uint32_t _active_instance {0};
+
 private:
-    font (FT_Face face)
+    /**
+     * @brief Calls @a f with the variation descriptor of the face.
+     *
+     * @return @c false if the font is not variable.
+     */
+    template <typename F>
+    bool with_mm_var (F && f) const
     {
-        _face = face;
+        FT_MM_Var * mm = nullptr;
+
+        if (!is_variable() || FT_Get_MM_Var(_face, & mm) != 0)
+            return false;
+
+        f(*mm);
+        FT_Done_MM_Var(_face->glyph->library, mm);
+        return true;
+    }
+
+    /**
+     * @return Identifier of the instance with design coordinates
+     *         @a coords (instances with equal coordinates share it).
+     */
+    std::uint32_t instance_id (std::vector<FT_Fixed> && coords) const
+    {
+        auto pos = std::find(_instances.begin(), _instances.end(), coords);
+
+        if (pos != _instances.end())
+            return static_cast<std::uint32_t>(pos - _instances.begin()) + 1;
+
+        _instances.push_back(std::move(coords));
+        return static_cast<std::uint32_t>(_instances.size());
+    }
+
+    /**
+     * @brief Sets design coordinates of instance @a id to the face (nothing
+     *        is done if the instance is active already).
+     *
+     * @return @c false on error or if @a id is not an instance of the font.
+     */
+    bool activate_instance (std::uint32_t id) const noexcept
+    {
+        if (id == _active_instance)
+            return true;
+
+        if (id > _instances.size())
+            return false;
+
+        FT_Error rc = 0;
+
+        if (id == 0) {
+            rc = FT_Set_Var_Design_Coordinates(_face, 0, nullptr);
+        } else {
+            auto & coords = _instances[id - 1];
+            rc = FT_Set_Var_Design_Coordinates(_face
+                , static_cast<FT_UInt>(coords.size()), coords.data());
+        }
+
+        if (rc != 0)
+            return false;
+
+        _active_instance = id;
+        return true;
     }
 
 public:
     font () = default;
+
+    /**
+     * @brief Constructs font owning FreeType @a face (the face is released
+     *        by the font).
+     */
+    explicit font (FT_Face face)
+        : _face(face)
+    {}
+
     font (font const &) = delete;
     font & operator = (font const &) = delete;
 
@@ -69,6 +205,17 @@ public:
     {
         using std::swap;
         swap(_face, other._face);
+        swap(_outlines, other._outlines);
+        swap(_instances, other._instances);
+        swap(_active_instance, other._active_instance);
+    }
+
+    /**
+     * @return FreeType face of the font.
+     */
+    FT_Face native_handle () const noexcept
+    {
+        return _face;
     }
 
     ////////////////////////////////////////////////////////////////////////////
@@ -134,41 +281,148 @@ public:
         return _face->num_charmaps;
     }
 
+    /**
+     * @return Code points mapped to glyphs by the Unicode charmap of the
+     *         face (empty if the face has no Unicode charmap).
+     */
+    coverage_bitmap get_coverage () const
+    {
+        coverage_bitmap result;
+
+        if (!_face || FT_Select_Charmap(_face, FT_ENCODING_UNICODE) != 0)
+            return result;
+
+        FT_UInt gindex = 0;
+        FT_ULong cp = FT_Get_First_Char(_face, & gindex);
+
+        while (gindex != 0) {
+            result.set(static_cast<char32_t>(cp));
+            cp = FT_Get_Next_Char(_face, cp, & gindex);
+        }
+
+        return result;
+    }
+
+    /**
+     * @return Outline of the glyph of code point @a cp of instance
+     *         @a instance (see font_instance) scaled to @a pixel_size, the
+     *         origin is at the pen position on the baseline and the y axis
+     *         points down. Outlines are extracted once per glyph and cached
+     *         unscaled.
+     */
+    template <typename UnitT>
+    path<UnitT> glyph_outline (char32_t cp, int pixel_size, std::uint32_t instance
+        , std::error_code & ec) const
+    {
+        if (!_face || !(_face->face_flags & FT_FACE_FLAG_SCALABLE) || _face->units_per_EM == 0) {
+            ec = make_error_code(errc::freetype_error);
+            return path<UnitT>{};
+        }
+
+        auto glyph_index = static_cast<std::uint32_t>(FT_Get_Char_Index(_face, cp));
+        auto key = static_cast<std::uint64_t>(instance) << 32 | glyph_index;
+        auto it = _outlines.find(key);
+
+        if (it == _outlines.end()) {
+            outline_path outline;
+
+            if (!activate_instance(instance) || !load_outline(_face, glyph_index, outline)) {
+                ec = make_error_code(errc::freetype_error);
+                return path<UnitT>{};
+            }
+
+            it = _outlines.emplace(key, std::move(outline)).first;
+        }
+
+        return scale_outline<UnitT>(it->second
+            , static_cast<double>(pixel_size) / _face->units_per_EM);
+    }
+
+    template <typename UnitT>
+    path<UnitT> glyph_outline (char32_t cp, int pixel_size, std::error_code & ec) const
+    {
+        return glyph_outline<UnitT>(cp, pixel_size, 0, ec);
+    }
+
+    template <typename UnitT>
+    path<UnitT> glyph_outline (char32_t cp, int pixel_size) const
+    {
+        std::error_code ec;
+        auto result = glyph_outline<UnitT>(cp, pixel_size, ec);
+        if (ec) throw exception(ec);
+        return result;
+    }
+
     ////////////////////////////////////////////////////////////////////////////
-    // Font operations
+    // Font variations
     ////////////////////////////////////////////////////////////////////////////
 
-    /*   FT_LOAD_DEFAULT
-     *   FT_LOAD_RENDER
-     *   FT_LOAD_MONOCHROME
-     *   FT_LOAD_LINEAR_DESIGN
-     *   FT_LOAD_NO_SCALE
-     *   FT_LOAD_NO_HINTING
-     *   FT_LOAD_NO_BITMAP
-     *   FT_LOAD_NO_AUTOHINT
-     *   FT_LOAD_COLOR
-     *
-     *   FT_LOAD_VERTICAL_LAYOUT
-     *   FT_LOAD_IGNORE_TRANSFORM
-     *   FT_LOAD_FORCE_AUTOHINT
-     *   FT_LOAD_NO_RECURSE
-     *   FT_LOAD_PEDANTIC
-     *
-     *   FT_LOAD_TARGET_NORMAL
-     *   FT_LOAD_TARGET_LIGHT
-     *   FT_LOAD_TARGET_MONO
-     *   FT_LOAD_TARGET_LCD
-     *   FT_LOAD_TARGET_LCD_V
-     *
-     *   FT_LOAD_TARGET_MODE
+    bool is_variable () const
+    {
+        return _face ? FT_HAS_MULTIPLE_MASTERS(_face) : false;
+    }
+
+    /**
+     * @return Variation axes of the font (empty if the font is not
+     *         variable).
      */
-    glyph load_glyph (uint32_t uc, int pixel_size)
+    std::vector<variation_axis> get_variation_axes () const
     {
-        bool ok = true;
-        return load_glyph(uc, pixel_size, ok);
+        std::vector<variation_axis> result;
+
+        with_mm_var([& result] (FT_MM_Var const & mm) {
+            for (FT_UInt i = 0; i < mm.num_axis; i++) {
+                FT_Var_Axis const & a = mm.axis[i];
+                result.push_back(variation_axis{static_cast<axis_tag>(a.tag)
+                    , a.name ? std::string{a.name} : std::string{}
+                    , a.minimum / 65536.0, a.def / 65536.0, a.maximum / 65536.0});
+            }
+        });
+
+        return result;
     }
 
-    glyph load_glyph (uint32_t uc, int pixel_size, bool & ok)
+    /**
+     * @return Number of named instances (e.g. "Bold", "Light Condensed").
+     */
+    std::size_t named_instance_count () const
+    {
+        std::size_t result = 0;
+
+        with_mm_var([& result] (FT_MM_Var const & mm) {
+            result = mm.num_namedstyles;
+        });
+
+        return result;
+    }
+
+    /**
+     * @return Instance with axes set to @a values (values are clamped to
+     *         the axis range, missing axes have default values).
+     */
+    font_instance make_instance (std::vector<axis_value> const & values
+        , std::error_code & ec) const;
+
+    font_instance make_instance (std::vector<axis_value> const & values) const;
+
+    /**
+     * @return Named instance @a index (see named_instance_count()).
+     */
+    font_instance make_named_instance (std::size_t index, std::error_code & ec) const;
+
+    font_instance make_named_instance (std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Font operations
+    ////////////////////////////////////////////////////////////////////////////
+
+    /**
+     * @return Glyph of code point @a uc of @a pixel_size rendered by
+     *         @a mode into a texture of its own (GL_RED for coverage,
+     *         GL_RGBA for subpixel modes), see glyph_cache for glyphs
+     *         packed into an atlas.
+     */
+    glyph load_glyph (uint32_t uc, int pixel_size, render_mode mode, bool & ok)
     {
         auto ec = FT_Set_Pixel_Sizes(_face, 0, pixel_size);
 
@@ -177,27 +431,45 @@ public:
             return glyph{};
         }
 
-        ec = FT_Load_Char(_face, uc, FT_LOAD_RENDER);
+        ec = FT_Load_Char(_face, uc, load_flags(mode));
 
-        if (ec != 0) {
+        if (ec != 0 || !render_glyph(_face->glyph, mode)) {
             ok = false;
             return glyph{};
         }
 
+        std::vector<std::uint8_t> scratch;
+        int width = 0;
+        int height = 0;
+        int pitch = 0;
+        atlas_format format = atlas_format::coverage;
+        auto pixels = convert_bitmap(_face->glyph->bitmap, scratch, width, height
+            , pitch, format);
+
+        if (!pixels) {
+            ok = false;
+            return glyph{};
+        }
+
+        GLenum gl_format = format == atlas_format::coverage ? GL_RED : GL_RGBA;
+
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / bytes_per_pixel(format));
 
         unsigned int texture_id;
         glGenTextures(1, & texture_id);
         glBindTexture(GL_TEXTURE_2D, texture_id);
         glTexImage2D(GL_TEXTURE_2D            // target
             , 0                               // level
-            , GL_RED                          // internalFormat
-            , _face->glyph->bitmap.width      // width
-            , _face->glyph->bitmap.rows       // height
+            , gl_format                       // internalFormat
+            , width                           // width
+            , height                          // height
             , 0                               // border
-            , GL_RED                          // format
+            , gl_format                       // format
             , GL_UNSIGNED_BYTE                // type
-            , _face->glyph->bitmap.buffer);   // pixels
+            , pixels);                        // pixels
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
         // Set texture options
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -206,7 +478,7 @@ public:
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
         glyph result{texture_id};
-        result.set_size(_face->glyph->bitmap.width, _face->glyph->bitmap.rows);
+        result.set_size(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
         result.set_bearings(_face->glyph->bitmap_left, _face->glyph->bitmap_top);
 
         // The horizontal distance (in 1/64th pixels) from the origin to the
@@ -215,8 +487,293 @@ public:
 
         return result;
     }
+
+    glyph load_glyph (uint32_t uc, int pixel_size)
+    {
+        bool ok = true;
+        return load_glyph(uc, pixel_size, ok);
+    }
+
+    glyph load_glyph (uint32_t uc, int pixel_size, bool & ok)
+    {
+        return load_glyph(uc, pixel_size, render_mode::normal, ok);
+    }
+};
+
+/**
+ * @class font_instance
+ * @brief Handle of a font with fixed values of variation axes.
+ *
+ * Instances of a font share its face: activate() sets design coordinates
+ * of the instance to the face, so switching instances does not reload
+ * the font. Instances with equal coordinates have equal identifiers and
+ * share cached metrics and glyphs. Default constructed from a font it is
+ * the default instance (also of a font that is not variable).
+ *
+ * @note The instance refers to the font, so the font must not be moved or
+ *       destroyed while the instance is in use.
+ */
+class font_instance
+{
+    font const * _font {nullptr};
+    std::uint32_t _id {0};
+
+public:
+    font_instance () = default;
+
+    font_instance (font const & f, std::uint32_t id = 0) noexcept
+        : _font(& f)
+        , _id(id)
+    {}
+
+    font const & get_font () const noexcept
+    {
+        return *_font;
+    }
+
+    /**
+     * @return Identifier of the instance unique for the font, zero for the
+     *         default instance.
+     */
+    std::uint32_t get_id () const noexcept
+    {
+        return _id;
+    }
+
+    FT_Face native_handle () const noexcept
+    {
+        return _font->native_handle();
+    }
+
+    /**
+     * @brief Sets design coordinates of the instance to the face.
+     *
+     * @return @c false on error.
+     */
+    bool activate () const noexcept
+    {
+        return _font->activate_instance(_id);
+    }
+
+    /**
+     * @return Outline of the glyph of code point @a cp of the instance (see
+     *         font::glyph_outline()).
+     */
+    template <typename UnitT>
+    path<UnitT> glyph_outline (char32_t cp, int pixel_size, std::error_code & ec) const
+    {
+        return _font->glyph_outline<UnitT>(cp, pixel_size, _id, ec);
+    }
+
+    bool operator == (font_instance const & rhs) const noexcept
+    {
+        return _font == rhs._font && _id == rhs._id;
+    }
+
+    bool operator != (font_instance const & rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+};
+
+inline font_instance font::make_instance (std::vector<axis_value> const & values
+    , std::error_code & ec) const
+{
+    if (values.empty())
+        return font_instance{*this};
+
+    std::vector<FT_Fixed> coords;
+    std::size_t matched = 0;
+
+    with_mm_var([& values, & coords, & matched] (FT_MM_Var const & mm) {
+        coords.resize(mm.num_axis);
+
+        for (FT_UInt i = 0; i < mm.num_axis; i++) {
+            FT_Var_Axis const & a = mm.axis[i];
+            coords[i] = a.def;
+
+            for (auto const & v: values) {
+                if (v.tag == a.tag) {
+                    auto c = static_cast<FT_Fixed>(std::lround(v.value * 65536.0));
+                    coords[i] = (std::min)((std::max)(c, a.minimum), a.maximum);
+                    ++matched;
+                }
+            }
+        }
+    });
+
+    // Unknown axes (or the font is not variable)
+    if (matched != values.size()) {
+        ec = make_error_code(errc::bad_variation);
+        return font_instance{};
+    }
+
+    return font_instance{*this, instance_id(std::move(coords))};
+}
+
+inline font_instance font::make_instance (std::vector<axis_value> const & values) const
+{
+    std::error_code ec;
+    auto result = make_instance(values, ec);
+    if (ec) throw exception(ec);
+    return result;
+}
+
+inline font_instance font::make_named_instance (std::size_t index, std::error_code & ec) const
+{
+    std::vector<FT_Fixed> coords;
+
+    with_mm_var([index, & coords] (FT_MM_Var const & mm) {
+        if (index < mm.num_namedstyles)
+            coords.assign(mm.namedstyle[index].coords, mm.namedstyle[index].coords + mm.num_axis);
+    });
+
+    if (coords.empty()) {
+        ec = make_error_code(errc::bad_variation);
+        return font_instance{};
+    }
+
+    return font_instance{*this, instance_id(std::move(coords))};
+}
+
+inline font_instance font::make_named_instance (std::size_t index) const
+{
+    std::error_code ec;
+    auto result = make_named_instance(index, ec);
+    if (ec) throw exception(ec);
+    return result;
+}
+
+/**
+ * @class font_metrics
+ * @brief Metrics of a font instance of the specified pixel size (see
+ *        paragraph).
+ *
+ * Advances and ink bounds are loaded without rendering and cached per
+ * code point, so measuring needs no graphics context. This is the entry
+ * point for measuring text of a font: keep one per (instance, size) and
+ * pass it to measure_text(), so glyphs are loaded once for all strings.
+ *
+ * @code
+ * font_metrics m {f.make_instance({}), 16};
+ * auto e1 = measure_text(m, std::string{"OK"});
+ * auto e2 = measure_text(m, std::string{"Cancel"});
+ * @endcode
+ */
+class font_metrics
+{
+    struct glyph_entry
+    {
+        fixed26_6 advance;
+        ink_box ink;
+    };
+
+    font_instance _instance;
+    FT_Face _face;
+    int _pixel_size;
+    fixed26_6 _ascender;
+    fixed26_6 _descender;
+    fixed26_6 _height;
+    std::unordered_map<char32_t, glyph_entry> _glyphs;
+
+private:
+    glyph_entry const & get_entry (char32_t cp);
+
+public:
+    font_metrics (font const & f, int pixel_size)
+        : font_metrics(font_instance{f}, pixel_size)
+    {}
+
+    font_metrics (font_instance const & fi, int pixel_size)
+        : _instance(fi)
+        , _face(fi.native_handle())
+        , _pixel_size(pixel_size)
+    {
+        _instance.activate();
+        FT_Set_Pixel_Sizes(_face, 0, pixel_size);
+        _ascender  = fixed26_6::from_raw(_face->size->metrics.ascender);
+        _descender = fixed26_6::from_raw(_face->size->metrics.descender);
+        _height    = fixed26_6::from_raw(_face->size->metrics.height);
+    }
+
+    int pixel_size () const noexcept
+    {
+        return _pixel_size;
+    }
+
+    /**
+     * @return Distance from the baseline to the top of the line.
+     */
+    fixed26_6 ascender () const noexcept
+    {
+        return _ascender;
+    }
+
+    /**
+     * @return Distance from the baseline to the bottom of the line
+     *         (negative).
+     */
+    fixed26_6 descender () const noexcept
+    {
+        return _descender;
+    }
+
+    /**
+     * @return Distance between baselines of consecutive lines.
+     */
+    fixed26_6 height () const noexcept
+    {
+        return _height;
+    }
+
+    /**
+     * @return Horizontal advance of the glyph of code point @a cp, zero if
+     *         the glyph cannot be loaded.
+     */
+    fixed26_6 advance (char32_t cp)
+    {
+        return get_entry(cp).advance;
+    }
+
+    /**
+     * @return Ink bounds of the glyph of code point @a cp, empty if the
+     *         glyph is blank or cannot be loaded.
+     */
+    ink_box const & ink_bounds (char32_t cp)
+    {
+        return get_entry(cp).ink;
+    }
 };
 
+inline font_metrics::glyph_entry const & font_metrics::get_entry (char32_t cp)
+{
+    auto it = _glyphs.find(cp);
+
+    if (it != _glyphs.end())
+        return it->second;
+
+    glyph_entry result {fixed26_6{}, ink_box{}};
+
+    // The face is shared with glyph loading and other instances, so the
+    // instance and the size are set every time
+    if (_instance.activate() && FT_Set_Pixel_Sizes(_face, 0, _pixel_size) == 0
+            && FT_Load_Char(_face, cp, FT_LOAD_DEFAULT) == 0) {
+        FT_Glyph_Metrics const & gm = _face->glyph->metrics;
+        auto raw = [] (FT_Pos v) {
+            return fixed26_6::from_raw(static_cast<fixed26_6::rep_type>(v));
+        };
+
+        result.advance = raw(_face->glyph->advance.x);
+
+        if (gm.width > 0 && gm.height > 0) {
+            result.ink = ink_box{raw(gm.horiBearingX), raw(-gm.horiBearingY)
+                , raw(gm.horiBearingX + gm.width), raw(gm.height - gm.horiBearingY)};
+        }
+    }
+
+    return _glyphs.emplace(cp, result).first->second;
+}
+
 inline std::string to_string (font_style value)
 {
     switch (value) {
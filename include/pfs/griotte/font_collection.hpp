@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.07 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/coverage.hpp"
+#include "pfs/griotte/utf8.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class basic_font_collection
+ * @brief Font fallback chain: the glyph of a code point is taken from the
+ *        first face of the chain covering it.
+ *
+ * Every face has a coverage bitmap built once from its charmap, resolved
+ * faces are cached per code point, so resolving takes constant time and
+ * FreeType is not queried per character. Faces added by path are loaded
+ * lazily: a face is loaded when the code point being resolved is not
+ * covered by any of the preceding faces.
+ *
+ * @a Loader must provide
+ * @code
+ * Font load_font (std::string const & path, int face_index);
+ * @endcode
+ * @a Font must be movable, convertible to @c bool (loaded successfully) and
+ * provide 'coverage_bitmap get_coverage () const'.
+ *
+ * @note Not thread-safe.
+ */
+template <typename Loader, typename Font>
+class basic_font_collection
+{
+public:
+    using font_type = Font;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Faces indices are cached in bytes
+    static constexpr std::size_t max_faces = 254;
+
+private:
+    enum class state { unloaded, loaded, failed };
+
+    struct entry
+    {
+        std::string path;
+        int face_index;
+        state st;
+        font_type f;
+        coverage_bitmap coverage;
+    };
+
+    static constexpr std::size_t page_size = 256;
+
+    // Resolved face + 1, zero means unresolved
+    static constexpr std::uint8_t unresolved = 0;
+    static constexpr std::uint8_t uncovered = 0xFF;
+
+    using page_type = std::array<std::uint8_t, page_size>;
+
+    Loader * _loader;
+    std::deque<entry> _entries; // references stay valid on append
+    std::vector<std::unique_ptr<page_type>> _resolved;
+
+private:
+    bool ensure_loaded (entry & e)
+    {
+        if (e.st == state::unloaded) {
+            e.f = _loader->load_font(e.path, e.face_index);
+
+            if (static_cast<bool>(e.f)) {
+                e.coverage = e.f.get_coverage();
+                e.st = state::loaded;
+            } else {
+                e.st = state::failed;
+            }
+        }
+
+        return e.st == state::loaded;
+    }
+
+    std::size_t resolve_slow (char32_t cp)
+    {
+        for (std::size_t i = 0; i < _entries.size(); i++) {
+            entry & e = _entries[i];
+
+            if (ensure_loaded(e) && e.coverage.test(cp))
+                return i;
+        }
+
+        return npos;
+    }
+
+    void reset_cache ()
+    {
+        for (auto & p: _resolved)
+            p.reset();
+    }
+
+public:
+    explicit basic_font_collection (Loader & loader)
+        : _loader(& loader)
+        , _resolved((coverage_bitmap::max_code_point + 1) / page_size)
+    {}
+
+    basic_font_collection (basic_font_collection const &) = delete;
+    basic_font_collection & operator = (basic_font_collection const &) = delete;
+
+    /**
+     * @brief Appends face @a face_index of the font file @a path to the
+     *        chain, the face is loaded on first need.
+     *
+     * @return Index of the face in the chain or @c npos if the chain is full.
+     */
+    std::size_t add (std::string const & path, int face_index = 0)
+    {
+        if (_entries.size() >= max_faces)
+            return npos;
+
+        _entries.push_back(entry{path, face_index, state::unloaded, font_type{}, coverage_bitmap{}});
+        reset_cache();
+        return _entries.size() - 1;
+    }
+
+    /**
+     * @brief Appends already loaded font @a f to the chain.
+     */
+    std::size_t add (font_type && f)
+    {
+        if (_entries.size() >= max_faces)
+            return npos;
+
+        bool ok = static_cast<bool>(f);
+        _entries.push_back(entry{std::string{}, 0, ok ? state::loaded : state::failed
+            , std::move(f), coverage_bitmap{}});
+
+        if (ok)
+            _entries.back().coverage = _entries.back().f.get_coverage();
+
+        reset_cache();
+        return _entries.size() - 1;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _entries.size();
+    }
+
+    bool is_loaded (std::size_t i) const noexcept
+    {
+        return _entries[i].st == state::loaded;
+    }
+
+    /**
+     * @return Face @a i of the chain (loaded if necessary) or @c nullptr if
+     *         it cannot be loaded.
+     */
+    font_type * get_font (std::size_t i)
+    {
+        return ensure_loaded(_entries[i]) ? & _entries[i].f : nullptr;
+    }
+
+    /**
+     * @return Coverage of face @a i (empty if the face is not loaded).
+     */
+    coverage_bitmap const & get_coverage (std::size_t i) const noexcept
+    {
+        return _entries[i].coverage;
+    }
+
+    /**
+     * @return Index of the first face covering @a cp or @c npos if no face
+     *         covers it.
+     */
+    std::size_t resolve (char32_t cp)
+    {
+        if (cp > coverage_bitmap::max_code_point)
+            return npos;
+
+        std::unique_ptr<page_type> & page = _resolved[cp / page_size];
+
+        if (!page)
+            page.reset(new page_type{});
+
+        std::uint8_t & r = (*page)[cp % page_size];
+
+        if (r == unresolved) {
+            std::size_t i = resolve_slow(cp);
+            r = i == npos ? uncovered : static_cast<std::uint8_t>(i + 1);
+        }
+
+        return r == uncovered ? npos : r - 1;
+    }
+
+    /**
+     * @brief Splits UTF-8 @a text of @a len bytes into runs rendered by the
+     *        same face and calls @a f (std::size_t first, std::size_t last,
+     *        std::size_t face) for every run (byte offsets).
+     *
+     * A code point covered by the face of the current run continues the run
+     * (so spaces and punctuation do not split runs), uncovered code points
+     * are rendered by the current face (or the first one).
+     */
+    template <typename F>
+    void itemize (char const * text, std::size_t len, F && f);
+};
+
+template <typename Loader, typename Font>
+constexpr std::size_t basic_font_collection<Loader, Font>::npos;
+
+template <typename Loader, typename Font>
+constexpr std::size_t basic_font_collection<Loader, Font>::max_faces;
+
+template <typename Loader, typename Font>
+template <typename F>
+void basic_font_collection<Loader, Font>::itemize (char const * text, std::size_t len, F && f)
+{
+    if (_entries.empty())
+        return;
+
+    std::size_t first = 0;
+    std::size_t face = npos;
+    std::size_t pos = 0;
+
+    while (pos < len) {
+        std::size_t offset = pos;
+        char32_t cp = utf8_decode(text, len, pos);
+
+        if (face != npos && _entries[face].coverage.test(cp))
+            continue;
+
+        std::size_t i = resolve(cp);
+
+        if (i == npos)
+            i = face == npos ? 0 : face;
+
+        if (i != face) {
+            if (face != npos)
+                f(first, offset, face);
+
+            first = offset;
+            face = i;
+        }
+    }
+
+    if (face != npos)
+        f(first, len, face);
+}
+
+}} // namespace pfs::griotte
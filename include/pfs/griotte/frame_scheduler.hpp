@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.21 Initial version
+//      2021.07.13 Added pacing_delay().
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <algorithm>
+#include <atomic>
+
+//
+// Frame scheduler decides when the render loop has to render a frame, how many
+// fixed timestep animation ticks to run before it and how long the loop may
+// sleep waiting for events.
+//
+// See [Fix Your Timestep!](https://gafferongames.com/post/fix_your_timestep/)
+//
+
+namespace pfs {
+namespace griotte {
+
+class frame_scheduler
+{
+    double _tick_interval {1.0 / 60.0};
+    double _frame_budget {1.0 / 60.0};
+    double _max_frame_delta {0.25};
+    int    _max_ticks_per_frame {8};
+
+    double _accumulator {0};
+    double _last_time {0};
+    double _frame_start {0};
+    double _next_wakeup {-1.0}; // negative if not scheduled
+    bool   _animating {false};
+    bool   _was_animating {false};
+    bool   _render {false};
+    std::atomic<bool> _dirty {true};
+
+    // Statistics
+    unsigned int _frames {0};
+    unsigned int _over_budget_frames {0};
+    double       _last_frame_duration {0};
+
+public:
+    /**
+     * @brief Constructs scheduler running animation ticks with @a tick_rate
+     *        frequency (in Hz).
+     */
+    frame_scheduler (double tick_rate = 60.0)
+        : _tick_interval(1.0 / tick_rate)
+    {}
+
+    frame_scheduler (frame_scheduler const &) = delete;
+    frame_scheduler & operator = (frame_scheduler const &) = delete;
+
+    /**
+     * @return Fixed timestep of animation ticks in seconds.
+     */
+    double tick_interval () const noexcept
+    {
+        return _tick_interval;
+    }
+
+    void set_tick_rate (double tick_rate) noexcept
+    {
+        _tick_interval = 1.0 / tick_rate;
+    }
+
+    /**
+     * @return Time budget of one frame in seconds.
+     */
+    double frame_budget () const noexcept
+    {
+        return _frame_budget;
+    }
+
+    /**
+     * @brief Sets frame budget according to display @a refresh_rate (in Hz).
+     */
+    void set_refresh_rate (double refresh_rate) noexcept
+    {
+        if (refresh_rate > 0)
+            _frame_budget = 1.0 / refresh_rate;
+    }
+
+    /**
+     * @brief Limits number of animation ticks per frame to avoid the
+     *        "spiral of death" when ticks are slower than real time.
+     */
+    void set_max_ticks_per_frame (int n) noexcept
+    {
+        _max_ticks_per_frame = (std::max)(n, 1);
+    }
+
+    /**
+     * @brief Resets time keeping to @a now.
+     */
+    void reset (double now) noexcept
+    {
+        _accumulator = 0;
+        _last_time = now;
+        _frame_start = now;
+    }
+
+    /**
+     * @brief Requests rendering of the next frame.
+     * @note Can be called from any thread.
+     */
+    void request_redraw () noexcept
+    {
+        _dirty.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Requests rendering of a frame not later than @a when
+     *        (absolute time in seconds), e.g. for cursor blinking.
+     */
+    void schedule_redraw (double when) noexcept
+    {
+        if (_next_wakeup < 0 || when < _next_wakeup)
+            _next_wakeup = when;
+    }
+
+    /**
+     * @return @c true if animation ticks are running.
+     */
+    bool animating () const noexcept
+    {
+        return _animating;
+    }
+
+    void set_animating (bool enable) noexcept
+    {
+        _animating = enable;
+    }
+
+    /**
+     * @return @c true if there is nothing to render or animate, so the
+     *         render loop may sleep.
+     */
+    bool idle () const noexcept
+    {
+        return !_animating && !_dirty.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return Time in seconds the loop may block waiting for events
+     *         (@c 0 means do not block, negative value means block until
+     *         the next event).
+     */
+    double wait_timeout (double now) const noexcept
+    {
+        if (!idle())
+            return 0;
+
+        if (_next_wakeup < 0)
+            return -1.0;
+
+        return (std::max)(_next_wakeup - now, 0.0);
+    }
+
+    /**
+     * @brief Starts a new frame at time @a now.
+     * @return Number of fixed timestep animation ticks to run before
+     *         rendering the frame.
+     */
+    int begin_frame (double now) noexcept
+    {
+        _frame_start = now;
+
+        if (_next_wakeup >= 0 && now >= _next_wakeup) {
+            _next_wakeup = -1.0;
+            request_redraw();
+        }
+
+        _render = _dirty.exchange(false, std::memory_order_acq_rel) || _animating;
+
+        double delta = (std::min)(now - _last_time, _max_frame_delta);
+        bool started = _animating && !_was_animating;
+        _last_time = now;
+        _was_animating = _animating;
+
+        if (!_animating) {
+            // Animation time does not advance while idle
+            _accumulator = 0;
+            return 0;
+        }
+
+        // Time spent in idle state is not an animation time
+        if (started)
+            delta = 0;
+
+        _accumulator += delta;
+
+        int ticks = static_cast<int>(_accumulator / _tick_interval);
+
+        if (ticks > _max_ticks_per_frame) {
+            ticks = _max_ticks_per_frame;
+            _accumulator = 0;
+        } else {
+            _accumulator -= ticks * _tick_interval;
+        }
+
+        return ticks;
+    }
+
+    /**
+     * @return @c true if the current frame must be rendered.
+     */
+    bool need_render () const noexcept
+    {
+        return _render;
+    }
+
+    /**
+     * @return Interpolation factor in range [0, 1) between the previous and
+     *         the current animation state for rendering.
+     */
+    double alpha () const noexcept
+    {
+        return _animating ? _accumulator / _tick_interval : 0;
+    }
+
+    /**
+     * @brief Finishes the current frame at time @a now.
+     */
+    void end_frame (double now) noexcept
+    {
+        if (!_render)
+            return;
+
+        _last_frame_duration = now - _frame_start;
+        ++_frames;
+
+        if (_last_frame_duration > _frame_budget)
+            ++_over_budget_frames;
+    }
+
+    /**
+     * @return Time in seconds remaining till the end of the frame budget
+     *         of the current frame.
+     */
+    double budget_remaining (double now) const noexcept
+    {
+        return (std::max)(_frame_start + _frame_budget - now, 0.0);
+    }
+
+    /**
+     * @return Time in seconds the loop has to wait after the current frame
+     *         to keep the frame rate while animating, zero if the frame was
+     *         paced by a buffer swap synchronized with the vertical retrace
+     *         (@a synced).
+     */
+    double pacing_delay (double now, bool synced) const noexcept
+    {
+        return synced || !_animating ? 0 : budget_remaining(now);
+    }
+
+    /**
+     * @return Number of rendered frames.
+     */
+    unsigned int frames () const noexcept
+    {
+        return _frames;
+    }
+
+    /**
+     * @return Number of rendered frames exceeded the frame budget.
+     */
+    unsigned int over_budget_frames () const noexcept
+    {
+        return _over_budget_frames;
+    }
+
+    /**
+     * @return Duration of the last rendered frame in seconds.
+     */
+    double last_frame_duration () const noexcept
+    {
+        return _last_frame_duration;
+    }
+};
+
+}} // namespace pfs::griotte
@@ -5,9 +5,11 @@
 //
 // Changelog:
 //      2020.05.10 Initial version
+//      2021.07.03 Added advance and bearing accessors.
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "GLFW/glfw3.h"
+#include "pfs/griotte/fixed.hpp"
 
 namespace pfs {
 namespace griotte {
@@ -19,7 +21,7 @@ class glyph
     unsigned int _height {0};     // height as size component of glyph
     int _bearing_x {0};           // Offset from baseline to left/top of glyph
     int _bearing_y {0};           // Offset from baseline to left/top of glyph
-    unsigned int _advance {0};    // Offset to advance to next glyph
+    unsigned int _advance {0};    // Offset to advance to next glyph (26.6 format)
 
 public:
     glyph () {}
@@ -55,11 +57,29 @@ public:
         return _height;
     }
 
+    int bearing_x () const noexcept
+    {
+        return _bearing_x;
+    }
+
+    int bearing_y () const noexcept
+    {
+        return _bearing_y;
+    }
+
     void set_advance (unsigned int advance)
     {
         _advance = advance;
     }
 
+    /**
+     * @return Offset to advance to next glyph with subpixel precision.
+     */
+    fixed26_6 advance () const noexcept
+    {
+        return fixed26_6::from_raw(static_cast<fixed26_6::rep_type>(_advance));
+    }
+
     unsigned int id () const
     {
         return _texture_id;
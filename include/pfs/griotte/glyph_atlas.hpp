@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.08 Initial version
+//      2021.07.10 Added RGBA pages.
+//      2021.07.13 Added LCD pages.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Pixel format of an atlas page.
+ */
+enum class atlas_format : std::uint8_t
+{
+      coverage ///< One byte (alpha) per pixel
+    , rgba     ///< Four bytes per pixel (R, G, B, A), premultiplied alpha
+    , lcd      ///< Four bytes per pixel (R, G, B subpixel coverages and their maximum)
+};
+
+constexpr int bytes_per_pixel (atlas_format format) noexcept
+{
+    return format == atlas_format::coverage ? 1 : 4;
+}
+
+/**
+ * @brief Region of an atlas page.
+ */
+struct atlas_region
+{
+    std::uint16_t page;
+    std::uint16_t x;
+    std::uint16_t y;
+    std::uint16_t width;
+    std::uint16_t height;
+};
+
+/**
+ * @class glyph_atlas
+ * @brief Glyph bitmaps packed into pages.
+ *
+ * Every page has one format: coverage pages keep ordinary glyphs, RGBA
+ * pages keep color glyphs (emoji), LCD pages keep subpixel rendered
+ * glyphs, so all of them are drawn from textures shared by many glyphs.
+ * Bitmaps are packed by shelves and separated by one pixel of padding, so
+ * bilinear sampling does not bleed between glyphs. Pages are kept in
+ * memory, the renderer uploads the dirty rectangle of a page to its
+ * texture and clears it. The number of pages is limited: when the atlas
+ * is full insertion fails and the owner decides what to evict (usually
+ * everything, see clear()).
+ */
+class glyph_atlas
+{
+public:
+    struct rect
+    {
+        int x0, y0, x1, y1; // empty if x0 >= x1
+    };
+
+private:
+    static constexpr int padding = 1;
+
+    struct shelf
+    {
+        int y;
+        int height;
+        int x; // first free column
+    };
+
+    struct page
+    {
+        atlas_format format;
+        std::vector<std::uint8_t> pixels;
+        std::vector<shelf> shelves;
+        int bottom; // first free row for a new shelf
+        rect dirty;
+    };
+
+    int _width;
+    int _height;
+    std::size_t _max_pages;
+    std::vector<page> _pages;
+
+private:
+    static rect empty_rect () noexcept
+    {
+        return rect{0, 0, 0, 0};
+    }
+
+    bool place (page & p, int w, int h, int & x, int & y);
+
+    std::size_t page_bytes (atlas_format format) const noexcept
+    {
+        return static_cast<std::size_t>(_width) * _height * bytes_per_pixel(format);
+    }
+
+public:
+    /**
+     * @param width Page width in pixels.
+     * @param height Page height in pixels.
+     * @param max_pages Maximum number of pages.
+     */
+    glyph_atlas (int width = 512, int height = 512, std::size_t max_pages = 8)
+        : _width(width)
+        , _height(height)
+        , _max_pages(max_pages > 0 ? max_pages : 1)
+    {}
+
+    int get_width () const noexcept
+    {
+        return _width;
+    }
+
+    int get_height () const noexcept
+    {
+        return _height;
+    }
+
+    std::size_t page_count () const noexcept
+    {
+        return _pages.size();
+    }
+
+    std::size_t max_pages () const noexcept
+    {
+        return _max_pages;
+    }
+
+    /**
+     * @return Pixel format of page @a i.
+     */
+    atlas_format get_format (std::size_t i) const noexcept
+    {
+        return _pages[i].format;
+    }
+
+    /**
+     * @return Pixels of page @a i (rows of get_width() pixels).
+     */
+    std::uint8_t const * get_pixels (std::size_t i) const noexcept
+    {
+        return _pages[i].pixels.data();
+    }
+
+    /**
+     * @return Rectangle of page @a i changed since the last clear_dirty().
+     */
+    rect get_dirty_rect (std::size_t i) const noexcept
+    {
+        return _pages[i].dirty;
+    }
+
+    void clear_dirty (std::size_t i) noexcept
+    {
+        _pages[i].dirty = empty_rect();
+    }
+
+    /**
+     * @brief Removes all bitmaps (pages are kept and marked dirty, an empty
+     *        page is reused for bitmaps of any format).
+     */
+    void clear ()
+    {
+        for (auto & p: _pages) {
+            std::fill(p.pixels.begin(), p.pixels.end(), 0);
+            p.shelves.clear();
+            p.bottom = 0;
+            p.dirty = rect{0, 0, _width, _height};
+        }
+    }
+
+    /**
+     * @brief Copies bitmap @a pixels of @a width x @a height of @a format
+     *        (rows are @a pitch bytes apart) into a page of the same format.
+     *
+     * @return @c false if the bitmap does not fit (the atlas is full or the
+     *         bitmap is larger than a page).
+     */
+    bool insert (int width, int height, std::uint8_t const * pixels, int pitch
+        , atlas_format format, atlas_region & out);
+
+    bool insert (int width, int height, std::uint8_t const * pixels, int pitch
+        , atlas_region & out)
+    {
+        return insert(width, height, pixels, pitch, atlas_format::coverage, out);
+    }
+};
+
+inline bool glyph_atlas::place (page & p, int w, int h, int & x, int & y)
+{
+    // The lowest shelf that fits without wasting too much height
+    shelf * best = nullptr;
+
+    for (auto & s: p.shelves) {
+        if (s.height >= h && s.height <= h + h / 2 + 2 && _width - s.x >= w
+                && (!best || s.height < best->height)) {
+            best = & s;
+        }
+    }
+
+    if (!best) {
+        if (_height - p.bottom < h || _width < w)
+            return false;
+
+        p.shelves.push_back(shelf{p.bottom, h, 0});
+        p.bottom += h;
+        best = & p.shelves.back();
+    }
+
+    x = best->x;
+    y = best->y;
+    best->x += w;
+    return true;
+}
+
+inline bool glyph_atlas::insert (int width, int height, std::uint8_t const * pixels
+    , int pitch, atlas_format format, atlas_region & out)
+{
+    int w = width + padding;
+    int h = height + padding;
+
+    if (w > _width || h > _height)
+        return false;
+
+    int x = 0;
+    int y = 0;
+    std::size_t index = 0;
+
+    for (; index < _pages.size(); index++) {
+        if (_pages[index].format == format && place(_pages[index], w, h, x, y))
+            break;
+    }
+
+    if (index == _pages.size()) {
+        // Empty page of another format (left by clear())
+        for (index = 0; index < _pages.size(); index++) {
+            page & p = _pages[index];
+
+            if (p.shelves.empty()) {
+                p.format = format;
+                p.pixels.assign(page_bytes(format), 0);
+                p.dirty = rect{0, 0, _width, _height};
+                place(p, w, h, x, y);
+                break;
+            }
+        }
+    }
+
+    if (index == _pages.size()) {
+        if (_pages.size() >= _max_pages)
+            return false;
+
+        _pages.push_back(page{format, std::vector<std::uint8_t>(page_bytes(format), 0)
+            , {}, 0, empty_rect()});
+
+        place(_pages.back(), w, h, x, y);
+    }
+
+    page & p = _pages[index];
+    std::size_t bpp = static_cast<std::size_t>(bytes_per_pixel(format));
+
+    for (int row = 0; row < height; row++) {
+        std::memcpy(& p.pixels[(static_cast<std::size_t>(y + row) * _width + x) * bpp]
+            , pixels + static_cast<std::ptrdiff_t>(row) * pitch, width * bpp);
+    }
+
+    if (p.dirty.x0 >= p.dirty.x1) {
+        p.dirty = rect{x, y, x + width, y + height};
+    } else {
+        p.dirty.x0 = (std::min)(p.dirty.x0, x);
+        p.dirty.y0 = (std::min)(p.dirty.y0, y);
+        p.dirty.x1 = (std::max)(p.dirty.x1, x + width);
+        p.dirty.y1 = (std::max)(p.dirty.y1, y + height);
+    }
+
+    out = atlas_region{static_cast<std::uint16_t>(index), static_cast<std::uint16_t>(x)
+        , static_cast<std::uint16_t>(y), static_cast<std::uint16_t>(width)
+        , static_cast<std::uint16_t>(height)};
+
+    return true;
+}
+
+}} // namespace pfs::griotte
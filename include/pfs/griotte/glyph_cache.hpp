@@ -0,0 +1,545 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.08 Initial version
+//      2021.07.10 Added color glyphs and bitmap strikes.
+//      2021.07.11 Glyphs are cached per font instance.
+//      2021.07.13 Added render modes.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/error.hpp"
+#include "pfs/griotte/fixed.hpp"
+#include "pfs/griotte/font.hpp"
+#include "pfs/griotte/glyph_atlas.hpp"
+#include "pfs/griotte/render_mode.hpp"
+#include "pfs/griotte/shaped_run.hpp"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Glyph rasterized into an atlas.
+ */
+struct cached_glyph
+{
+    atlas_region region;
+    int bearing_x;       ///< Offset from the pen position to the left of the bitmap
+    int bearing_y;       ///< Offset from the baseline to the top of the bitmap
+    fixed26_6 advance;   ///< Unhinted advance
+};
+
+/**
+ * @brief Textured quad of a glyph (y axis points down).
+ */
+struct glyph_quad
+{
+    float x0, y0, x1, y1; ///< Screen rectangle
+    float u0, v0, u1, v1; ///< Texture coordinates on the atlas page
+    std::uint16_t page;
+};
+
+/**
+ * @brief Resamples premultiplied BGRA bitmap of @a width x @a height (rows
+ *        are @a pitch bytes apart) into RGBA bitmap of @a dst_width x
+ *        @a dst_height stored in @a out.
+ *
+ * Every destination pixel is the average of the source pixels it covers
+ * (box filter), so downscaling does not alias.
+ */
+inline void resample_bgra (std::uint8_t const * pixels, int width, int height, int pitch
+    , int dst_width, int dst_height, std::vector<std::uint8_t> & out)
+{
+    out.resize(static_cast<std::size_t>(dst_width) * dst_height * 4);
+    std::uint8_t * d = out.data();
+
+    for (int dy = 0; dy < dst_height; dy++) {
+        int sy0 = dy * height / dst_height;
+        int sy1 = (std::max)(sy0 + 1, (dy + 1) * height / dst_height);
+
+        for (int dx = 0; dx < dst_width; dx++) {
+            int sx0 = dx * width / dst_width;
+            int sx1 = (std::max)(sx0 + 1, (dx + 1) * width / dst_width);
+            unsigned int sum[4] = {0, 0, 0, 0};
+
+            for (int sy = sy0; sy < sy1; sy++) {
+                std::uint8_t const * s = pixels + static_cast<std::ptrdiff_t>(sy) * pitch + sx0 * 4;
+
+                for (int sx = sx0; sx < sx1; sx++, s += 4) {
+                    sum[0] += s[2];
+                    sum[1] += s[1];
+                    sum[2] += s[0];
+                    sum[3] += s[3];
+                }
+            }
+
+            unsigned int n = static_cast<unsigned int>((sx1 - sx0) * (sy1 - sy0));
+
+            for (int c = 0; c < 4; c++)
+                *d++ = static_cast<std::uint8_t>((sum[c] + n / 2) / n);
+        }
+    }
+}
+
+/**
+ * @class glyph_cache
+ * @brief Cache of glyphs rasterized into a glyph_atlas with subpixel
+ *        horizontal positioning.
+ *
+ * A glyph is rasterized on demand in up to @c max_phases variants shifted
+ * horizontally by a fraction of a pixel (outline is translated before
+ * rendering), text quads use the variant nearest to the fractional part of
+ * the pen position. So glyph spacing follows unhinted advances and text
+ * moves smoothly by fractions of a pixel.
+ *
+ * Atlas growth is bounded by the number of phases and the largest size
+ * rendered with subpixel positioning (larger text is snapped to whole
+ * pixels, its jitter is not noticeable), besides the atlas limits its
+ * pages.
+ *
+ * Color glyphs (CBDT, sbix, COLR) are loaded with FT_LOAD_COLOR into RGBA
+ * pages of the atlas and are snapped to whole pixels. For faces with
+ * embedded bitmap strikes the nearest strike is resampled to the requested
+ * size once, when the glyph is cached.
+ *
+ * Glyphs are rasterized by the current render mode (see set_render_mode()),
+ * every mode has its own cache entries: mono and gray glyphs go to coverage
+ * pages, subpixel (LCD) glyphs go to LCD pages. Only the light mode (the
+ * default) is positioned with subpixel precision, other modes hint stems
+ * horizontally and are snapped to whole pixels.
+ *
+ * @note Not thread-safe.
+ */
+class glyph_cache
+{
+public:
+    static constexpr int max_phases = 4;
+
+private:
+    struct key
+    {
+        FT_Face face;
+        std::uint32_t instance;
+        std::uint32_t glyph_index;
+        int pixel_size;
+        int phase;
+        render_mode mode;
+
+        bool operator == (key const & rhs) const noexcept
+        {
+            return face == rhs.face && instance == rhs.instance
+                && glyph_index == rhs.glyph_index
+                && pixel_size == rhs.pixel_size && phase == rhs.phase
+                && mode == rhs.mode;
+        }
+    };
+
+    struct key_hash
+    {
+        std::size_t operator () (key const & k) const noexcept
+        {
+            std::size_t h = std::hash<void *>{}(k.face);
+            h = details::hash_combine(h, k.instance);
+            h = details::hash_combine(h, k.glyph_index);
+            h = details::hash_combine(h, static_cast<std::size_t>(k.pixel_size));
+            h = details::hash_combine(h, static_cast<std::size_t>(k.phase));
+            return details::hash_combine(h, static_cast<std::size_t>(k.mode));
+        }
+    };
+
+    glyph_atlas * _atlas;
+    int _phases;
+    int _max_subpixel_size;
+    render_mode _mode {render_mode::light};
+    std::unordered_map<key, cached_glyph, key_hash> _glyphs;
+    std::vector<std::uint8_t> _scratch; // converted bitmap
+
+private:
+    // Bitmaps of color glyphs cannot be shifted by a fraction of a pixel
+    static bool is_color_face (FT_Face face) noexcept
+    {
+        return FT_HAS_COLOR(face);
+    }
+
+    // Color glyphs are loaded from embedded bitmap strikes (CBDT, sbix)
+    static bool uses_strikes (FT_Face face) noexcept
+    {
+        return face->num_fixed_sizes > 0 && FT_HAS_COLOR(face);
+    }
+
+    /**
+     * @return Index of the smallest strike not less than @a pixel_size (or
+     *         of the largest one), downscaling keeps the details.
+     */
+    static int select_strike (FT_Face face, int pixel_size) noexcept;
+
+    int phases_for (FT_Face face, int pixel_size) const noexcept
+    {
+        return is_color_face(face) || _mode != render_mode::light ? 1 : phases_for(pixel_size);
+    }
+
+    bool rasterize (FT_Face face, std::uint32_t glyph_index, int pixel_size
+        , int phase, int phases, cached_glyph & out, std::error_code & ec);
+
+    bool rasterize_color (FT_Face face, int pixel_size, int strike_size
+        , cached_glyph & out, std::error_code & ec);
+
+    cached_glyph const * lookup (FT_Face face, std::uint32_t instance
+        , std::uint32_t glyph_index, int pixel_size, int phase, std::error_code & ec);
+
+    fixed26_6 append_quads (FT_Face face, std::uint32_t instance, int pixel_size
+        , shaped_run const & run, fixed26_6 x, fixed26_6 baseline
+        , std::vector<glyph_quad> & out, std::error_code & ec);
+
+public:
+    /**
+     * @param atlas Atlas for glyph bitmaps.
+     * @param phases Number of horizontal subpixel phases (1 to
+     *        @c max_phases), one disables subpixel positioning.
+     * @param max_subpixel_size Largest pixel size positioned with subpixel
+     *        precision.
+     */
+    glyph_cache (glyph_atlas & atlas, int phases = max_phases, int max_subpixel_size = 48)
+        : _atlas(& atlas)
+        , _phases((std::max)(1, (std::min)(phases, int{max_phases})))
+        , _max_subpixel_size(max_subpixel_size)
+    {}
+
+    glyph_atlas & get_atlas () noexcept
+    {
+        return *_atlas;
+    }
+
+    render_mode get_render_mode () const noexcept
+    {
+        return _mode;
+    }
+
+    /**
+     * @brief Sets render mode of glyphs requested after this call (e.g.
+     *        before building quads of a surface).
+     */
+    void set_render_mode (render_mode mode) noexcept
+    {
+        _mode = mode;
+    }
+
+    int get_phases () const noexcept
+    {
+        return _phases;
+    }
+
+    /**
+     * @return Number of subpixel phases used for @a pixel_size.
+     */
+    int phases_for (int pixel_size) const noexcept
+    {
+        return pixel_size <= _max_subpixel_size ? _phases : 1;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _glyphs.size();
+    }
+
+    /**
+     * @brief Removes all glyphs from the cache and the atlas.
+     */
+    void clear ()
+    {
+        _glyphs.clear();
+        _atlas->clear();
+    }
+
+    /**
+     * @brief Splits position @a x into whole pixel @a pixel and the nearest
+     *        of @a phases subpixel phases.
+     *
+     * @return Phase in range [0, phases).
+     */
+    static int select_phase (fixed26_6 x, int phases, int & pixel) noexcept
+    {
+        pixel = x.floor();
+        int frac = x.raw() - pixel * fixed26_6::one;
+        int phase = (frac * phases + fixed26_6::one / 2) / fixed26_6::one;
+
+        if (phase == phases) {
+            ++pixel;
+            phase = 0;
+        }
+
+        return phase;
+    }
+
+    /**
+     * @return Glyph @a glyph_index of @a face of @a pixel_size rasterized
+     *         at @a phase (ignored for color glyphs) or @c nullptr on error.
+     *
+     * @note Variation coordinates currently set to @a face are used as is,
+     *       glyphs of variable fonts are cached per instance by the
+     *       font_instance overload.
+     */
+    cached_glyph const * get (FT_Face face, std::uint32_t glyph_index, int pixel_size
+        , int phase, std::error_code & ec)
+    {
+        return lookup(face, 0, glyph_index, pixel_size, phase, ec);
+    }
+
+    cached_glyph const * get (font_instance const & fi, std::uint32_t glyph_index
+        , int pixel_size, int phase, std::error_code & ec)
+    {
+        if (!fi.activate()) {
+            ec = make_error_code(errc::freetype_error);
+            return nullptr;
+        }
+
+        return lookup(fi.native_handle(), fi.get_id(), glyph_index, pixel_size, phase, ec);
+    }
+
+    cached_glyph const * get (font const & f, std::uint32_t glyph_index, int pixel_size
+        , int phase, std::error_code & ec)
+    {
+        return get(font_instance{f}, glyph_index, pixel_size, phase, ec);
+    }
+
+    /**
+     * @brief Appends quads of @a run shaped with @a face of @a pixel_size to
+     *        @a out, the pen starts at (@a x, @a baseline).
+     *
+     * @return Position of the pen after the run.
+     */
+    fixed26_6 build_quads (FT_Face face, int pixel_size, shaped_run const & run
+        , fixed26_6 x, fixed26_6 baseline, std::vector<glyph_quad> & out
+        , std::error_code & ec)
+    {
+        return append_quads(face, 0, pixel_size, run, x, baseline, out, ec);
+    }
+
+    fixed26_6 build_quads (font_instance const & fi, int pixel_size, shaped_run const & run
+        , fixed26_6 x, fixed26_6 baseline, std::vector<glyph_quad> & out
+        , std::error_code & ec)
+    {
+        if (!fi.activate()) {
+            ec = make_error_code(errc::freetype_error);
+            return x;
+        }
+
+        return append_quads(fi.native_handle(), fi.get_id(), pixel_size, run, x
+            , baseline, out, ec);
+    }
+
+    fixed26_6 build_quads (font const & f, int pixel_size, shaped_run const & run
+        , fixed26_6 x, fixed26_6 baseline, std::vector<glyph_quad> & out
+        , std::error_code & ec)
+    {
+        return build_quads(font_instance{f}, pixel_size, run, x, baseline, out, ec);
+    }
+};
+
+inline int glyph_cache::select_strike (FT_Face face, int pixel_size) noexcept
+{
+    int best = 0;
+    int best_size = 0;
+
+    for (int i = 0; i < face->num_fixed_sizes; i++) {
+        FT_Bitmap_Size const & bs = face->available_sizes[i];
+        int size = bs.y_ppem > 0 ? static_cast<int>((bs.y_ppem + 32) >> 6) : bs.height;
+
+        bool better = best_size < pixel_size
+            ? size > best_size
+            : size >= pixel_size && size < best_size;
+
+        if (i == 0 || better) {
+            best = i;
+            best_size = size;
+        }
+    }
+
+    return best;
+}
+
+inline bool glyph_cache::rasterize_color (FT_Face face, int pixel_size, int strike_size
+    , cached_glyph & out, std::error_code & ec)
+{
+    FT_GlyphSlot slot = face->glyph;
+    FT_Bitmap const & bitmap = slot->bitmap;
+    double scale = static_cast<double>(pixel_size) / strike_size;
+
+    out.bearing_x = static_cast<int>(std::lround(slot->bitmap_left * scale));
+    out.bearing_y = static_cast<int>(std::lround(slot->bitmap_top * scale));
+    out.advance = fixed26_6::from_raw(static_cast<fixed26_6::rep_type>(
+        std::lround(slot->advance.x * scale)));
+
+    if (bitmap.width == 0 || bitmap.rows == 0)
+        return true;
+
+    int width = (std::max)(1, static_cast<int>(std::lround(bitmap.width * scale)));
+    int height = (std::max)(1, static_cast<int>(std::lround(bitmap.rows * scale)));
+
+    resample_bgra(bitmap.buffer, static_cast<int>(bitmap.width)
+        , static_cast<int>(bitmap.rows), bitmap.pitch, width, height, _scratch);
+
+    if (!_atlas->insert(width, height, _scratch.data(), width * 4
+            , atlas_format::rgba, out.region)) {
+        ec = make_error_code(errc::atlas_full);
+        return false;
+    }
+
+    return true;
+}
+
+inline bool glyph_cache::rasterize (FT_Face face, std::uint32_t glyph_index
+    , int pixel_size, int phase, int phases, cached_glyph & out, std::error_code & ec)
+{
+    // Horizontal hinting snaps stems to whole pixels and breaks subpixel
+    // positioning, so phases are used with the light mode only (its hinting
+    // is vertical)
+    FT_Int32 flags = load_flags(_mode) | (phases > 1 ? FT_LOAD_NO_BITMAP : 0);
+    int strike_size = pixel_size;
+    FT_Error rc = 0;
+
+    if (is_color_face(face))
+        flags = FT_LOAD_COLOR;
+
+    if (uses_strikes(face)) {
+        int strike = select_strike(face, pixel_size);
+        rc = FT_Select_Size(face, strike);
+        strike_size = static_cast<int>((face->size->metrics.y_ppem > 0)
+            ? face->size->metrics.y_ppem
+            : face->available_sizes[strike].height);
+    } else {
+        rc = FT_Set_Pixel_Sizes(face, 0, static_cast<FT_UInt>(pixel_size));
+    }
+
+    if (rc != 0 || strike_size <= 0 || FT_Load_Glyph(face, glyph_index, flags) != 0) {
+        ec = make_error_code(errc::freetype_error);
+        return false;
+    }
+
+    FT_GlyphSlot slot = face->glyph;
+    out.region = atlas_region{0, 0, 0, 0, 0};
+
+    // Glyph without a color bitmap in the strike falls back to its outline
+    if (strike_size != pixel_size && slot->format == FT_GLYPH_FORMAT_OUTLINE) {
+        if (FT_Set_Pixel_Sizes(face, 0, static_cast<FT_UInt>(pixel_size)) != 0
+                || FT_Load_Glyph(face, glyph_index, flags | FT_LOAD_NO_BITMAP) != 0) {
+            ec = make_error_code(errc::freetype_error);
+            return false;
+        }
+    }
+
+    if (phase > 0 && slot->format == FT_GLYPH_FORMAT_OUTLINE)
+        FT_Outline_Translate(& slot->outline, phase * fixed26_6::one / phases, 0);
+
+    if (!render_glyph(slot, _mode)) {
+        ec = make_error_code(errc::freetype_error);
+        return false;
+    }
+
+    FT_Bitmap const & bitmap = slot->bitmap;
+
+    if (bitmap.pixel_mode == FT_PIXEL_MODE_BGRA)
+        return rasterize_color(face, pixel_size, strike_size, out, ec);
+
+    out.bearing_x = slot->bitmap_left;
+    out.bearing_y = slot->bitmap_top;
+
+    // Linear advance is in 16.16
+    out.advance = fixed26_6::from_raw(static_cast<fixed26_6::rep_type>(
+        (slot->linearHoriAdvance + 512) >> 10));
+
+    if (bitmap.width == 0 || bitmap.rows == 0)
+        return true;
+
+    int width = 0;
+    int height = 0;
+    int pitch = 0;
+    atlas_format format = atlas_format::coverage;
+    std::uint8_t const * pixels = convert_bitmap(bitmap, _scratch, width, height, pitch, format);
+
+    if (!pixels) {
+        ec = make_error_code(errc::freetype_error);
+        return false;
+    }
+
+    if (width > 0 && height > 0
+            && !_atlas->insert(width, height, pixels, pitch, format, out.region)) {
+        ec = make_error_code(errc::atlas_full);
+        return false;
+    }
+
+    return true;
+}
+
+inline cached_glyph const * glyph_cache::lookup (FT_Face face, std::uint32_t instance
+    , std::uint32_t glyph_index, int pixel_size, int phase, std::error_code & ec)
+{
+    int phases = phases_for(face, pixel_size);
+
+    if (phases == 1)
+        phase = 0;
+
+    key k {face, instance, glyph_index, pixel_size, phase, _mode};
+    auto pos = _glyphs.find(k);
+
+    if (pos != _glyphs.end())
+        return & pos->second;
+
+    cached_glyph g;
+
+    if (!rasterize(face, glyph_index, pixel_size, phase, phases, g, ec))
+        return nullptr;
+
+    return & _glyphs.emplace(k, g).first->second;
+}
+
+inline fixed26_6 glyph_cache::append_quads (FT_Face face, std::uint32_t instance
+    , int pixel_size, shaped_run const & run, fixed26_6 x, fixed26_6 baseline
+    , std::vector<glyph_quad> & out, std::error_code & ec)
+{
+    int phases = phases_for(face, pixel_size);
+    float iw = 1.0f / _atlas->get_width();
+    float ih = 1.0f / _atlas->get_height();
+
+    out.reserve(out.size() + run.glyphs.size());
+
+    for (auto const & sg: run.glyphs) {
+        int pixel = 0;
+        int phase = select_phase(x + sg.x_offset, phases, pixel);
+        cached_glyph const * g = lookup(face, instance, sg.glyph_index, pixel_size, phase, ec);
+
+        if (!g)
+            return x;
+
+        if (g->region.width > 0) {
+            // Vertical position is snapped to whole pixels
+            float left = static_cast<float>(pixel + g->bearing_x);
+            float top = static_cast<float>((baseline - sg.y_offset).round() - g->bearing_y);
+
+            out.push_back(glyph_quad{left, top
+                , left + g->region.width, top + g->region.height
+                , g->region.x * iw, g->region.y * ih
+                , (g->region.x + g->region.width) * iw
+                , (g->region.y + g->region.height) * ih
+                , g->region.page});
+        }
+
+        x += sg.x_advance;
+    }
+
+    return x;
+}
+
+}} // namespace pfs::griotte
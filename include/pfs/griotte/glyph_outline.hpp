@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.09 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/path.hpp"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Glyph outline in font units (y axis points up).
+ */
+using outline_path = path<float>;
+
+namespace details {
+
+struct outline_decomposer
+{
+    outline_path * out;
+    bool started;
+
+    static point<float> to_point (FT_Vector const * v) noexcept
+    {
+        return point<float>{static_cast<float>(v->x), static_cast<float>(v->y)};
+    }
+
+    static int move_to (FT_Vector const * to, void * user)
+    {
+        auto self = static_cast<outline_decomposer *>(user);
+
+        // Contours of an outline are closed
+        if (self->started)
+            self->out->close_path();
+
+        self->out->move_to(to_point(to));
+        self->started = true;
+        return 0;
+    }
+
+    static int line_to (FT_Vector const * to, void * user)
+    {
+        static_cast<outline_decomposer *>(user)->out->line_to(to_point(to));
+        return 0;
+    }
+
+    // TrueType conics are converted into cubic curves by path (degree
+    // elevation)
+    static int conic_to (FT_Vector const * control, FT_Vector const * to, void * user)
+    {
+        static_cast<outline_decomposer *>(user)->out->curve_to(to_point(control), to_point(to));
+        return 0;
+    }
+
+    static int cubic_to (FT_Vector const * c1, FT_Vector const * c2, FT_Vector const * to
+        , void * user)
+    {
+        static_cast<outline_decomposer *>(user)->out->curve_to(to_point(c1), to_point(c2)
+            , to_point(to));
+        return 0;
+    }
+};
+
+// Integer coordinates are rounded to the nearest integer
+template <typename UnitT>
+inline UnitT outline_unit (double v, std::true_type /*is_integral*/) noexcept
+{
+    return static_cast<UnitT>(std::lround(v));
+}
+
+template <typename UnitT>
+inline UnitT outline_unit (double v, std::false_type /*is_integral*/) noexcept
+{
+    return static_cast<UnitT>(v);
+}
+
+} // namespace details
+
+/**
+ * @brief Appends contours of @a outline to @a out as closed subpaths
+ *        (coordinates are not transformed).
+ *
+ * @return @c false on error.
+ */
+inline bool decompose_outline (FT_Outline & outline, outline_path & out)
+{
+    FT_Outline_Funcs funcs;
+    funcs.move_to  = & details::outline_decomposer::move_to;
+    funcs.line_to  = & details::outline_decomposer::line_to;
+    funcs.conic_to = & details::outline_decomposer::conic_to;
+    funcs.cubic_to = & details::outline_decomposer::cubic_to;
+    funcs.shift = 0;
+    funcs.delta = 0;
+
+    details::outline_decomposer d {& out, false};
+
+    if (FT_Outline_Decompose(& outline, & funcs, & d) != 0)
+        return false;
+
+    if (d.started)
+        out.close_path();
+
+    return true;
+}
+
+/**
+ * @brief Loads unscaled and unhinted outline of glyph @a glyph_index of
+ *        @a face into @a out (in font units).
+ *
+ * @return @c false if the glyph cannot be loaded or has no outline (e.g.
+ *         bitmap fonts).
+ */
+inline bool load_outline (FT_Face face, std::uint32_t glyph_index, outline_path & out)
+{
+    if (FT_Load_Glyph(face, glyph_index, FT_LOAD_NO_SCALE | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP) != 0)
+        return false;
+
+    if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+        return false;
+
+    return decompose_outline(face->glyph->outline, out);
+}
+
+/**
+ * @brief Converts @a outline in font units into a path in pixels by
+ *        @a scale (pixels per font unit) with the origin at the pen
+ *        position on the baseline and the y axis pointing down.
+ */
+template <typename UnitT>
+path<UnitT> scale_outline (outline_path const & outline, double scale)
+{
+    using point_type = point<UnitT>;
+
+    auto convert = [scale] (point<float> const & p) {
+        return point_type{
+              details::outline_unit<UnitT>(p.x() * scale, std::is_integral<UnitT>{})
+            , details::outline_unit<UnitT>(-p.y() * scale, std::is_integral<UnitT>{})};
+    };
+
+    path<UnitT> result;
+    result.reserve(outline.size());
+
+    for (auto it = outline.cbegin(); it != outline.cend(); ++it) {
+        switch (it->type) {
+            case path_entry_enum::move_to:
+                result.move_to(convert(it->p));
+                break;
+
+            case path_entry_enum::line_to:
+                result.line_to(convert(it->p));
+                break;
+
+            case path_entry_enum::curve_to: {
+                // Cubic curve entries are stored as triples
+                auto c1 = convert(it->p);
+                auto c2 = convert((++it)->p);
+                auto ep = convert((++it)->p);
+                result.curve_to(c1, c2, ep);
+                break;
+            }
+
+            case path_entry_enum::close_path:
+                result.close_path();
+                break;
+        }
+    }
+
+    return result;
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.27 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/color.hpp"
+#include "pfs/griotte/rect.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class image
+ * @brief RGBA image in memory (8 bits per channel, non-premultiplied alpha),
+ *        render target of the software rasterizer.
+ *
+ * Pixel is packed into 32-bit word as R | G << 8 | B << 16 | A << 24, i.e.
+ * bytes are in RGBA order on little-endian platforms.
+ */
+class image
+{
+    int _width {0};
+    int _height {0};
+    std::vector<std::uint32_t> _pixels;
+
+public:
+    static std::uint32_t pack (color const & c) noexcept
+    {
+        return static_cast<std::uint32_t>(c.get_red())
+            | static_cast<std::uint32_t>(c.get_green()) << 8
+            | static_cast<std::uint32_t>(c.get_blue()) << 16
+            | static_cast<std::uint32_t>(c.get_alpha()) << 24;
+    }
+
+    static color unpack (std::uint32_t px) noexcept
+    {
+        return color{static_cast<int>(px & 0xFF)
+            , static_cast<int>((px >> 8) & 0xFF)
+            , static_cast<int>((px >> 16) & 0xFF)
+            , static_cast<int>(px >> 24)};
+    }
+
+public:
+    image () = default;
+
+    image (int width, int height, color const & background = color{0, 0, 0, 0})
+        : _width((std::max)(width, 0))
+        , _height((std::max)(height, 0))
+        , _pixels(static_cast<std::size_t>(_width) * _height, pack(background))
+    {}
+
+    int get_width () const noexcept
+    {
+        return _width;
+    }
+
+    int get_height () const noexcept
+    {
+        return _height;
+    }
+
+    rect<int> get_rect () const noexcept
+    {
+        return rect<int>{0, 0, _width, _height};
+    }
+
+    std::uint32_t * data () noexcept
+    {
+        return _pixels.data();
+    }
+
+    std::uint32_t const * data () const noexcept
+    {
+        return _pixels.data();
+    }
+
+    /**
+     * @return Pointer to the first pixel of the row @a y.
+     */
+    std::uint32_t * scanline (int y) noexcept
+    {
+        return _pixels.data() + static_cast<std::size_t>(y) * _width;
+    }
+
+    std::uint32_t const * scanline (int y) const noexcept
+    {
+        return _pixels.data() + static_cast<std::size_t>(y) * _width;
+    }
+
+    color get_pixel (int x, int y) const noexcept
+    {
+        return unpack(scanline(y)[x]);
+    }
+
+    void set_pixel (int x, int y, color const & c) noexcept
+    {
+        scanline(y)[x] = pack(c);
+    }
+
+    void fill (color const & c)
+    {
+        std::fill(_pixels.begin(), _pixels.end(), pack(c));
+    }
+};
+
+}} // namespace pfs::griotte
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/small_function.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class job_system
+ * @brief Thread pool with work stealing for short CPU-bound jobs
+ *        (tessellation, rasterization, etc).
+ *
+ * Every worker has its own job queue. A worker takes jobs from the back of
+ * its own queue (the most recently submitted, still hot in cache) and steals
+ * from the front of other queues when its own queue is empty. A thread
+ * waiting for jobs completion runs pending jobs instead of blocking.
+ */
+class job_system
+{
+public:
+    using job_type = small_function<void ()>;
+
+private:
+    struct job_queue
+    {
+        std::mutex mtx;
+        std::deque<job_type> jobs;
+    };
+
+    struct worker_info
+    {
+        job_system const * owner;
+        std::size_t index;
+    };
+
+    // Queue with index 0 is for threads external to the pool
+    std::vector<std::unique_ptr<job_queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::atomic<std::size_t> _pending {0};
+    std::atomic<std::size_t> _next {0};
+    bool _stop {false};
+
+private:
+    static worker_info & current_worker ()
+    {
+        static thread_local worker_info info {nullptr, 0};
+        return info;
+    }
+
+    std::size_t current_index () const
+    {
+        worker_info const & info = current_worker();
+        return info.owner == this ? info.index : 0;
+    }
+
+    bool take (std::size_t index, job_type & job)
+    {
+        // Own queue first (LIFO) ...
+        {
+            job_queue & q = *_queues[index];
+            std::lock_guard<std::mutex> lock(q.mtx);
+
+            if (!q.jobs.empty()) {
+                job = std::move(q.jobs.back());
+                q.jobs.pop_back();
+                return true;
+            }
+        }
+
+        // ... then steal from others (FIFO)
+        for (std::size_t i = 1; i < _queues.size(); i++) {
+            job_queue & q = *_queues[(index + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(q.mtx);
+
+            if (!q.jobs.empty()) {
+                job = std::move(q.jobs.front());
+                q.jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void worker_loop (std::size_t index)
+    {
+        current_worker() = worker_info{this, index};
+        job_type job;
+
+        for (;;) {
+            if (take(index, job)) {
+                _pending.fetch_sub(1, std::memory_order_acq_rel);
+                job();
+                job.reset();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mtx);
+            _cv.wait(lock, [this] {
+                return _stop || _pending.load(std::memory_order_acquire) > 0;
+            });
+
+            if (_stop)
+                break;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs job system with @a nthreads worker threads (by default
+     *        one less than the number of hardware threads, since the thread
+     *        waiting for jobs completion runs jobs too).
+     */
+    job_system (unsigned int nthreads = (std::max)(std::thread::hardware_concurrency(), 2u) - 1)
+    {
+        _queues.reserve(nthreads + 1);
+
+        for (unsigned int i = 0; i <= nthreads; i++)
+            _queues.emplace_back(new job_queue);
+
+        _threads.reserve(nthreads);
+
+        for (unsigned int i = 0; i < nthreads; i++)
+            _threads.emplace_back(& job_system::worker_loop, this, i + 1);
+    }
+
+    ~job_system ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+
+        _cv.notify_all();
+
+        for (auto & t: _threads)
+            t.join();
+    }
+
+    job_system (job_system const &) = delete;
+    job_system & operator = (job_system const &) = delete;
+
+    /**
+     * @return Number of worker threads.
+     */
+    std::size_t thread_count () const noexcept
+    {
+        return _threads.size();
+    }
+
+    /**
+     * @brief Submits job @a f for execution by any worker.
+     */
+    template <typename F>
+    void submit (F && f)
+    {
+        std::size_t index = current_index();
+
+        // External threads distribute jobs between workers queues
+        if (index == 0 && !_threads.empty())
+            index = 1 + _next.fetch_add(1, std::memory_order_relaxed) % _threads.size();
+
+        {
+            job_queue & q = *_queues[index];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            q.jobs.emplace_back(std::forward<F>(f));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _pending.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        _cv.notify_one();
+    }
+
+    /**
+     * @brief Runs pending jobs until @a counter becomes zero.
+     */
+    void wait (std::atomic<std::size_t> const & counter)
+    {
+        std::size_t index = current_index();
+        job_type job;
+
+        while (counter.load(std::memory_order_acquire) > 0) {
+            if (take(index, job)) {
+                _pending.fetch_sub(1, std::memory_order_acq_rel);
+                job();
+                job.reset();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Calls @a f (with signature 'void (std::size_t first, std::size_t last)')
+     *        for ranges of at most @a grain indices covering [0, @a count)
+     *        in parallel and waits for completion.
+     */
+    template <typename F>
+    void parallel_for (std::size_t count, std::size_t grain, F && f)
+    {
+        if (count == 0)
+            return;
+
+        grain = (std::max)(grain, std::size_t{1});
+
+        if (count <= grain || _threads.empty()) {
+            f(std::size_t{0}, count);
+            return;
+        }
+
+        std::size_t njobs = (count + grain - 1) / grain;
+        std::atomic<std::size_t> counter {njobs};
+        auto * pf = & f;
+
+        // The calling thread takes the first range itself
+        for (std::size_t j = 1; j < njobs; j++) {
+            std::size_t first = j * grain;
+            std::size_t last = (std::min)(first + grain, count);
+
+            submit([pf, first, last, & counter] {
+                (*pf)(first, last);
+                counter.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+
+        f(std::size_t{0}, grain);
+        counter.fetch_sub(1, std::memory_order_acq_rel);
+
+        wait(counter);
+    }
+};
+
+}} // namespace pfs::griotte
@@ -1,9 +1,321 @@
 #pragma once
+#include <pfs/griotte/indents.hpp>
+#include <pfs/griotte/rect.hpp>
+#include <pfs/griotte/size.hpp>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+//
+// Layout is performed in two passes:
+//      1. measure - bottom-up calculation of the preferred size of each item;
+//      2. arrange - top-down assignment of the geometry to each item.
+//
+// Both results are cached per item. Changing of an item property invalidates
+// the item and its ancestors only, so the next measure pass re-measures the
+// invalidated chain (siblings return the cached measurement) and the next
+// arrange pass skips subtrees which geometry is unchanged.
+//
 
 namespace pfs {
 namespace griotte {
 
-class layout
-{};
+template <typename UnitT>
+class layout;
+
+template <typename UnitT>
+class layout_item
+{
+    friend class layout<UnitT>;
+
+public:
+    using unit_type    = UnitT;
+    using size_type    = size<unit_type>;
+    using rect_type    = rect<unit_type>;
+    using margins_type = margins<unit_type>;
+
+private:
+    layout<UnitT> * _parent {nullptr};
+    margins_type _margins;
+    size_type    _size_hint;
+    int          _stretch {0};
+    rect_type    _geometry;
+    size_type    _measured;
+    bool         _measure_valid {false};
+    bool         _arrange_valid {false};
+
+public:
+    layout_item () = default;
+
+    layout_item (size_type const & size_hint)
+        : _size_hint(size_hint)
+    {}
+
+    /**
+     * @brief Detaches the item (also a nested layout) from its parent, so
+     *        an item may be destroyed before the layout.
+     */
+    virtual ~layout_item ()
+    {
+        if (_parent)
+            _parent->remove_item(this);
+    }
+
+    layout_item (layout_item const &) = delete;
+    layout_item & operator = (layout_item const &) = delete;
+
+    layout<UnitT> * get_parent () const noexcept
+    {
+        return _parent;
+    }
+
+    margins_type const & get_margins () const noexcept
+    {
+        return _margins;
+    }
+
+    void set_margins (margins_type const & m)
+    {
+        _margins = m;
+        invalidate();
+    }
+
+    /**
+     * @return Preferred size of the item (without margins).
+     */
+    size_type const & get_size_hint () const noexcept
+    {
+        return _size_hint;
+    }
+
+    void set_size_hint (size_type const & s)
+    {
+        if (_size_hint != s) {
+            _size_hint = s;
+            invalidate();
+        }
+    }
+
+    /**
+     * @return Stretch factor of the item. Free space of the parent layout
+     *         is distributed between items proportionally to their stretch
+     *         factors. Items with zero stretch factor keep measured size.
+     */
+    int get_stretch () const noexcept
+    {
+        return _stretch;
+    }
+
+    void set_stretch (int stretch)
+    {
+        if (_stretch != stretch) {
+            _stretch = stretch;
+            invalidate();
+        }
+    }
+
+    /**
+     * @return Geometry assigned to the item by the last arrange pass.
+     */
+    rect_type const & get_geometry () const noexcept
+    {
+        return _geometry;
+    }
+
+    /**
+     * @return @c true if the cached measurement is valid.
+     */
+    bool is_measure_valid () const noexcept
+    {
+        return _measure_valid;
+    }
+
+    /**
+     * @return @c true if the item needs no arrange pass.
+     */
+    bool is_arrange_valid () const noexcept
+    {
+        return _arrange_valid;
+    }
+
+    /**
+     * @brief Invalidates cached measurement of the item and its ancestors.
+     */
+    void invalidate ();
+
+    /**
+     * @return Preferred size of the item (without margins). Cached result is
+     *         returned if the item is not invalidated since last call.
+     */
+    size_type const & measure ()
+    {
+        if (!_measure_valid) {
+            _measured = do_measure();
+            _measure_valid = true;
+        }
+
+        return _measured;
+    }
+
+    /**
+     * @brief Assigns geometry @a r to the item and arranges its children.
+     *        Does nothing if geometry is unchanged and the item is not
+     *        invalidated since last call.
+     */
+    void arrange (rect_type const & r)
+    {
+        if (_arrange_valid && _geometry == r)
+            return;
+
+        _geometry = r;
+        measure();
+        do_arrange(r);
+        _arrange_valid = true;
+    }
+
+protected:
+    /**
+     * @brief Calculates preferred size of the item. Default implementation
+     *        returns the size hint.
+     */
+    virtual size_type do_measure ()
+    {
+        return _size_hint;
+    }
+
+    /**
+     * @brief Arranges content of the item inside @a r.
+     */
+    virtual void do_arrange (rect_type const & /*r*/)
+    {}
+};
+
+template <typename UnitT>
+class layout : public layout_item<UnitT>
+{
+    using base_class = layout_item<UnitT>;
+
+public:
+    using unit_type     = UnitT;
+    using item_type     = layout_item<UnitT>;
+    using size_type     = typename base_class::size_type;
+    using rect_type     = typename base_class::rect_type;
+    using paddings_type = paddings<unit_type>;
+
+private:
+    std::vector<item_type *> _items; // not owned
+    paddings_type _paddings;
+    unit_type     _spacing {0};
+
+public:
+    layout () = default;
+
+    ~layout ()
+    {
+        // Children outlive the layout, the layout itself is detached from
+        // its parent by ~layout_item()
+        for (auto item: _items)
+            item->_parent = nullptr;
+    }
+
+    paddings_type const & get_paddings () const noexcept
+    {
+        return _paddings;
+    }
+
+    void set_paddings (paddings_type const & p)
+    {
+        _paddings = p;
+        this->invalidate();
+    }
+
+    /**
+     * @return Spacing between the items.
+     */
+    unit_type get_spacing () const noexcept
+    {
+        return _spacing;
+    }
+
+    void set_spacing (unit_type spacing)
+    {
+        if (_spacing != spacing) {
+            _spacing = spacing;
+            this->invalidate();
+        }
+    }
+
+    std::size_t count () const noexcept
+    {
+        return _items.size();
+    }
+
+    item_type * item_at (std::size_t index) const
+    {
+        assert(index < _items.size());
+        return _items[index];
+    }
+
+    /**
+     * @brief Adds @a item to the end of this layout.
+     * @note Layout does not take ownership of the item.
+     */
+    void add_item (item_type * item)
+    {
+        assert(item && item->_parent == nullptr);
+        item->_parent = this;
+        _items.push_back(item);
+        on_item_added(_items.size() - 1);
+        item->invalidate();
+    }
+
+    /**
+     * @brief Removes @a item from this layout.
+     */
+    void remove_item (item_type * item)
+    {
+        auto pos = std::find(_items.begin(), _items.end(), item);
+
+        if (pos != _items.end()) {
+            auto index = static_cast<std::size_t>(pos - _items.begin());
+            _items.erase(pos);
+            item->_parent = nullptr;
+            on_item_removed(index);
+            this->invalidate();
+        }
+    }
+
+protected:
+    /**
+     * @brief Called after an item is added at @a index (derived layouts
+     *        keep per-item data in sync with items()).
+     */
+    virtual void on_item_added (std::size_t /*index*/)
+    {}
+
+    /**
+     * @brief Called after the item at @a index is removed.
+     */
+    virtual void on_item_removed (std::size_t /*index*/)
+    {}
+
+    std::vector<item_type *> const & items () const noexcept
+    {
+        return _items;
+    }
+};
+
+template <typename UnitT>
+void layout_item<UnitT>::invalidate ()
+{
+    // Ancestors of an invalidated item are invalidated already
+    for (layout_item * item = this; item; item = item->_parent) {
+        if (!item->_measure_valid && !item->_arrange_valid && item != this)
+            break;
+
+        item->_measure_valid = false;
+        item->_arrange_valid = false;
+    }
+}
 
 }} // namespace pfs::griotte
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.05 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Line breaking classes of Unicode Standard Annex #14 (the subset
+ *        used by line_break_action()).
+ */
+enum class line_break_class : std::uint8_t
+{
+      al ///< Ordinary alphabetic and symbol characters
+    , bk ///< Mandatory break (FF, VT, NEL, LS, PS)
+    , cr ///< Carriage return
+    , lf ///< Line feed
+    , sp ///< Space
+    , zw ///< Zero width space
+    , wj ///< Word joiner and non-breaking glue (NBSP, NNBSP)
+    , cm ///< Combining marks
+    , op ///< Opening punctuation
+    , cl ///< Closing punctuation
+    , cp ///< Closing parenthesis
+    , ex ///< Exclamation and interrogation
+    , is ///< Infix numeric separator
+    , sy ///< Symbols allowing break after (solidus)
+    , qu ///< Quotation marks
+    , hy ///< Hyphen-minus
+    , ba ///< Break after (tab, hyphens, dashes)
+    , nu ///< Digits
+    , id ///< Ideographs (break before and after)
+};
+
+enum class line_break : std::uint8_t
+{
+      prohibited
+    , allowed
+    , mandatory
+};
+
+/**
+ * @return Line breaking class of code point @a cp.
+ */
+inline line_break_class line_break_class_of (char32_t cp) noexcept
+{
+    using c = line_break_class;
+
+    if (cp < 0x80) {
+        switch (cp) {
+            case '\n': return c::lf;
+            case '\r': return c::cr;
+            case 0x0B: case 0x0C: return c::bk;
+            case '\t': return c::ba;
+            case ' ': return c::sp;
+            case '(': case '[': case '{': return c::op;
+            case ')': case ']': return c::cp;
+            case '}': return c::cl;
+            case '!': case '?': return c::ex;
+            case ',': case '.': case ':': case ';': return c::is;
+            case '/': return c::sy;
+            case '"': case '\'': return c::qu;
+            case '-': return c::hy;
+            default:
+                break;
+        }
+
+        return (cp >= '0' && cp <= '9') ? c::nu : c::al;
+    }
+
+    switch (cp) {
+        case 0x0085: case 0x2028: case 0x2029: return c::bk;
+        case 0x200B: return c::zw;
+        case 0x00A0: case 0x202F: case 0x2060: case 0xFEFF: return c::wj;
+        case 0x00AD: case 0x2010: case 0x2012: case 0x2013: return c::ba;
+        case 0x00AB: case 0x00BB: case 0x2018: case 0x2019: case 0x201C: case 0x201D:
+            return c::qu;
+        case 0x3008: case 0x300A: case 0x300C: case 0x300E: case 0x3010: case 0xFF08:
+            return c::op;
+        case 0x3001: case 0x3002: case 0x3009: case 0x300B: case 0x300D: case 0x300F:
+        case 0x3011: case 0xFF0C: case 0xFF0E:
+            return c::cl;
+        case 0xFF09: return c::cp;
+        default:
+            break;
+    }
+
+    if ((cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x1AB0 && cp <= 0x1AFF)
+            || (cp >= 0x1DC0 && cp <= 0x1DFF) || (cp >= 0x20D0 && cp <= 0x20FF)
+            || (cp >= 0xFE00 && cp <= 0xFE0F) || (cp >= 0xFE20 && cp <= 0xFE2F)
+            || cp == 0x200C || cp == 0x200D) {
+        return c::cm;
+    }
+
+    if (cp >= 0x0660 && cp <= 0x0669)
+        return c::nu;
+
+    if ((cp >= 0x2E80 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7AF)
+            || (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0xFF01 && cp <= 0xFF60)
+            || (cp >= 0x1F300 && cp <= 0x1FAFF) || (cp >= 0x20000 && cp <= 0x3FFFD)) {
+        return c::id;
+    }
+
+    return c::al;
+}
+
+/**
+ * @brief Line break action between the code points of classes
+ *        @a classes[i - 1] and @a classes[i] (0 < i < count).
+ *
+ * Implements the rules of UAX #14 for the classes of line_break_class
+ * (tailored: combining marks take the class of the base, non-breaking
+ * glue is treated as a word joiner, numeric prefixes and postfixes are
+ * not distinguished).
+ */
+inline line_break line_break_action (line_break_class const * classes, std::size_t i) noexcept
+{
+    using c = line_break_class;
+
+    c b = classes[i];
+
+    // LB4, LB5: always break after hard line breaks, but not within CR LF
+    if (classes[i - 1] == c::cr)
+        return b == c::lf ? line_break::prohibited : line_break::mandatory;
+
+    if (classes[i - 1] == c::bk || classes[i - 1] == c::lf)
+        return line_break::mandatory;
+
+    // LB6, LB7: do not break before hard line breaks, spaces and zero width space
+    if (b == c::bk || b == c::cr || b == c::lf || b == c::sp || b == c::zw)
+        return line_break::prohibited;
+
+    // LB9, LB10: combining marks attach to the base (or are alphabetic)
+    if (b == c::cm)
+        return line_break::prohibited;
+
+    std::size_t j = i - 1;
+
+    while (j > 0 && classes[j] == c::cm)
+        --j;
+
+    c a = classes[j] == c::cm ? c::al : classes[j];
+
+    // Class before spaces
+    std::size_t k = j;
+
+    while (k > 0 && classes[k] == c::sp)
+        --k;
+
+    c before_spaces = classes[k];
+
+    // LB8: break before any character following a zero width space
+    if (before_spaces == c::zw)
+        return line_break::allowed;
+
+    // LB11, LB12: do not break around word joiners and glue
+    if (a == c::wj || b == c::wj)
+        return line_break::prohibited;
+
+    // LB13: do not break before closing punctuation and separators
+    if (b == c::cl || b == c::cp || b == c::ex || b == c::is || b == c::sy)
+        return line_break::prohibited;
+
+    // LB14: do not break after opening punctuation (even after spaces)
+    if (before_spaces == c::op)
+        return line_break::prohibited;
+
+    // LB18: break after spaces
+    if (a == c::sp)
+        return line_break::allowed;
+
+    // LB19: do not break around quotation marks
+    if (a == c::qu || b == c::qu)
+        return line_break::prohibited;
+
+    // LB21: do not break before hyphens
+    if (b == c::ba || b == c::hy)
+        return line_break::prohibited;
+
+    // LB25 (simplified): do not break numbers
+    if (b == c::nu && (a == c::hy || a == c::is || a == c::sy || a == c::nu))
+        return line_break::prohibited;
+
+    // LB23, LB28, LB29, LB30: do not break within words
+    if ((a == c::al || a == c::nu || a == c::is) && (b == c::al || b == c::nu))
+        return line_break::prohibited;
+
+    if ((a == c::al || a == c::nu) && b == c::op)
+        return line_break::prohibited;
+
+    if (a == c::cp && (b == c::al || b == c::nu))
+        return line_break::prohibited;
+
+    // LB31: break everywhere else
+    return line_break::allowed;
+}
+
+}} // namespace pfs::griotte
@@ -1,11 +1,195 @@
 #pragma once
-#include <list>
+#include <pfs/griotte/constants.hpp>
 #include <pfs/griotte/layout.hpp>
+#include <pfs/griotte/point.hpp>
 
 namespace pfs {
 namespace griotte {
 
-class linear_layout : public layout
-{};
+/**
+ * @class linear_layout
+ * @brief Lines up items horizontally or vertically.
+ */
+template <typename UnitT>
+class linear_layout : public layout<UnitT>
+{
+    using base_class = layout<UnitT>;
 
-}}
+public:
+    using unit_type  = UnitT;
+    using item_type  = typename base_class::item_type;
+    using size_type  = typename base_class::size_type;
+    using rect_type  = typename base_class::rect_type;
+    using point_type = point<unit_type>;
+
+private:
+    orientation _orientation;
+
+public:
+    linear_layout (orientation o = orientation::horizontal)
+        : _orientation(o)
+    {}
+
+    orientation get_orientation () const noexcept
+    {
+        return _orientation;
+    }
+
+    void set_orientation (orientation o)
+    {
+        if (_orientation != o) {
+            _orientation = o;
+            this->invalidate();
+        }
+    }
+
+protected:
+    size_type do_measure () override;
+    void do_arrange (rect_type const & r) override;
+
+private:
+    bool horizontal () const noexcept
+    {
+        return _orientation == orientation::horizontal;
+    }
+
+    // Size along the layout direction
+    unit_type main_size (size_type const & s) const noexcept
+    {
+        return horizontal() ? s.get_width() : s.get_height();
+    }
+
+    // Size across the layout direction
+    unit_type cross_size (size_type const & s) const noexcept
+    {
+        return horizontal() ? s.get_height() : s.get_width();
+    }
+
+    unit_type main_margins (item_type const & item) const noexcept
+    {
+        auto const & m = item.get_margins();
+        return horizontal()
+            ? m.get_left() + m.get_right()
+            : m.get_top() + m.get_bottom();
+    }
+
+    unit_type cross_margins (item_type const & item) const noexcept
+    {
+        auto const & m = item.get_margins();
+        return horizontal()
+            ? m.get_top() + m.get_bottom()
+            : m.get_left() + m.get_right();
+    }
+};
+
+template <typename UnitT>
+typename linear_layout<UnitT>::size_type
+linear_layout<UnitT>::do_measure ()
+{
+    auto const & items = this->items();
+    auto const & p = this->get_paddings();
+
+    unit_type main {0};
+    unit_type cross {0};
+
+    for (auto item: items) {
+        // Returns cached result for items not invalidated
+        size_type const & s = item->measure();
+
+        main += main_size(s) + main_margins(*item);
+
+        unit_type c = cross_size(s) + cross_margins(*item);
+
+        if (c > cross)
+            cross = c;
+    }
+
+    if (items.size() > 1)
+        main += this->get_spacing() * static_cast<unit_type>(items.size() - 1);
+
+    if (horizontal()) {
+        return size_type{main + p.get_left() + p.get_right()
+            , cross + p.get_top() + p.get_bottom()};
+    }
+
+    return size_type{cross + p.get_left() + p.get_right()
+        , main + p.get_top() + p.get_bottom()};
+}
+
+template <typename UnitT>
+void linear_layout<UnitT>::do_arrange (rect_type const & r)
+{
+    auto const & items = this->items();
+
+    if (items.empty())
+        return;
+
+    auto const & p = this->get_paddings();
+    size_type const & measured = this->measure();
+
+    unit_type avail_main = horizontal()
+        ? r.get_width() - p.get_left() - p.get_right()
+        : r.get_height() - p.get_top() - p.get_bottom();
+
+    unit_type avail_cross = horizontal()
+        ? r.get_height() - p.get_top() - p.get_bottom()
+        : r.get_width() - p.get_left() - p.get_right();
+
+    unit_type content_main = horizontal()
+        ? measured.get_width() - p.get_left() - p.get_right()
+        : measured.get_height() - p.get_top() - p.get_bottom();
+
+    // Free space is distributed between stretchable items only
+    unit_type extra = avail_main - content_main;
+    int total_stretch = 0;
+
+    for (auto item: items)
+        total_stretch += item->get_stretch();
+
+    if (extra < 0 || total_stretch == 0)
+        extra = 0;
+
+    unit_type pos = horizontal()
+        ? r.get_x() + p.get_left()
+        : r.get_y() + p.get_top();
+
+    unit_type cross_pos = horizontal()
+        ? r.get_y() + p.get_top()
+        : r.get_x() + p.get_left();
+
+    unit_type distributed {0};
+    int stretch_seen = 0;
+
+    for (auto item: items) {
+        auto const & m = item->get_margins();
+        unit_type item_main = main_size(item->measure());
+
+        if (extra > 0 && item->get_stretch() > 0) {
+            stretch_seen += item->get_stretch();
+
+            // Last stretchable item receives the rounding remainder
+            unit_type share = stretch_seen == total_stretch
+                ? extra - distributed
+                : extra * item->get_stretch() / total_stretch;
+
+            distributed += share;
+            item_main += share;
+        }
+
+        unit_type item_cross = avail_cross - cross_margins(*item);
+
+        if (horizontal()) {
+            pos += m.get_left();
+            item->arrange(rect_type{pos, cross_pos + m.get_top(), item_main, item_cross});
+            pos += item_main + m.get_right();
+        } else {
+            pos += m.get_top();
+            item->arrange(rect_type{cross_pos + m.get_left(), pos, item_cross, item_main});
+            pos += item_main + m.get_bottom();
+        }
+
+        pos += this->get_spacing();
+    }
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,436 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.01 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/path.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class path_simplifier
+ * @brief Level-of-detail stage simplifying polylines by Ramer-Douglas-Peucker
+ *        algorithm.
+ *
+ * Vertices are appended by move_to() and line_to(). Output keeps every
+ * input vertex within the tolerance from the simplified polyline. For pixel
+ * tolerance pass the tolerance in pixels divided by the view scale.
+ *
+ * Simplification is incremental: vertices that cannot be changed by new
+ * samples are committed, only the uncommitted tail is simplified again.
+ * The tail is committed forcibly when it exceeds @a window vertices, so
+ * the cost of appending is bounded for any input.
+ */
+template <typename UnitT>
+class path_simplifier
+{
+public:
+    using unit_type  = UnitT;
+    using point_type = point<unit_type>;
+    using entry      = path_entry<unit_type>;
+
+private:
+    double _tolerance;
+    std::size_t _window;
+    std::vector<entry> _entries;    // committed output
+    std::vector<point_type> _tail;  // input since the last committed vertex
+    std::vector<std::size_t> _kept; // scratch: kept tail vertices
+    std::vector<std::pair<std::size_t, std::size_t>> _stack; // scratch
+    std::size_t _input_count {0};
+
+private:
+    static double distance2 (point_type const & p
+        , point_type const & a
+        , point_type const & b)
+    {
+        double dx = static_cast<double>(b.x()) - a.x();
+        double dy = static_cast<double>(b.y()) - a.y();
+        double px = static_cast<double>(p.x()) - a.x();
+        double py = static_cast<double>(p.y()) - a.y();
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? (px * dx + py * dy) / len2 : 0;
+
+        t = (std::min)((std::max)(t, 0.0), 1.0);
+        px -= t * dx;
+        py -= t * dy;
+
+        return px * px + py * py;
+    }
+
+    /**
+     * @brief Simplifies the tail into _kept (sorted indices of kept
+     *        vertices, including the first and the last).
+     */
+    void simplify_tail ();
+
+    /**
+     * @brief Commits vertices of the simplified tail, except the last one if
+     *        @a all is @c false.
+     */
+    void commit (bool all);
+
+public:
+    /**
+     * @param tolerance Maximum distance (in units) between input vertices
+     *        and the simplified polyline.
+     * @param window Maximum number of uncommitted vertices.
+     */
+    path_simplifier (double tolerance = 0.5, std::size_t window = 4096)
+        : _tolerance(tolerance)
+        , _window((std::max)(window, std::size_t{3}))
+    {}
+
+    double get_tolerance () const noexcept
+    {
+        return _tolerance;
+    }
+
+    /**
+     * @brief Sets tolerance for vertices appended after this call.
+     */
+    void set_tolerance (double tolerance) noexcept
+    {
+        _tolerance = tolerance;
+    }
+
+    /**
+     * @return Number of input vertices.
+     */
+    std::size_t input_count () const noexcept
+    {
+        return _input_count;
+    }
+
+    /**
+     * @return Number of committed output vertices.
+     */
+    std::size_t committed_count () const noexcept
+    {
+        return _entries.size();
+    }
+
+    void clear ()
+    {
+        _entries.clear();
+        _tail.clear();
+        _input_count = 0;
+    }
+
+    /**
+     * @brief Starts a new polyline at @a p.
+     */
+    void move_to (point_type const & p)
+    {
+        if (!_tail.empty())
+            commit(true);
+
+        _entries.emplace_back(path_entry_enum::move_to, p);
+        _tail.clear();
+        _tail.push_back(p);
+        ++_input_count;
+    }
+
+    /**
+     * @brief Appends vertex @a p to the current polyline.
+     */
+    void line_to (point_type const & p)
+    {
+        if (_tail.empty()) {
+            move_to(p);
+            return;
+        }
+
+        _tail.push_back(p);
+        ++_input_count;
+
+        if (_tail.size() > _window) {
+            commit(false);
+
+            // No interior vertex is kept: the whole tail is within the
+            // tolerance from one segment
+            if (_tail.size() > _window)
+                commit(true);
+        }
+    }
+
+    /**
+     * @brief Appends the simplified polylines to @a out.
+     */
+    template <typename Allocator>
+    void build (path<unit_type, Allocator> & out);
+};
+
+template <typename UnitT>
+void path_simplifier<UnitT>::simplify_tail ()
+{
+    std::size_t n = _tail.size();
+    double tolerance2 = _tolerance * _tolerance;
+
+    _kept.clear();
+    _kept.push_back(0);
+
+    if (n < 2)
+        return;
+
+    // Iterative RDP: ranges are processed left to right, so kept vertices
+    // are found in order
+    _stack.clear();
+    _stack.emplace_back(0, n - 1);
+
+    while (!_stack.empty()) {
+        auto range = _stack.back();
+        _stack.pop_back();
+
+        double max_d2 = -1;
+        std::size_t index = range.first;
+
+        for (std::size_t i = range.first + 1; i < range.second; i++) {
+            double d2 = distance2(_tail[i], _tail[range.first], _tail[range.second]);
+
+            if (d2 > max_d2) {
+                max_d2 = d2;
+                index = i;
+            }
+        }
+
+        if (max_d2 > tolerance2) {
+            _stack.emplace_back(index, range.second);
+            _stack.emplace_back(range.first, index);
+        } else {
+            _kept.push_back(range.second);
+        }
+    }
+}
+
+template <typename UnitT>
+void path_simplifier<UnitT>::commit (bool all)
+{
+    simplify_tail();
+
+    if (_kept.size() < 2)
+        return;
+
+    // The last kept vertex is the last input vertex: the segment ending at
+    // it changes with new samples
+    std::size_t last = all ? _kept.size() - 1 : _kept.size() - 2;
+
+    for (std::size_t k = 1; k <= last; k++)
+        _entries.emplace_back(path_entry_enum::line_to, _tail[_kept[k]]);
+
+    _tail.erase(_tail.begin(), _tail.begin() + _kept[last]);
+}
+
+template <typename UnitT>
+template <typename Allocator>
+void path_simplifier<UnitT>::build (path<unit_type, Allocator> & out)
+{
+    if (_tail.size() > 2)
+        commit(false);
+
+    out.reserve(out.size() + _entries.size() + 1);
+
+    for (auto const & e: _entries) {
+        if (e.type == path_entry_enum::move_to)
+            out.move_to(e.p);
+        else
+            out.line_to(e.p);
+    }
+
+    // After commit the remaining tail is within the tolerance from the
+    // segment between its ends
+    if (_tail.size() > 1)
+        out.line_to(_tail.back());
+}
+
+/**
+ * @class column_decimator
+ * @brief Level-of-detail stage for time series: keeps at most four vertices
+ *        (first, minimum, maximum and last) per pixel column.
+ *
+ * Samples must be appended with non-decreasing x. The polyline through the
+ * kept vertices covers exactly the same pixels in every column as the full
+ * series, so a series of millions of samples is rendered as a few
+ * vertices per visible column. Decimation is incremental: only the last
+ * column is open, appending samples never revisits closed columns.
+ */
+template <typename UnitT>
+class column_decimator
+{
+public:
+    using unit_type  = UnitT;
+    using point_type = point<unit_type>;
+
+private:
+    struct column
+    {
+        long index;
+        point_type first;
+        point_type min;
+        point_type max;
+        point_type last;
+        std::size_t min_order; // order of min and max samples in the column
+        std::size_t max_order;
+        std::size_t count;
+    };
+
+    double _origin;
+    double _width;
+    std::vector<point_type> _points; // vertices of closed columns
+    column _open;
+    std::size_t _input_count {0};
+
+private:
+    long column_index (unit_type x) const noexcept
+    {
+        return static_cast<long>(std::floor((static_cast<double>(x) - _origin) / _width));
+    }
+
+    /**
+     * @brief Calls @a f for kept vertices of column @a c in sample order.
+     */
+    template <typename F>
+    static void for_each_vertex (column const & c, F && f)
+    {
+        f(c.first);
+        f(c.min_order < c.max_order ? c.min : c.max);
+        f(c.min_order < c.max_order ? c.max : c.min);
+        f(c.last);
+    }
+
+    static void append_column (std::vector<point_type> & out, column const & c)
+    {
+        for_each_vertex(c, [& out] (point_type const & p) {
+            if (out.empty() || !(out.back().x() == p.x() && out.back().y() == p.y()))
+                out.push_back(p);
+        });
+    }
+
+public:
+    /**
+     * @param origin X coordinate of the left edge of the column 0.
+     * @param column_width Width of the column in units (units per pixel).
+     */
+    column_decimator (unit_type origin, double column_width)
+        : _origin(static_cast<double>(origin))
+        , _width(column_width > 0 ? column_width : 1)
+    {
+        _open.count = 0;
+    }
+
+    /**
+     * @return Number of input samples.
+     */
+    std::size_t input_count () const noexcept
+    {
+        return _input_count;
+    }
+
+    void clear () noexcept
+    {
+        _points.clear();
+        _open.count = 0;
+        _input_count = 0;
+    }
+
+    /**
+     * @brief Appends sample @a p.
+     */
+    void append (point_type const & p);
+
+    /**
+     * @brief Appends the decimated polyline to @a out as a new subpath.
+     */
+    template <typename Allocator>
+    void build (path<unit_type, Allocator> & out) const;
+
+    /**
+     * @return Decimated vertices.
+     */
+    std::vector<point_type> get_points () const
+    {
+        std::vector<point_type> result {_points};
+
+        if (_open.count > 0)
+            append_column(result, _open);
+
+        return result;
+    }
+};
+
+template <typename UnitT>
+void column_decimator<UnitT>::append (point_type const & p)
+{
+    long index = column_index(p.x());
+    ++_input_count;
+
+    if (_open.count > 0 && index == _open.index) {
+        if (p.y() < _open.min.y()) {
+            _open.min = p;
+            _open.min_order = _open.count;
+        }
+
+        if (p.y() > _open.max.y()) {
+            _open.max = p;
+            _open.max_order = _open.count;
+        }
+
+        _open.last = p;
+        ++_open.count;
+        return;
+    }
+
+    if (_open.count > 0)
+        append_column(_points, _open);
+
+    _open.index = index;
+    _open.first = _open.min = _open.max = _open.last = p;
+    _open.min_order = _open.max_order = 0;
+    _open.count = 1;
+}
+
+template <typename UnitT>
+template <typename Allocator>
+void column_decimator<UnitT>::build (path<unit_type, Allocator> & out) const
+{
+    std::size_t n = _points.size();
+
+    if (n == 0 && _open.count == 0)
+        return;
+
+    out.reserve(out.size() + n + 4);
+
+    if (n > 0) {
+        out.move_to(_points[0]);
+
+        for (std::size_t i = 1; i < n; i++)
+            out.line_to(_points[i]);
+    }
+
+    if (_open.count > 0) {
+        bool started = n > 0;
+        point_type prev = started ? _points[n - 1] : _open.first;
+
+        for_each_vertex(_open, [& out, & started, & prev] (point_type const & p) {
+            if (!started) {
+                out.move_to(p);
+                started = true;
+            } else if (!(prev.x() == p.x() && prev.y() == p.y())) {
+                out.line_to(p);
+            }
+
+            prev = p;
+        });
+    }
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+//      2021.07.13 Stencil fans are never merged.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/color.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+struct mesh_vertex
+{
+    float x;
+    float y;
+};
+
+enum class mesh_command_type : std::uint8_t
+{
+      triangles   ///< Non-overlapping triangles, can be drawn directly
+    , stencil_fan ///< Triangle fan of a polygon to fill by stencil-then-cover (nonzero/even-odd)
+};
+
+/**
+ * @brief Range of indices drawn with one color.
+ */
+struct mesh_command
+{
+    mesh_command_type type;
+    color             fill_color;
+    std::uint32_t     first_index;
+    std::uint32_t     index_count;
+};
+
+/**
+ * @brief Indexed triangle list ready for submission to a backend.
+ */
+struct mesh
+{
+    std::vector<mesh_vertex>   vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<mesh_command>  commands;
+
+    bool empty () const noexcept
+    {
+        return indices.empty();
+    }
+
+    /**
+     * @brief Clears content without releasing memory, so the mesh can be
+     *        reused for the next frame without allocations.
+     */
+    void clear () noexcept
+    {
+        vertices.clear();
+        indices.clear();
+        commands.clear();
+    }
+
+    /**
+     * @brief Starts a new command, continuing the last one if both are
+     *        triangles of the same color.
+     *
+     * Stencil fans are never merged: winding of separate fills must not be
+     * accumulated (overlapping paths of opposite orientation would cancel
+     * each other out).
+     */
+    void begin_command (mesh_command_type type, color const & c)
+    {
+        if (type == mesh_command_type::triangles && !commands.empty()) {
+            mesh_command const & last = commands.back();
+
+            if (last.type == type && last.fill_color == c
+                    && last.first_index + last.index_count == indices.size()) {
+                return;
+            }
+        }
+
+        commands.push_back(mesh_command{type, c
+            , static_cast<std::uint32_t>(indices.size()), 0});
+    }
+
+    /**
+     * @brief Finishes the current command with indices added since
+     *        begin_command().
+     */
+    void end_command () noexcept
+    {
+        mesh_command & last = commands.back();
+        last.index_count = static_cast<std::uint32_t>(indices.size()) - last.first_index;
+    }
+
+    std::uint32_t add_vertex (float x, float y)
+    {
+        vertices.push_back(mesh_vertex{x, y});
+        return static_cast<std::uint32_t>(vertices.size() - 1);
+    }
+
+    void add_triangle (std::uint32_t a, std::uint32_t b, std::uint32_t c)
+    {
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    }
+
+    /**
+     * @brief Appends @a other mesh (rebasing its indices).
+     */
+    void append (mesh const & other)
+    {
+        auto vbase = static_cast<std::uint32_t>(vertices.size());
+        auto ibase = static_cast<std::uint32_t>(indices.size());
+
+        vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+
+        for (auto i: other.indices)
+            indices.push_back(i + vbase);
+
+        for (auto c: other.commands) {
+            c.first_index += ibase;
+            commands.push_back(c);
+        }
+    }
+};
+
+}} // namespace pfs::griotte
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <pfs/griotte/noncopyable.hpp>
 #include <pfs/griotte/point.hpp>
@@ -34,7 +35,7 @@ public:
             , point<UnitT> const & p2
             , pen<UnitT> const & apen)
     {
-        _d->template draw_line<UnitT>(p1, p2, apen);
+        _d->draw_line(p1, p2, apen);
     }
 
     /**
@@ -51,6 +52,18 @@ public:
                 , apen);
     }
 
+    /**
+     * @fn void painter::draw_polyline (point const * points, std::size_t count, pen const & apen)
+     * @brief Draws a polyline through @a count @a points using pen @a apen.
+     */
+    template <typename UnitT>
+    void draw_polyline (point<UnitT> const * points
+            , std::size_t count
+            , pen<UnitT> const & apen)
+    {
+        _d->draw_polyline(points, count, apen);
+    }
+
     /**
      *
      */
@@ -1,8 +1,13 @@
 #pragma once
 #include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+#include <QPointF>
+#include <QVector>
 #include <pfs/griotte/color.hpp>
 #include <pfs/griotte/pen.hpp>
 #include <pfs/griotte/line.hpp>
+#include <pfs/griotte/point.hpp>
 #include <pfs/griotte/rect.hpp>
 
 namespace pfs {
@@ -29,27 +34,43 @@ inline Qt::PenJoinStyle lexical_cast (pfs::griotte::join_style join)
     return qt_pen_join_style[static_cast<int>(join)];
 }
 
+/**
+ * @brief Converts @a apen into @a p, using @a dash_pattern as a scratch
+ *        buffer (its capacity is reused between calls).
+ */
 template <typename UnitT>
-inline QPen lexical_cast (pfs::griotte::pen<UnitT> const & apen)
+inline void lexical_cast (pfs::griotte::pen<UnitT> const & apen
+    , QPen & p
+    , QVector<qreal> & dash_pattern)
 {
-    QPen p;
     UnitT width = apen.get_width();
     p.setColor(lexical_cast(apen.get_color()));
-    p.setWidth(width);
+    p.setWidthF(static_cast<qreal>(width));
     p.setCapStyle(lexical_cast(apen.get_cap()));
     p.setJoinStyle(lexical_cast(apen.get_join()));
 
     auto dasharray = apen.get_dasharray();
 
     if (!dasharray.empty()) {
-        QVector<qreal> dash_pattern;
+        // Since Qt 5.6 resize() does not shrink the capacity
+        dash_pattern.resize(0);
 
         for (auto item: dasharray)
             dash_pattern << (static_cast<qreal>(item) / width);
 
         p.setDashPattern(dash_pattern);
+        p.setDashOffset(static_cast<qreal>(apen.get_dash_offset()) / width);
+    } else {
+        p.setStyle(Qt::SolidLine);
     }
+}
 
+template <typename UnitT>
+inline QPen lexical_cast (pfs::griotte::pen<UnitT> const & apen)
+{
+    QPen p;
+    QVector<qreal> dash_pattern;
+    lexical_cast(apen, p, dash_pattern);
     return p;
 }
 
@@ -134,6 +155,12 @@ class painter
 {
     QPainter _p;
 
+    // Reused between draw calls to avoid per-call allocations
+    QPainterPath   _path;
+    QPen           _pen;
+    QVector<qreal> _dash_pattern;
+    QVector<QPointF> _polyline;
+
 public:
     painter (QPaintDevice * pd)
         : _p(pd)
@@ -148,6 +175,11 @@ public:
             , point<UnitT> const & p2
             , pen<UnitT> const & apen);
 
+    template <typename UnitT>
+    void draw_polyline (point<UnitT> const * points
+            , std::size_t count
+            , pen<UnitT> const & apen);
+
     template <typename UnitT>
     void draw_curve (point<UnitT> const & start_point
             , point<UnitT> const & c1
@@ -163,9 +195,28 @@ void painter::draw_line (point<UnitT> const & p1
 {
     UnitT width = apen.get_width();
     if (width > 0) {
-        QPen pen = lexical_cast(apen);
-        _p.setPen(pen);
-        _p.drawLine(p1.get_x(), p1.get_y(), p2.get_x(), p2.get_y());
+        lexical_cast(apen, _pen, _dash_pattern);
+        _p.setPen(_pen);
+        _p.drawLine(QPointF(p1.x(), p1.y()), QPointF(p2.x(), p2.y()));
+    }
+}
+
+template <typename UnitT>
+void painter::draw_polyline (point<UnitT> const * points
+        , std::size_t count
+        , pen<UnitT> const & apen)
+{
+    UnitT width = apen.get_width();
+    if (width > 0 && count > 1) {
+        // Since Qt 5.6 resize() does not shrink the capacity
+        _polyline.resize(static_cast<int>(count));
+
+        for (std::size_t i = 0; i < count; i++)
+            _polyline[static_cast<int>(i)] = QPointF(points[i].x(), points[i].y());
+
+        lexical_cast(apen, _pen, _dash_pattern);
+        _p.setPen(_pen);
+        _p.drawPolyline(_polyline.constData(), static_cast<int>(count));
     }
 }
 
@@ -178,15 +229,16 @@ void painter::draw_curve (point<UnitT> const & start_point
 {
     UnitT width = apen.get_width();
     if (width > 0) {
-        QPainterPath path;
-        path.moveTo(start_point.get_x(), start_point.get_y());
-        path.cubicTo(c1.get_x(), c1.get_y()
-                , c2.get_x(), c2.get_y()
-                , end_point.get_x(), end_point.get_y());
-
-        QPen pen = lexical_cast(apen);
-        _p.setPen(pen);
-        _p.drawPath(path);
+        // Since Qt 5.13 clear() keeps allocated elements
+        _path.clear();
+        _path.moveTo(start_point.x(), start_point.y());
+        _path.cubicTo(c1.x(), c1.y()
+                , c2.x(), c2.y()
+                , end_point.x(), end_point.y());
+
+        lexical_cast(apen, _pen, _dash_pattern);
+        _p.setPen(_pen);
+        _p.drawPath(_path);
     }
 }
 
@@ -0,0 +1,472 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.05 Initial version
+//      2021.07.13 Appending after a hard line break.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/fixed.hpp"
+#include "pfs/griotte/line_break.hpp"
+#include "pfs/griotte/utf8.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+enum class text_align
+{
+      left
+    , right
+    , center
+};
+
+/**
+ * @brief Laid-out line of a paragraph.
+ */
+struct line_box
+{
+    std::size_t first;  ///< Byte offset of the first character
+    std::size_t last;   ///< Byte offset past the last visible character (trailing spaces excluded)
+    std::size_t next;   ///< Byte offset of the next line
+    fixed26_6 x;        ///< Offset of the line from the left edge of the paragraph
+    fixed26_6 baseline; ///< Offset of the baseline from the top of the paragraph
+    fixed26_6 width;    ///< Width of the visible characters
+};
+
+/**
+ * @class paragraph
+ * @brief Multi-line text laid out into lines of limited width.
+ *
+ * Text (UTF-8) is broken at line break opportunities of UAX #14 (see
+ * line_break_action()), a word that does not fit into the width is broken
+ * between characters. Trailing spaces of a line do not count toward its
+ * width. Line height and baseline position are defined by font ascender,
+ * descender and line gap.
+ *
+ * Line boxes are cached: changing the width revalidates lines in constant
+ * time each and wraps again only lines starting from the first affected
+ * one, unaffected lines following rewrapped ones are reused; appending text
+ * wraps again only the last line. Alignment is applied on access.
+ *
+ * @a FontMetrics must provide (values in pixels)
+ * @code
+ * fixed26_6 advance (char32_t cp);
+ * fixed26_6 ascender () const;  // above the baseline, positive
+ * fixed26_6 descender () const; // below the baseline, negative
+ * fixed26_6 height () const;    // baseline-to-baseline distance
+ * @endcode
+ */
+template <typename FontMetrics>
+class paragraph
+{
+    struct line_entry
+    {
+        std::size_t first; // indices of code points
+        std::size_t last;
+        std::size_t next;
+        fixed26_6   width;
+        bool        hard;      // ended by mandatory break
+        bool        emergency; // word broken between characters
+    };
+
+    FontMetrics * _metrics;
+    std::string _text;
+    fixed26_6 _width; // zero or negative: no wrapping
+    text_align _align {text_align::left};
+
+    std::vector<std::size_t> _offsets;        // byte offsets of code points (n + 1)
+    std::vector<fixed26_6> _x;                // advance prefix sums (n + 1)
+    std::vector<line_break_class> _classes;   // (n)
+    std::vector<std::size_t> _content_end;    // end of visible content before the index (n + 1)
+    std::vector<std::size_t> _opportunities;  // break positions, the last is n
+    std::vector<bool> _mandatory;             // (opportunities)
+
+    std::vector<line_entry> _lines;
+    std::vector<line_entry> _old_lines;       // scratch
+    std::size_t _first_changed {0};
+    fixed26_6 _content_width;
+
+private:
+    std::size_t count () const noexcept
+    {
+        return _classes.size();
+    }
+
+    static bool is_newline (line_break_class c) noexcept
+    {
+        return c == line_break_class::bk || c == line_break_class::cr
+            || c == line_break_class::lf;
+    }
+
+    // Trailing spaces and line breaks do not count toward the line width
+    static bool is_trailing (line_break_class c) noexcept
+    {
+        return c == line_break_class::sp || is_newline(c);
+    }
+
+    bool wrapping () const noexcept
+    {
+        return _width > fixed26_6{};
+    }
+
+    fixed26_6 content_width (std::size_t first, std::size_t pos) const noexcept
+    {
+        return _x[(std::max)(_content_end[pos], first)] - _x[first];
+    }
+
+    /**
+     * @brief Decodes text starting at byte @a offset and appends code points
+     *        and their break opportunities.
+     */
+    void analyze (std::size_t offset);
+
+    /**
+     * @brief Recalculates advances of all code points.
+     */
+    void measure ();
+
+    line_entry make_line (std::size_t first) const;
+
+    bool is_valid (line_entry const & l) const;
+
+    /**
+     * @brief Lays out lines starting from the line @a first_line, following
+     *        lines are reused if still valid.
+     */
+    void relayout (std::size_t first_line);
+
+public:
+    explicit paragraph (FontMetrics & metrics)
+        : _metrics(& metrics)
+    {
+        analyze(0);
+        relayout(0);
+    }
+
+    std::string const & get_text () const noexcept
+    {
+        return _text;
+    }
+
+    void set_text (std::string const & text)
+    {
+        _text = text;
+        _offsets.clear();
+        _x.clear();
+        _classes.clear();
+        _content_end.clear();
+        _opportunities.clear();
+        _mandatory.clear();
+        _lines.clear();
+        analyze(0);
+        relayout(0);
+    }
+
+    /**
+     * @brief Appends @a text, only the last line is wrapped again.
+     */
+    void append_text (std::string const & text)
+    {
+        std::size_t offset = _text.size();
+        std::size_t last_line = _lines.empty() ? 0 : _lines.size() - 1;
+
+        // CR ending the previous text ends the line before the last (empty)
+        // one, that line changes if the text continues with LF (CR LF is a
+        // single break)
+        if (last_line > 0 && count() > 0 && _classes[count() - 1] == line_break_class::cr)
+            --last_line;
+
+        _text += text;
+        analyze(offset);
+
+        // The break at the end of the previous text may vanish
+        _lines.resize(last_line);
+        relayout(last_line);
+    }
+
+    fixed26_6 get_width () const noexcept
+    {
+        return _width;
+    }
+
+    /**
+     * @brief Sets maximum line width, zero disables wrapping.
+     */
+    void set_width (fixed26_6 width)
+    {
+        if (width == _width)
+            return;
+
+        _width = width;
+
+        std::size_t first_line = 0;
+
+        while (first_line < _lines.size() && is_valid(_lines[first_line]))
+            ++first_line;
+
+        if (first_line == _lines.size())
+            _first_changed = first_line;
+        else
+            relayout(first_line);
+    }
+
+    /**
+     * @brief Sets font metrics (e.g. after font or size change), all lines
+     *        are laid out again.
+     */
+    void set_font (FontMetrics & metrics)
+    {
+        _metrics = & metrics;
+        measure();
+        _lines.clear();
+        relayout(0);
+    }
+
+    text_align get_align () const noexcept
+    {
+        return _align;
+    }
+
+    void set_align (text_align align) noexcept
+    {
+        _align = align;
+    }
+
+    std::size_t line_count () const noexcept
+    {
+        return _lines.size();
+    }
+
+    /**
+     * @return Index of the first line changed by the last modification
+     *         (equals to line_count() if no line changed).
+     */
+    std::size_t get_first_changed_line () const noexcept
+    {
+        return _first_changed;
+    }
+
+    fixed26_6 get_line_height () const
+    {
+        return _metrics->height();
+    }
+
+    /**
+     * @return Height of all lines.
+     */
+    fixed26_6 get_height () const
+    {
+        return _metrics->height() * static_cast<int>(_lines.size());
+    }
+
+    /**
+     * @return Width of the widest line.
+     */
+    fixed26_6 get_content_width () const noexcept
+    {
+        return _content_width;
+    }
+
+    line_box get_line (std::size_t i) const;
+};
+
+template <typename FontMetrics>
+void paragraph<FontMetrics>::analyze (std::size_t offset)
+{
+    std::size_t first = count();
+
+    // Break at the end of the previous text is recalculated
+    if (!_opportunities.empty() && _opportunities.back() == first) {
+        _opportunities.pop_back();
+        _mandatory.pop_back();
+    }
+
+    if (_x.empty()) {
+        _x.push_back(fixed26_6{});
+        _content_end.push_back(0);
+    } else {
+        _offsets.pop_back();
+    }
+
+    std::size_t pos = offset;
+
+    while (pos < _text.size()) {
+        _offsets.push_back(pos);
+        char32_t cp = utf8_decode(_text.data(), _text.size(), pos);
+        line_break_class c = line_break_class_of(cp);
+
+        _classes.push_back(c);
+        _x.push_back(_x.back() + (is_newline(c) ? fixed26_6{} : _metrics->advance(cp)));
+        _content_end.push_back(is_trailing(c) ? _content_end.back() : count());
+    }
+
+    _offsets.push_back(_text.size());
+
+    for (std::size_t i = (std::max)(first, std::size_t{1}); i < count(); i++) {
+        line_break action = line_break_action(_classes.data(), i);
+
+        if (action != line_break::prohibited) {
+            _opportunities.push_back(i);
+            _mandatory.push_back(action == line_break::mandatory);
+        }
+    }
+
+    // End of text: mandatory if the text ends with a hard line break
+    std::size_t n = count();
+    bool hard = n > 0 && is_newline(_classes[n - 1]);
+
+    _opportunities.push_back(n);
+    _mandatory.push_back(hard);
+}
+
+template <typename FontMetrics>
+void paragraph<FontMetrics>::measure ()
+{
+    std::size_t pos = 0;
+
+    for (std::size_t i = 0; i < count(); i++) {
+        char32_t cp = utf8_decode(_text.data(), _text.size(), pos);
+        _x[i + 1] = _x[i] + (is_newline(_classes[i]) ? fixed26_6{} : _metrics->advance(cp));
+    }
+}
+
+template <typename FontMetrics>
+typename paragraph<FontMetrics>::line_entry
+paragraph<FontMetrics>::make_line (std::size_t first) const
+{
+    std::size_t n = count();
+
+    if (first >= n)
+        return line_entry{n, n, n, fixed26_6{}, false, false};
+
+    auto it = std::upper_bound(_opportunities.begin(), _opportunities.end(), first);
+    std::size_t best = 0;
+    bool found = false;
+    bool hard = false;
+
+    for (; it != _opportunities.end(); ++it) {
+        std::size_t pos = *it;
+        bool mandatory = _mandatory[it - _opportunities.begin()];
+
+        if (wrapping() && content_width(first, pos) > _width)
+            break;
+
+        best = pos;
+        found = true;
+        hard = mandatory;
+
+        if (mandatory)
+            break;
+    }
+
+    if (found) {
+        std::size_t last = (std::max)(_content_end[best], first);
+        return line_entry{first, last, best, _x[last] - _x[first], hard, false};
+    }
+
+    // The first word does not fit: break it after the last fitting
+    // character (at least one), combining marks stay with the base
+    std::size_t last = first + 1;
+
+    while (last < n && _x[last + 1] - _x[first] <= _width)
+        ++last;
+
+    while (last < n && _classes[last] == line_break_class::cm)
+        ++last;
+
+    return line_entry{first, last, last, _x[last] - _x[first], false, true};
+}
+
+template <typename FontMetrics>
+bool paragraph<FontMetrics>::is_valid (line_entry const & l) const
+{
+    // Empty line follows a hard break at the end of the text
+    if (l.first == l.next)
+        return l.first == count();
+
+    if (l.emergency)
+        return false;
+
+    if (wrapping() && l.width > _width)
+        return false;
+
+    if (l.hard || l.next == count())
+        return true;
+
+    // The line must not be extended to the next opportunity
+    if (!wrapping())
+        return false;
+
+    auto it = std::upper_bound(_opportunities.begin(), _opportunities.end(), l.next);
+    return it != _opportunities.end() && content_width(l.first, *it) > _width;
+}
+
+template <typename FontMetrics>
+void paragraph<FontMetrics>::relayout (std::size_t first_line)
+{
+    std::size_t n = count();
+
+    // Lines before the first affected one are kept
+    first_line = (std::min)(first_line, _lines.size());
+
+    std::size_t pos = first_line < _lines.size()
+        ? _lines[first_line].first
+        : first_line > 0 ? _lines[first_line - 1].next : 0;
+
+    _old_lines.assign(_lines.begin() + first_line, _lines.end());
+    _lines.resize(first_line);
+    _first_changed = first_line;
+
+    auto old = _old_lines.begin();
+
+    for (;;) {
+        while (old != _old_lines.end() && old->first < pos)
+            ++old;
+
+        line_entry l = (old != _old_lines.end() && old->first == pos && is_valid(*old))
+            ? *old
+            : make_line(pos);
+
+        _lines.push_back(l);
+
+        if (l.next >= n && !l.hard)
+            break;
+
+        pos = l.next;
+    }
+
+    _content_width = fixed26_6{};
+
+    for (auto const & l: _lines)
+        _content_width = (std::max)(_content_width, l.width);
+}
+
+template <typename FontMetrics>
+line_box paragraph<FontMetrics>::get_line (std::size_t i) const
+{
+    line_entry const & l = _lines[i];
+    fixed26_6 width = wrapping() ? _width : _content_width;
+    fixed26_6 x;
+
+    switch (_align) {
+        case text_align::right:
+            x = width - l.width;
+            break;
+        case text_align::center:
+            x = (width - l.width) / 2;
+            break;
+        default:
+            break;
+    }
+
+    return line_box{_offsets[l.first], _offsets[l.last], _offsets[l.next]
+        , x, _metrics->ascender() + _metrics->height() * static_cast<int>(i), l.width};
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/job_system.hpp"
+#include "pfs/griotte/tessellator.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class parallel_tessellator
+ * @brief Tessellates batches of paths on the job system.
+ *
+ * Paths submitted by stroke() and fill() are split into batches, each batch
+ * is tessellated by a job into its own mesh, then meshes are concatenated in
+ * submission order, so the result is the same as of sequential tessellation.
+ * Batch meshes and tessellators are kept between frames to avoid
+ * allocations.
+ *
+ * @note Submitted paths and pens must stay alive until run() returns.
+ */
+template <typename UnitT
+    , typename PathAllocator = std::allocator<path_entry<UnitT>>>
+class parallel_tessellator
+{
+public:
+    using unit_type = UnitT;
+    using path_type = path<unit_type, PathAllocator>;
+    using pen_type  = pen<unit_type>;
+
+private:
+    struct item
+    {
+        path_type const * p;
+        pen_type const *  stroke_pen; // nullptr for fill
+        color             fill_color;
+    };
+
+    struct batch
+    {
+        tessellator<unit_type> t;
+        mesh                   m;
+        std::error_code        ec;
+        std::size_t            vertex_offset;
+        std::size_t            index_offset;
+    };
+
+    job_system * _jobs;
+    float _tolerance;
+    std::size_t _batch_size;
+    std::vector<item> _items;
+    std::vector<batch> _batches;
+
+public:
+    /**
+     * @param jobs Job system to run tessellation.
+     * @param batch_size Number of paths tessellated by one job.
+     */
+    parallel_tessellator (job_system & jobs
+        , float tolerance = 0.25f
+        , std::size_t batch_size = 64)
+        : _jobs(& jobs)
+        , _tolerance(tolerance)
+        , _batch_size((std::max)(batch_size, std::size_t{1}))
+    {}
+
+    std::size_t count () const noexcept
+    {
+        return _items.size();
+    }
+
+    void clear () noexcept
+    {
+        _items.clear();
+    }
+
+    void stroke (path_type const & apath, pen_type const & apen)
+    {
+        _items.push_back(item{& apath, & apen, color{}});
+    }
+
+    void fill (path_type const & apath, color const & c)
+    {
+        _items.push_back(item{& apath, nullptr, c});
+    }
+
+    /**
+     * @brief Tessellates all submitted paths into @a out (replacing its
+     *        content) and clears the submission list.
+     *
+     * On error @a ec is set to the error of the first failed path in
+     * submission order.
+     */
+    void run (mesh & out, std::error_code & ec);
+
+    void run (mesh & out)
+    {
+        std::error_code ec;
+        run(out, ec);
+        if (ec) throw exception(ec);
+    }
+};
+
+template <typename UnitT, typename PathAllocator>
+void parallel_tessellator<UnitT, PathAllocator>::run (mesh & out
+    , std::error_code & ec)
+{
+    out.clear();
+
+    std::size_t nbatches = (_items.size() + _batch_size - 1) / _batch_size;
+
+    while (_batches.size() < nbatches)
+        _batches.emplace_back(batch{tessellator<unit_type>{_tolerance}, mesh{}, std::error_code{}, 0, 0});
+
+    // Tessellation
+    _jobs->parallel_for(nbatches, 1, [this] (std::size_t first, std::size_t last) {
+        for (std::size_t b = first; b < last; b++) {
+            batch & bt = _batches[b];
+            bt.m.clear();
+            bt.ec.clear();
+            bt.t.set_tolerance(_tolerance);
+
+            std::size_t ifirst = b * _batch_size;
+            std::size_t ilast = (std::min)(ifirst + _batch_size, _items.size());
+
+            for (std::size_t i = ifirst; i < ilast && !bt.ec; i++) {
+                item const & it = _items[i];
+
+                if (it.stroke_pen)
+                    bt.t.stroke(*it.p, *it.stroke_pen, bt.m, bt.ec);
+                else
+                    bt.t.fill(*it.p, it.fill_color, bt.m, bt.ec);
+            }
+        }
+    });
+
+    _items.clear();
+
+    std::size_t nvertices = 0;
+    std::size_t nindices = 0;
+
+    for (std::size_t b = 0; b < nbatches; b++) {
+        batch & bt = _batches[b];
+
+        if (bt.ec && !ec)
+            ec = bt.ec;
+
+        bt.vertex_offset = nvertices;
+        bt.index_offset = nindices;
+        nvertices += bt.m.vertices.size();
+        nindices += bt.m.indices.size();
+
+        for (auto c: bt.m.commands) {
+            c.first_index += static_cast<std::uint32_t>(bt.index_offset);
+            out.commands.push_back(c);
+        }
+    }
+
+    if (ec)
+        return;
+
+    // Concatenation in submission order
+    out.vertices.resize(nvertices);
+    out.indices.resize(nindices);
+
+    _jobs->parallel_for(nbatches, 1, [this, & out] (std::size_t first, std::size_t last) {
+        for (std::size_t b = first; b < last; b++) {
+            batch const & bt = _batches[b];
+            auto base = static_cast<std::uint32_t>(bt.vertex_offset);
+
+            if (!bt.m.vertices.empty()) {
+                std::memcpy(& out.vertices[bt.vertex_offset], bt.m.vertices.data()
+                    , bt.m.vertices.size() * sizeof(mesh_vertex));
+            }
+
+            std::uint32_t * dest = out.indices.data() + bt.index_offset;
+
+            for (auto i: bt.m.indices)
+                *dest++ = i + base;
+        }
+    });
+}
+
+}} // namespace pfs::griotte
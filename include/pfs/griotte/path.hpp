@@ -1,5 +1,6 @@
 #pragma once
 #include <cassert>
+#include <memory>
 #include <vector>
 #include <pfs/griotte/point.hpp>
 #include <pfs/griotte/rect.hpp>
@@ -127,26 +128,36 @@ enum class path_entry_enum : int
 };
 
 template <typename UnitT>
+struct path_entry
+{
+    path_entry_enum type;
+    point<UnitT> p;
+
+    path_entry (path_entry_enum atype
+            , point<UnitT> const & apoint)
+        : type{atype}
+        , p{apoint}
+    {}
+};
+
+/**
+ * @class path
+ * @brief Painter path.
+ *
+ * @a Allocator allows to build transient paths without heap traffic
+ * (e.g. with arena_allocator).
+ */
+template <typename UnitT, typename Allocator = std::allocator<path_entry<UnitT>>>
 class path
 {
 public:
-    using unit_type  = UnitT;
-    using point_type = point<unit_type>;
-    using rect_type  = rect<unit_type>;
-
-    struct entry
-    {
-        path_entry_enum type;
-        point_type p;
-
-        entry (path_entry_enum atype
-                , point_type const & apoint)
-            : type{atype}
-            , p{apoint}
-        {}
-    };
+    using unit_type      = UnitT;
+    using point_type     = point<unit_type>;
+    using rect_type      = rect<unit_type>;
+    using entry          = path_entry<unit_type>;
+    using allocator_type = Allocator;
 
-    using entry_collection = std::vector<entry>;
+    using entry_collection = std::vector<entry, allocator_type>;
     using iterator         = typename entry_collection::iterator;
     using const_iterator   = typename entry_collection::const_iterator;
     using reference        = typename entry_collection::reference;
@@ -159,7 +170,17 @@ public:
     /**
      * @brief Constructs a path with start point at (0, 0).
      */
-    path () noexcept
+    path ()
+    {
+        _v.emplace_back(path_entry_enum::move_to, point_type{0, 0});
+    }
+
+    /**
+     * @brief Constructs a path with start point at (0, 0) using allocator
+     *        @a alloc.
+     */
+    explicit path (allocator_type const & alloc)
+        : _v(alloc)
     {
         _v.emplace_back(path_entry_enum::move_to, point_type{0, 0});
     }
@@ -168,7 +189,9 @@ public:
      * @brief Constructs a path with start point at @a start.
      * @note Considered that start point is in absolute coordinates.
      */
-    path (point_type const & start) noexcept
+    path (point_type const & start
+            , allocator_type const & alloc = allocator_type{})
+        : _v(alloc)
     {
         _v.emplace_back(path_entry_enum::move_to, start);
     }
@@ -179,11 +202,42 @@ public:
     path (path && rhs) = default;
     path & operator = (path && rhs) = default;
 
+    allocator_type get_allocator () const
+    {
+        return _v.get_allocator();
+    }
+
     bool empty () const
     {
         return _v.empty();
     }
 
+    /**
+     * @return Number of path entries.
+     */
+    std::size_t size () const
+    {
+        return _v.size();
+    }
+
+    /**
+     * @brief Reserves space for @a n path entries.
+     */
+    void reserve (std::size_t n)
+    {
+        _v.reserve(n);
+    }
+
+    /**
+     * @brief Removes all entries except the start point at (0, 0), keeping
+     *        allocated memory.
+     */
+    void clear ()
+    {
+        _v.clear();
+        _v.emplace_back(path_entry_enum::move_to, point_type{0, 0});
+    }
+
     iterator begin ()
     {
         return _v.begin();
@@ -354,20 +408,15 @@ public:
     /**
      * @brief Appends the given @a apath to this path as a closed subpath.
      */
-    inline void append_path (path const & apath)
+    template <typename A>
+    inline void append_path (path<UnitT, A> const & apath)
     {
-        _v.insert(_v.begin(), apath._v.cbegin(), apath._v.cend());
+        _v.insert(_v.end(), apath.cbegin(), apath.cend());
     }
-
-    template <typename U>
-    friend rect_type bounding_rect (path<U> const & apath);
-
-    template <typename U>
-    friend rect_type control_point_rect (path<U> const & apath);
 };
 
-template <typename UnitT>
-void path<UnitT>::move_to (point_type const & apoint, bool is_relative)
+template <typename UnitT, typename Allocator>
+void path<UnitT, Allocator>::move_to (point_type const & apoint, bool is_relative)
 {
     // Collection of entries is always non-empty (according to constructors).
     assert(!_v.empty());
@@ -384,8 +433,8 @@ void path<UnitT>::move_to (point_type const & apoint, bool is_relative)
         back.p = abspoint; // Replace point
 }
 
-template <typename UnitT>
-void path<UnitT>::line_to (point_type const & apoint, bool is_relative)
+template <typename UnitT, typename Allocator>
+void path<UnitT, Allocator>::line_to (point_type const & apoint, bool is_relative)
 {
     assert(!_v.empty());
 
@@ -398,8 +447,8 @@ void path<UnitT>::line_to (point_type const & apoint, bool is_relative)
     }
 }
 
-template <typename UnitT>
-void path<UnitT>::curve_to (point_type const & c1
+template <typename UnitT, typename Allocator>
+void path<UnitT, Allocator>::curve_to (point_type const & c1
         , point_type const & c2
         , point_type const & ep
         , bool is_relative)
@@ -418,8 +467,8 @@ void path<UnitT>::curve_to (point_type const & c1
     }
 }
 
-template <typename UnitT>
-void path<UnitT>::curve_to (point_type const & ctl_point
+template <typename UnitT, typename Allocator>
+void path<UnitT, Allocator>::curve_to (point_type const & ctl_point
             , point_type const & end_point
             , bool is_relative)
 {
@@ -456,10 +505,10 @@ void path<UnitT>::curve_to (point_type const & ctl_point
     // Note: Qt5 (may be Qt4 too) uses another formula
     // (see QPainterPath::quadTo() implementation)
     //
-    unit_type c1x = sp.get_x() + 2 * (cp.get_x() - sp.get_x()) / 3;
-    unit_type c1y = sp.get_y() + 2 * (cp.get_y() - sp.get_y()) / 3;
-    unit_type c2x = cp.get_x() +     (ep.get_x() - cp.get_x()) / 3;
-    unit_type c2y = cp.get_y() +     (ep.get_y() - cp.get_y()) / 3;
+    unit_type c1x = sp.x() + 2 * (cp.x() - sp.x()) / 3;
+    unit_type c1y = sp.y() + 2 * (cp.y() - sp.y()) / 3;
+    unit_type c2x = cp.x() +     (ep.x() - cp.x()) / 3;
+    unit_type c2y = cp.y() +     (ep.y() - cp.y()) / 3;
 
     curve_to(point_type{c1x, c1y}, point_type{c2x, c2y}, ep, false);
 }
@@ -467,8 +516,8 @@ void path<UnitT>::curve_to (point_type const & ctl_point
 /**
  * @return Calculated bounding rectangle of painter path @a apath.
  */
-template <typename UnitT>
-rect<UnitT> bounding_rect (path<UnitT> const & apath)
+template <typename UnitT, typename Allocator>
+rect<UnitT> bounding_rect (path<UnitT, Allocator> const & apath)
 {
     using rect_type = rect<UnitT>;
     rect_type r;
@@ -486,16 +535,44 @@ rect<UnitT> bounding_rect (path<UnitT> const & apath)
  *        bounding_rect(), and the returned rectangle is always a superset
  *        of the rectangle returned by bounding_rect().
  */
-template <typename UnitT>
-rect<UnitT> control_point_rect (path<UnitT> const & apath)
+template <typename UnitT, typename Allocator>
+rect<UnitT> control_point_rect (path<UnitT, Allocator> const & apath)
 {
-    using rect_type = rect<UnitT>;
-    rect_type r;
+    using rect_type  = rect<UnitT>;
+    using point_type = point<UnitT>;
 
-    // TODO Implement control_point_rect()
     // see qt5/qtbase/src/gui/painting/qpainterpath.cpp:computeControlPointRect()
+    auto first = apath.cbegin();
+    auto last  = apath.cend();
+
+    if (first == last)
+        return rect_type{};
+
+    UnitT minx = first->p.x();
+    UnitT miny = first->p.y();
+    UnitT maxx = minx;
+    UnitT maxy = miny;
+
+    for (++first; first != last; ++first) {
+        // Point of 'close_path' entry is meaningless
+        if (first->type == path_entry_enum::close_path)
+            continue;
+
+        UnitT x = first->p.x();
+        UnitT y = first->p.y();
+
+        if (x < minx)
+            minx = x;
+        else if (x > maxx)
+            maxx = x;
+
+        if (y < miny)
+            miny = y;
+        else if (y > maxy)
+            maxy = y;
+    }
 
-    return r;
+    return rect_type{point_type{minx, miny}, point_type{maxx, maxy}};
 }
 
 }} // namespace pfs::griotte
@@ -1,4 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <pfs/griotte/color.hpp>
 
@@ -22,19 +30,169 @@ enum class join_style : int
     , bevel         ///< A rounded line end.
 };
 
+/**
+ * @class dash_view
+ * @brief Read-only view of a pen dash array.
+ */
+template <typename UnitT>
+class dash_view
+{
+public:
+    using value_type = UnitT;
+    using const_iterator = value_type const *;
+
+private:
+    value_type const * _data;
+    std::size_t _size;
+
+public:
+    constexpr dash_view (value_type const * data, std::size_t size) noexcept
+        : _data(data)
+        , _size(size)
+    {}
+
+    constexpr const_iterator begin () const noexcept { return _data; }
+    constexpr const_iterator end () const noexcept { return _data + _size; }
+    constexpr value_type const * data () const noexcept { return _data; }
+    constexpr std::size_t size () const noexcept { return _size; }
+    constexpr bool empty () const noexcept { return _size == 0; }
+
+    constexpr value_type operator [] (std::size_t i) const noexcept
+    {
+        return _data[i];
+    }
+};
+
+/**
+ * @class dash_pattern_pool
+ * @brief Process-wide storage of interned dash patterns that do not fit
+ *        into the pen.
+ *
+ * Equal patterns share the same storage, patterns live until the program
+ * exits.
+ */
+template <typename UnitT, typename dummy = void>
+class dash_pattern_pool
+{
+    struct entry
+    {
+        std::unique_ptr<UnitT[]> data;
+        std::size_t size;
+    };
+
+    static std::mutex _mtx;
+    static std::unordered_multimap<std::size_t, entry> _patterns;
+
+public:
+    /**
+     * @return Pointer to the interned copy of pattern [@a first, @a first + @a size)
+     *         with hash @a hash.
+     */
+    static UnitT const * intern (UnitT const * first, std::size_t size, std::size_t hash)
+    {
+        std::lock_guard<std::mutex> locker {_mtx};
+        auto range = _patterns.equal_range(hash);
+
+        for (auto it = range.first; it != range.second; ++it) {
+            entry const & e = it->second;
+
+            if (e.size == size && std::equal(first, first + size, e.data.get()))
+                return e.data.get();
+        }
+
+        std::unique_ptr<UnitT[]> data {new UnitT[size]};
+        std::copy(first, first + size, data.get());
+        UnitT const * result = data.get();
+        _patterns.emplace(hash, entry{std::move(data), size});
+        return result;
+    }
+
+    /**
+     * @return Number of interned patterns.
+     */
+    static std::size_t size ()
+    {
+        std::lock_guard<std::mutex> locker {_mtx};
+        return _patterns.size();
+    }
+};
+
+template <typename UnitT, typename dummy>
+std::mutex dash_pattern_pool<UnitT, dummy>::_mtx;
+
+template <typename UnitT, typename dummy>
+std::unordered_multimap<std::size_t, typename dash_pattern_pool<UnitT, dummy>::entry>
+dash_pattern_pool<UnitT, dummy>::_patterns;
+
+/**
+ * @class pen
+ * @brief Stroke attributes.
+ *
+ * Pen is a trivially copyable value: dash arrays of up to
+ * @c inline_dash_capacity entries are stored inside the pen, longer ones are
+ * interned in dash_pattern_pool. So copying a pen never allocates and two
+ * pens with longer equal patterns refer to the same storage.
+ */
 template <typename UnitT>
 class pen
 {
 public:
     using unit_type = UnitT;
-    using dasharray_type = std::vector<unit_type>;
+    using dasharray_type = dash_view<unit_type>;
+
+    static constexpr std::size_t inline_dash_capacity = 8;
 
 private:
     color          _color;
-    int            _width;
     cap_style      _cap;
     join_style     _join;
-    dasharray_type _dasharray; // empty means solid line
+    unit_type      _width;
+    unit_type      _dash_period {0};
+    unit_type      _dash_offset {0};
+    std::uint32_t  _dash_count {0}; // zero means solid line
+    std::size_t    _dash_hash {0};
+
+    union {
+        unit_type         _dashes[inline_dash_capacity];
+        unit_type const * _interned;
+    };
+
+private:
+    static std::size_t hash_pattern (unit_type const * first, std::size_t size)
+    {
+        std::size_t h = size;
+        std::hash<unit_type> hasher;
+
+        for (std::size_t i = 0; i < size; i++)
+            h ^= hasher(first[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+
+        return h;
+    }
+
+    unit_type const * dash_data () const noexcept
+    {
+        return _dash_count > inline_dash_capacity ? _interned : _dashes;
+    }
+
+    void assign_dashes (unit_type const * first, std::size_t size)
+    {
+        _dash_count = static_cast<std::uint32_t>(size);
+        _dash_hash = size > 0 ? hash_pattern(first, size) : 0;
+        _dash_period = 0;
+
+        for (std::size_t i = 0; i < size; i++)
+            _dash_period += first[i];
+
+        // Odd number of values is repeated to yield an even number of values
+        // (as in SVG stroke-dasharray)
+        if (size % 2)
+            _dash_period += _dash_period;
+
+        if (size > inline_dash_capacity)
+            _interned = dash_pattern_pool<unit_type>::intern(first, size, _dash_hash);
+        else
+            std::copy(first, first + size, _dashes);
+    }
 
 public:
     /**
@@ -42,22 +200,24 @@ public:
      */
     pen () noexcept
         : _color{0, 0, 0, 0}
-        , _width{0}
         , _cap{cap_style::butt}
         , _join{join_style::miter}
+        , _width{0}
+        , _interned{nullptr}
     {}
 
     /**
-     * @brief Constructs a path with start point at @a start.
+     * @brief Constructs a solid stroke.
      */
     pen (color const & acolor
             , unit_type width = 1
             , cap_style acap = cap_style::butt
             , join_style ajoin = join_style::miter) noexcept
         : _color{acolor}
-        , _width{width}
         , _cap{acap}
         , _join{ajoin}
+        , _width{width}
+        , _interned{nullptr}
     {}
 
     ~pen () = default;
@@ -71,7 +231,7 @@ public:
         return _color;
     }
 
-    constexpr inline int get_width () const
+    constexpr inline unit_type get_width () const
     {
         return _width;
     }
@@ -86,25 +246,99 @@ public:
         return _join;
     }
 
-    constexpr inline dasharray_type const & get_dasharray () const
+    /**
+     * @return View of the dash array, empty for solid line.
+     */
+    inline dasharray_type get_dasharray () const noexcept
+    {
+        return dasharray_type{dash_data(), _dash_count};
+    }
+
+    /**
+     * @return Length of the full dash pattern (the dash array is repeated
+     *         twice if it has odd number of values), zero for solid line.
+     */
+    constexpr inline unit_type get_dash_period () const
+    {
+        return _dash_period;
+    }
+
+    /**
+     * @return Distance into the dash pattern at which strokes start.
+     */
+    constexpr inline unit_type get_dash_offset () const
     {
-        return _dasharray;
+        return _dash_offset;
     }
 
-    inline void set_dasharray (std::initializer_list<unit_type> dashes) const
+    inline void set_dash_offset (unit_type offset) noexcept
     {
-        _dasharray = dashes;
+        _dash_offset = offset;
+    }
+
+    /**
+     * @return Hash of the dash array.
+     */
+    constexpr inline std::size_t get_dash_hash () const
+    {
+        return _dash_hash;
+    }
+
+    inline void set_dasharray (unit_type const * dashes, std::size_t size)
+    {
+        assign_dashes(dashes, size);
+    }
+
+    inline void set_dasharray (std::initializer_list<unit_type> dashes)
+    {
+        assign_dashes(dashes.begin(), dashes.size());
     }
 
     inline void add_dash (unit_type x)
     {
-        _dasharray.push_back(x);
+        std::size_t n = _dash_count;
+
+        if (n < inline_dash_capacity) {
+            unit_type dashes[inline_dash_capacity];
+            std::copy(_dashes, _dashes + n, dashes);
+            dashes[n] = x;
+            assign_dashes(dashes, n + 1);
+        } else {
+            std::vector<unit_type> dashes(dash_data(), dash_data() + n);
+            dashes.push_back(x);
+            assign_dashes(dashes.data(), dashes.size());
+        }
+    }
+
+    inline void clear_dasharray () noexcept
+    {
+        _dash_count = 0;
+        _dash_hash = 0;
+        _dash_period = 0;
     }
 
-    inline void clear_dasharray ()
+    bool operator == (pen const & rhs) const noexcept
     {
-        _dasharray.clear();
+        if (!(_color == rhs._color && _width == rhs._width
+                && _cap == rhs._cap && _join == rhs._join
+                && _dash_count == rhs._dash_count && _dash_hash == rhs._dash_hash
+                && _dash_offset == rhs._dash_offset))
+            return false;
+
+        // Interned patterns are unique
+        if (_dash_count > inline_dash_capacity)
+            return _interned == rhs._interned;
+
+        return std::equal(_dashes, _dashes + _dash_count, rhs._dashes);
+    }
+
+    bool operator != (pen const & rhs) const noexcept
+    {
+        return !(*this == rhs);
     }
 };
 
+template <typename UnitT>
+constexpr std::size_t pen<UnitT>::inline_dash_capacity;
+
 }} // namespace pfs::griotte
@@ -1,9 +1,28 @@
 #pragma once
 #include <cmath>
+#include <type_traits>
 
 namespace pfs {
 namespace griotte {
 
+namespace details {
+
+// Integer coordinates are rounded to the nearest integer
+template <typename UnitT, typename FactorT>
+inline UnitT scale_unit (UnitT v, FactorT factor, std::true_type /*is_integral*/) noexcept
+{
+    return static_cast<UnitT>(std::round(v * factor));
+}
+
+// Floating and fixed point coordinates are scaled with their own precision
+template <typename UnitT, typename FactorT>
+inline UnitT scale_unit (UnitT v, FactorT factor, std::false_type /*is_integral*/) noexcept
+{
+    return static_cast<UnitT>(v * factor);
+}
+
+} // namespace details
+
 template <typename UnitT>
 class point
 {
@@ -121,8 +140,8 @@ public:
      */
     inline point & operator *= (float factor) noexcept
     {
-        _x = static_cast<unit_type>(std::round(_x * factor));
-        _y = static_cast<unit_type>(std::round(_y * factor));
+        _x = details::scale_unit(_x, factor, std::is_integral<unit_type>{});
+        _y = details::scale_unit(_y, factor, std::is_integral<unit_type>{});
         return *this;
     }
 
@@ -132,8 +151,8 @@ public:
      */
     inline point & operator *= (double factor) noexcept
     {
-        _x = static_cast<unit_type>(std::round(_x * factor));
-        _y = static_cast<unit_type>(std::round(_y * factor));
+        _x = details::scale_unit(_x, factor, std::is_integral<unit_type>{});
+        _y = details::scale_unit(_y, factor, std::is_integral<unit_type>{});
         return *this;
     }
 
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <pfs/griotte/point.hpp>
 
 namespace pfs {
 namespace griotte {
@@ -7,6 +9,7 @@ template <typename UnitT>
 class rect
 {
     using unit_type = UnitT;
+    using point_type = point<unit_type>;
 
     unit_type _x1;
     unit_type _y1;
@@ -38,6 +41,18 @@ public:
         , _y2(y + height - 1)
     {}
 
+    /**
+     * @brief Constructs a rectangle with the given @a top_left and
+     *        @a bottom_right corners.
+     */
+    constexpr rect (point_type const & top_left
+                , point_type const & bottom_right) noexcept
+        : _x1(top_left.x())
+        , _y1(top_left.y())
+        , _x2(bottom_right.x())
+        , _y2(bottom_right.y())
+    {}
+
     ~rect () = default;
     rect (rect const & rhs) = default;
     rect & operator = (rect const & rhs) = default;
@@ -76,6 +91,40 @@ public:
         return _y2 - _y1 + 1;
     }
 
+    /**
+     * @return The x-coordinate of the rectangle's right edge.
+     */
+    constexpr inline unit_type get_right () const noexcept
+    {
+        return _x2;
+    }
+
+    /**
+     * @return The y-coordinate of the rectangle's bottom edge.
+     */
+    constexpr inline unit_type get_bottom () const noexcept
+    {
+        return _y2;
+    }
+
+    /**
+     * @return @c true if the rectangle is empty, otherwise returns @c false.
+     *         An empty rectangle has a left() > right() or top() > bottom().
+     */
+    constexpr inline bool is_empty () const noexcept
+    {
+        return _x1 > _x2 || _y1 > _y2;
+    }
+
+    /**
+     * @return @c true if the rectangle is valid, otherwise returns @c false.
+     *         A valid rectangle has a left() <= right() and top() <= bottom().
+     */
+    constexpr inline bool is_valid () const noexcept
+    {
+        return _x1 <= _x2 && _y1 <= _y2;
+    }
+
     /**
      * @return @c true if the point (@a x, @a y) is inside this rectangle
      *         including on the edge, otherwise returns @c false.
@@ -101,6 +150,94 @@ public:
                 || y <= _y1
                 || y >= _y2) ? false : true;
     }
+
+    /**
+     * @return @c true if the point @a p is inside this rectangle
+     *         including on the edge, otherwise returns @c false.
+     */
+    constexpr inline bool contains (point_type const & p) const noexcept
+    {
+        return contains(p.x(), p.y());
+    }
+
+    /**
+     * @return @c true if the given rectangle @a r is inside this rectangle
+     *         including on the edge, otherwise returns @c false.
+     */
+    constexpr inline bool contains (rect const & r) const noexcept
+    {
+        return (r._x1 < _x1
+                || r._x2 > _x2
+                || r._y1 < _y1
+                || r._y2 > _y2) ? false : true;
+    }
+
+    /**
+     * @return @c true if this rectangle intersects with the given rectangle
+     *         @a r (i.e., there is at least one pixel that is within both
+     *         rectangles), otherwise returns @c false.
+     */
+    constexpr inline bool intersects (rect const & r) const noexcept
+    {
+        return (r._x2 < _x1
+                || r._x1 > _x2
+                || r._y2 < _y1
+                || r._y1 > _y2) ? false : true;
+    }
+
+    /**
+     * @return The bounding rectangle of this rectangle and the given
+     *         rectangle @a r.
+     * @note Empty rectangles are ignored.
+     */
+    inline rect united (rect const & r) const noexcept
+    {
+        if (is_empty())
+            return r;
+
+        if (r.is_empty())
+            return *this;
+
+        return rect{point_type{(std::min)(_x1, r._x1), (std::min)(_y1, r._y1)}
+                , point_type{(std::max)(_x2, r._x2), (std::max)(_y2, r._y2)}};
+    }
+
+    /**
+     * @return The intersection of this rectangle and the given rectangle
+     *         @a r, or an empty rectangle if they do not intersect.
+     */
+    inline rect intersected (rect const & r) const noexcept
+    {
+        if (!intersects(r))
+            return rect{};
+
+        return rect{point_type{(std::max)(_x1, r._x1), (std::max)(_y1, r._y1)}
+                , point_type{(std::min)(_x2, r._x2), (std::min)(_y2, r._y2)}};
+    }
+
+    /**
+     * @return A new rectangle with @a dx1, @a dy1, @a dx2 and @a dy2 added
+     *         respectively to the existing coordinates of this rectangle.
+     */
+    constexpr inline rect adjusted (unit_type dx1
+            , unit_type dy1
+            , unit_type dx2
+            , unit_type dy2) const noexcept
+    {
+        return rect{point_type{_x1 + dx1, _y1 + dy1}
+                , point_type{_x2 + dx2, _y2 + dy2}};
+    }
+
+    constexpr inline bool operator == (rect const & rhs) const noexcept
+    {
+        return _x1 == rhs._x1 && _y1 == rhs._y1
+                && _x2 == rhs._x2 && _y2 == rhs._y2;
+    }
+
+    constexpr inline bool operator != (rect const & rhs) const noexcept
+    {
+        return ! operator == (rhs);
+    }
 };
 
 }} // namespace pfs::griotte
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.13 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/glyph_atlas.hpp"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+#include FT_LCD_FILTER_H
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Hinting and anti-aliasing mode of glyph rasterization.
+ */
+enum class render_mode : std::uint8_t
+{
+      light  ///< Anti-aliased, vertical hinting only (allows subpixel positioning)
+    , normal ///< Anti-aliased, full hinting
+    , mono   ///< Not anti-aliased (1 bit), full hinting, e.g. tiny text of embedded panels
+    , lcd    ///< Horizontal RGB subpixel rendering
+    , lcd_v  ///< Vertical RGB subpixel rendering
+};
+
+/**
+ * @return FT_LOAD_TARGET_XXX flags of @a mode.
+ */
+inline FT_Int32 load_flags (render_mode mode) noexcept
+{
+    switch (mode) {
+        case render_mode::light:  return FT_LOAD_TARGET_LIGHT;
+        case render_mode::normal: return FT_LOAD_TARGET_NORMAL;
+        case render_mode::mono:   return FT_LOAD_TARGET_MONO;
+        case render_mode::lcd:    return FT_LOAD_TARGET_LCD;
+        case render_mode::lcd_v:  return FT_LOAD_TARGET_LCD_V;
+    }
+
+    return FT_LOAD_DEFAULT;
+}
+
+/**
+ * @return FreeType render mode of @a mode.
+ */
+inline FT_Render_Mode ft_render_mode (render_mode mode) noexcept
+{
+    switch (mode) {
+        case render_mode::light:  return FT_RENDER_MODE_LIGHT;
+        case render_mode::normal: return FT_RENDER_MODE_NORMAL;
+        case render_mode::mono:   return FT_RENDER_MODE_MONO;
+        case render_mode::lcd:    return FT_RENDER_MODE_LCD;
+        case render_mode::lcd_v:  return FT_RENDER_MODE_LCD_V;
+    }
+
+    return FT_RENDER_MODE_NORMAL;
+}
+
+/**
+ * @brief Renders glyph loaded into @a slot (with load_flags() of @a mode)
+ *        by @a mode.
+ *
+ * Subpixel modes use the default LCD filter against color fringes.
+ *
+ * @return @c false on error.
+ */
+inline bool render_glyph (FT_GlyphSlot slot, render_mode mode)
+{
+    if (mode == render_mode::lcd || mode == render_mode::lcd_v) {
+        // Fails if FreeType is built without subpixel rendering (glyphs are
+        // rendered unfiltered then)
+        FT_Library_SetLcdFilter(slot->library, FT_LCD_FILTER_DEFAULT);
+    }
+
+    return FT_Render_Glyph(slot, ft_render_mode(mode)) == 0;
+}
+
+/**
+ * @brief Converts rendered @a bitmap into atlas pixels.
+ *
+ * Gray bitmaps are used as is, mono bitmaps are expanded to coverage
+ * (0 or 255). Subpixel bitmaps are packed into pixels of atlas_format::lcd
+ * (R, G and B coverages, alpha is the largest of them).
+ *
+ * @return Pixels (@a bitmap buffer or @a scratch) or @c nullptr if the pixel
+ *         mode is not supported (e.g. BGRA).
+ */
+inline std::uint8_t const * convert_bitmap (FT_Bitmap const & bitmap
+    , std::vector<std::uint8_t> & scratch
+    , int & width, int & height, int & pitch, atlas_format & format)
+{
+    int w = static_cast<int>(bitmap.width);
+    int h = static_cast<int>(bitmap.rows);
+    std::uint8_t const * src = bitmap.buffer;
+
+    switch (bitmap.pixel_mode) {
+        case FT_PIXEL_MODE_GRAY:
+            width = w;
+            height = h;
+            pitch = bitmap.pitch;
+            format = atlas_format::coverage;
+            return src;
+
+        case FT_PIXEL_MODE_MONO: {
+            scratch.resize(static_cast<std::size_t>(w) * h);
+
+            for (int y = 0; y < h; y++) {
+                std::uint8_t const * row = src + static_cast<std::ptrdiff_t>(y) * bitmap.pitch;
+
+                for (int x = 0; x < w; x++)
+                    scratch[static_cast<std::size_t>(y) * w + x] = (row[x >> 3] & (0x80 >> (x & 7))) ? 0xFF : 0;
+            }
+
+            width = w;
+            height = h;
+            pitch = w;
+            format = atlas_format::coverage;
+            return scratch.data();
+        }
+
+        case FT_PIXEL_MODE_LCD:
+        case FT_PIXEL_MODE_LCD_V: {
+            bool vertical = bitmap.pixel_mode == FT_PIXEL_MODE_LCD_V;
+
+            // Subpixels are adjacent bytes (LCD) or rows (LCD_V)
+            width = vertical ? w : w / 3;
+            height = vertical ? h / 3 : h;
+            pitch = width * 4;
+            format = atlas_format::lcd;
+            scratch.resize(static_cast<std::size_t>(pitch) * height);
+
+            std::ptrdiff_t step = vertical ? bitmap.pitch : 1;
+
+            for (int y = 0; y < height; y++) {
+                std::uint8_t const * row = src
+                    + static_cast<std::ptrdiff_t>(vertical ? 3 * y : y) * bitmap.pitch;
+                std::uint8_t * d = & scratch[static_cast<std::size_t>(y) * pitch];
+
+                for (int x = 0; x < width; x++, d += 4) {
+                    std::uint8_t const * s = row + (vertical ? x : 3 * x);
+                    d[0] = s[0];
+                    d[1] = s[step];
+                    d[2] = s[2 * step];
+                    d[3] = (std::max)(d[0], (std::max)(d[1], d[2]));
+                }
+            }
+
+            return scratch.data();
+        }
+
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+}} // namespace pfs::griotte
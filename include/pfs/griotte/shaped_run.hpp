@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.04 Initial version
+//      2021.07.06 Hashing helpers moved into details.
+//      2021.07.13 Runs are keyed by font instance.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/fixed.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief ISO 15924 script tag (the same values as hb_script_t),
+ *        zero means the script is guessed from the text.
+ */
+using script_tag = std::uint32_t;
+
+constexpr script_tag make_script_tag (char c1, char c2, char c3, char c4) noexcept
+{
+    return static_cast<script_tag>(static_cast<std::uint8_t>(c1)) << 24
+        | static_cast<script_tag>(static_cast<std::uint8_t>(c2)) << 16
+        | static_cast<script_tag>(static_cast<std::uint8_t>(c3)) << 8
+        | static_cast<script_tag>(static_cast<std::uint8_t>(c4));
+}
+
+enum class text_direction : std::uint8_t
+{
+      automatic ///< Guessed from the script
+    , ltr       ///< Left to right
+    , rtl       ///< Right to left
+    , ttb       ///< Top to bottom
+    , btt       ///< Bottom to top
+};
+
+namespace details {
+
+inline std::size_t hash_combine (std::size_t seed, std::size_t v) noexcept
+{
+    return seed ^ (v + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+// FNV-1a
+inline std::size_t hash_bytes (char const * data, std::size_t len) noexcept
+{
+    std::uint64_t h = 14695981039346656037ull;
+
+    for (std::size_t i = 0; i < len; i++) {
+        h ^= static_cast<std::uint8_t>(data[i]);
+        h *= 1099511628211ull;
+    }
+
+    return static_cast<std::size_t>(h);
+}
+
+// Instance identifier of a font providing get_id() (see font_instance),
+// zero for other fonts
+template <typename Font>
+auto font_instance_id (Font const & f, int) -> decltype(static_cast<std::uint32_t>(f.get_id()))
+{
+    return static_cast<std::uint32_t>(f.get_id());
+}
+
+template <typename Font>
+std::uint32_t font_instance_id (Font const &, long)
+{
+    return 0;
+}
+
+} // namespace details
+
+/**
+ * @brief Positioned glyph of a shaped run (positions in pixels).
+ */
+struct shaped_glyph
+{
+    std::uint32_t glyph_index; ///< Glyph index in the font (not a codepoint)
+    std::uint32_t cluster;     ///< Byte offset of the first character in the text
+    fixed26_6     x_advance;
+    fixed26_6     y_advance;
+    fixed26_6     x_offset;
+    fixed26_6     y_offset;
+};
+
+/**
+ * @brief Result of shaping a text with a font.
+ */
+struct shaped_run
+{
+    std::vector<shaped_glyph> glyphs;
+    fixed26_6 x_advance; ///< Sum of glyph advances
+    fixed26_6 y_advance;
+    text_direction direction {text_direction::ltr}; ///< Resolved direction
+    script_tag script {0}; ///< Resolved script
+
+    void clear () noexcept
+    {
+        glyphs.clear();
+        x_advance = fixed26_6{};
+        y_advance = fixed26_6{};
+    }
+};
+
+/**
+ * @class shaped_run_cache
+ * @brief LRU cache of shaped runs keyed by (font, instance, pixel size,
+ *        text, script, direction).
+ *
+ * Repeated strings (labels, menus, axis ticks) are shaped once: a hit
+ * costs hashing of the text and does not allocate. Cached runs are shared,
+ * so a run stays valid while referenced even if evicted.
+ *
+ * @a Shaper must provide
+ * @code
+ * void shape (Font const & f, int pixel_size, char const * text, std::size_t len
+ *     , script_tag script, text_direction direction, shaped_run & out);
+ * @endcode
+ * and the font must provide native_handle() identifying it. Fonts sharing
+ * a face with different variation coordinates (see font_instance) must
+ * also provide get_id() identifying the instance.
+ *
+ * @note Not thread-safe.
+ */
+template <typename Shaper>
+class shaped_run_cache
+{
+public:
+    using run_pointer = std::shared_ptr<shaped_run const>;
+
+private:
+    struct entry
+    {
+        std::size_t    hash;
+        void const *   font_id;
+        std::uint32_t  instance_id;
+        int            pixel_size;
+        script_tag     script;
+        text_direction direction;
+        std::string    text;
+        run_pointer    run;
+    };
+
+    using entry_list = std::list<entry>;
+
+    Shaper * _shaper;
+    std::size_t _capacity;
+    entry_list _entries; // most recently used first
+    std::unordered_map<std::size_t, typename entry_list::iterator> _index;
+    std::size_t _hits {0};
+    std::size_t _misses {0};
+
+private:
+    void erase (typename entry_list::iterator it)
+    {
+        auto pos = _index.find(it->hash);
+
+        if (pos != _index.end() && pos->second == it)
+            _index.erase(pos);
+
+        _entries.erase(it);
+    }
+
+public:
+    /**
+     * @param capacity Maximum number of cached runs.
+     */
+    shaped_run_cache (Shaper & ashaper, std::size_t capacity = 1024)
+        : _shaper(& ashaper)
+        , _capacity(capacity > 0 ? capacity : 1)
+    {}
+
+    std::size_t size () const noexcept
+    {
+        return _entries.size();
+    }
+
+    std::size_t capacity () const noexcept
+    {
+        return _capacity;
+    }
+
+    std::size_t hits () const noexcept
+    {
+        return _hits;
+    }
+
+    std::size_t misses () const noexcept
+    {
+        return _misses;
+    }
+
+    void clear ()
+    {
+        _index.clear();
+        _entries.clear();
+    }
+
+    /**
+     * @brief Removes runs shaped with font @a f and all its instances (must
+     *        be called before the font is destroyed, since its handle may be
+     *        reused).
+     */
+    template <typename Font>
+    void invalidate (Font const & f)
+    {
+        void const * font_id = f.native_handle();
+
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            auto next = std::next(it);
+
+            if (it->font_id == font_id)
+                erase(it);
+
+            it = next;
+        }
+    }
+
+    /**
+     * @return Run of @a text (UTF-8) shaped with font @a f of @a pixel_size.
+     */
+    template <typename Font>
+    run_pointer shape (Font const & f
+        , int pixel_size
+        , char const * text
+        , std::size_t len
+        , script_tag script = 0
+        , text_direction direction = text_direction::automatic);
+
+    template <typename Font>
+    run_pointer shape (Font const & f
+        , int pixel_size
+        , std::string const & text
+        , script_tag script = 0
+        , text_direction direction = text_direction::automatic)
+    {
+        return shape(f, pixel_size, text.data(), text.size(), script, direction);
+    }
+};
+
+template <typename Shaper>
+template <typename Font>
+typename shaped_run_cache<Shaper>::run_pointer
+shaped_run_cache<Shaper>::shape (Font const & f
+    , int pixel_size
+    , char const * text
+    , std::size_t len
+    , script_tag script
+    , text_direction direction)
+{
+    void const * font_id = f.native_handle();
+    std::uint32_t instance_id = details::font_instance_id(f, 0);
+
+    std::size_t h = details::hash_bytes(text, len);
+    h = details::hash_combine(h, std::hash<void const *>{}(font_id));
+    h = details::hash_combine(h, static_cast<std::size_t>(instance_id));
+    h = details::hash_combine(h, static_cast<std::size_t>(pixel_size));
+    h = details::hash_combine(h, static_cast<std::size_t>(script));
+    h = details::hash_combine(h, static_cast<std::size_t>(direction));
+
+    auto pos = _index.find(h);
+
+    if (pos != _index.end()) {
+        entry const & e = *pos->second;
+
+        if (e.font_id == font_id && e.instance_id == instance_id
+                && e.pixel_size == pixel_size
+                && e.script == script && e.direction == direction
+                && e.text.size() == len
+                && (len == 0 || std::memcmp(e.text.data(), text, len) == 0)) {
+            ++_hits;
+
+            // Move to front
+            _entries.splice(_entries.begin(), _entries, pos->second);
+            return e.run;
+        }
+
+        // Hash collision: the slot is reused for the new text
+        erase(pos->second);
+    }
+
+    ++_misses;
+
+    auto run = std::make_shared<shaped_run>();
+    _shaper->shape(f, pixel_size, text, len, script, direction, *run);
+
+    if (_entries.size() >= _capacity)
+        erase(std::prev(_entries.end()));
+
+    _entries.push_front(entry{h, font_id, instance_id, pixel_size, script, direction
+        , std::string{text, len}, run});
+    _index[h] = _entries.begin();
+
+    return run;
+}
+
+}} // namespace pfs::griotte
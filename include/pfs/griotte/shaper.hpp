@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.04 Initial version
+//      2021.07.13 Shaping with font instances.
+//      2021.07.13 Fail early when HarfBuzz is not enabled.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/error.hpp"
+#include "pfs/griotte/font.hpp"
+#include "pfs/griotte/noncopyable.hpp"
+#include "pfs/griotte/shaped_run.hpp"
+
+#if !defined(PFS_GRIOTTE_HAVE_HARFBUZZ)
+#   error "pfs/griotte/shaper.hpp requires HarfBuzz: configure with -Dpfs-griotte_ENABLE_HARFBUZZ=ON (sources are expected in 3rdparty/harfbuzz)"
+#endif
+
+#include <hb.h>
+#include <hb-ft.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class shaper
+ * @brief Text shaper backed by HarfBuzz.
+ *
+ * Converts UTF-8 text into positioned glyphs applying kerning, ligatures
+ * and complex script rules of the font (OpenType GSUB/GPOS tables).
+ * HarfBuzz fonts are created once per FreeType face and reused, the glyph
+ * buffer is reused by every call. Instances of a variable font share the
+ * HarfBuzz font of the face, it is synchronized with the face when the
+ * pixel size or the active instance changes.
+ *
+ * @note Not thread-safe: use one shaper per thread. HarfBuzz fonts refer to
+ *       the faces, so fonts must outlive the shaper or be released by
+ *       release().
+ */
+class shaper : public noncopyable
+{
+    struct font_entry
+    {
+        FT_Face       face;
+        hb_font_t *   hbfont;
+        int           pixel_size;
+        std::uint32_t instance_id;
+    };
+
+    hb_buffer_t * _buffer {nullptr};
+    std::vector<font_entry> _fonts;
+
+private:
+    static hb_direction_t native_direction (text_direction direction) noexcept
+    {
+        switch (direction) {
+            case text_direction::ltr: return HB_DIRECTION_LTR;
+            case text_direction::rtl: return HB_DIRECTION_RTL;
+            case text_direction::ttb: return HB_DIRECTION_TTB;
+            case text_direction::btt: return HB_DIRECTION_BTT;
+            default:
+                break;
+        }
+
+        return HB_DIRECTION_INVALID;
+    }
+
+    static text_direction from_native_direction (hb_direction_t direction) noexcept
+    {
+        switch (direction) {
+            case HB_DIRECTION_RTL: return text_direction::rtl;
+            case HB_DIRECTION_TTB: return text_direction::ttb;
+            case HB_DIRECTION_BTT: return text_direction::btt;
+            default:
+                break;
+        }
+
+        return text_direction::ltr;
+    }
+
+    /**
+     * @return HarfBuzz font for instance @a fi scaled to @a pixel_size or
+     *         @c nullptr on error.
+     */
+    hb_font_t * native_font (font_instance const & fi, int pixel_size)
+    {
+        FT_Face face = fi.native_handle();
+        font_entry * e = nullptr;
+
+        for (auto & fe: _fonts) {
+            if (fe.face == face) {
+                e = & fe;
+                break;
+            }
+        }
+
+        if (!e) {
+            _fonts.push_back(font_entry{face, hb_ft_font_create_referenced(face), 0, 0});
+            e = & _fonts.back();
+        }
+
+        // The face is shared with glyph loading, so its size and variation
+        // coordinates are set every time, but the HarfBuzz font is
+        // synchronized only when they change
+        if (!fi.activate())
+            return nullptr;
+
+        if (FT_Set_Pixel_Sizes(face, 0, static_cast<FT_UInt>(pixel_size)) != 0)
+            return nullptr;
+
+        if (e->pixel_size != pixel_size || e->instance_id != fi.get_id()) {
+            hb_ft_font_changed(e->hbfont);
+            e->pixel_size = pixel_size;
+            e->instance_id = fi.get_id();
+        }
+
+        return e->hbfont;
+    }
+
+public:
+    shaper ()
+        : _buffer(hb_buffer_create())
+    {}
+
+    ~shaper ()
+    {
+        for (auto & fe: _fonts)
+            hb_font_destroy(fe.hbfont);
+
+        hb_buffer_destroy(_buffer);
+    }
+
+    /**
+     * @brief Releases resources associated with font @a f.
+     */
+    void release (font const & f)
+    {
+        for (auto it = _fonts.begin(); it != _fonts.end(); ++it) {
+            if (it->face == f.native_handle()) {
+                hb_font_destroy(it->hbfont);
+                _fonts.erase(it);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Shapes UTF-8 @a text of @a len bytes with font instance @a fi of
+     *        @a pixel_size into @a out.
+     *
+     * @param script Script of the text, zero to guess it from the text.
+     * @param direction Direction of the text, text_direction::automatic to
+     *        guess it from the script.
+     */
+    void shape (font_instance const & fi
+        , int pixel_size
+        , char const * text
+        , std::size_t len
+        , script_tag script
+        , text_direction direction
+        , shaped_run & out
+        , std::error_code & ec);
+
+    void shape (font_instance const & fi
+        , int pixel_size
+        , char const * text
+        , std::size_t len
+        , script_tag script
+        , text_direction direction
+        , shaped_run & out)
+    {
+        std::error_code ec;
+        shape(fi, pixel_size, text, len, script, direction, out, ec);
+
+        if (ec)
+            throw exception{ec};
+    }
+
+    /**
+     * @brief Shapes @a text with the default instance of font @a f.
+     */
+    void shape (font const & f
+        , int pixel_size
+        , char const * text
+        , std::size_t len
+        , script_tag script
+        , text_direction direction
+        , shaped_run & out
+        , std::error_code & ec)
+    {
+        shape(font_instance{f}, pixel_size, text, len, script, direction, out, ec);
+    }
+
+    void shape (font const & f
+        , int pixel_size
+        , char const * text
+        , std::size_t len
+        , script_tag script
+        , text_direction direction
+        , shaped_run & out)
+    {
+        shape(font_instance{f}, pixel_size, text, len, script, direction, out);
+    }
+};
+
+inline void shaper::shape (font_instance const & fi
+    , int pixel_size
+    , char const * text
+    , std::size_t len
+    , script_tag script
+    , text_direction direction
+    , shaped_run & out
+    , std::error_code & ec)
+{
+    out.clear();
+
+    hb_font_t * hbfont = native_font(fi, pixel_size);
+
+    if (!hbfont) {
+        ec = make_error_code(errc::freetype_error);
+        return;
+    }
+
+    hb_buffer_clear_contents(_buffer);
+    hb_buffer_add_utf8(_buffer, text, static_cast<int>(len), 0, static_cast<int>(len));
+
+    if (script != 0)
+        hb_buffer_set_script(_buffer, hb_script_from_iso15924_tag(script));
+
+    if (direction != text_direction::automatic)
+        hb_buffer_set_direction(_buffer, native_direction(direction));
+
+    // Fills properties that are not set (and the language)
+    hb_buffer_guess_segment_properties(_buffer);
+
+    hb_shape(hbfont, _buffer, nullptr, 0);
+
+    unsigned int count = 0;
+    hb_glyph_info_t const * infos = hb_buffer_get_glyph_infos(_buffer, & count);
+    hb_glyph_position_t const * positions = hb_buffer_get_glyph_positions(_buffer, & count);
+
+    out.glyphs.resize(count);
+
+    // With hb-ft fonts positions are in 26.6 pixels
+    for (unsigned int i = 0; i < count; i++) {
+        shaped_glyph & g = out.glyphs[i];
+        g.glyph_index = infos[i].codepoint;
+        g.cluster     = infos[i].cluster;
+        g.x_advance   = fixed26_6::from_raw(positions[i].x_advance);
+        g.y_advance   = fixed26_6::from_raw(positions[i].y_advance);
+        g.x_offset    = fixed26_6::from_raw(positions[i].x_offset);
+        g.y_offset    = fixed26_6::from_raw(positions[i].y_offset);
+
+        out.x_advance += g.x_advance;
+        out.y_advance += g.y_advance;
+    }
+
+    out.direction = from_native_direction(hb_buffer_get_direction(_buffer));
+    out.script = static_cast<script_tag>(hb_buffer_get_script(_buffer));
+}
+
+/**
+ * @brief Cache of runs shaped by HarfBuzz.
+ */
+using shaped_text_cache = shaped_run_cache<shaper>;
+
+}} // namespace pfs::griotte
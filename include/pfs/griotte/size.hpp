@@ -0,0 +1,80 @@
+#pragma once
+
+namespace pfs {
+namespace griotte {
+
+template <typename UnitT>
+class size
+{
+    using unit_type = UnitT;
+
+    unit_type _width;
+    unit_type _height;
+
+public:
+    /**
+     * @brief Constructs a size with zero width and height.
+     */
+    constexpr size () noexcept
+        : _width(0)
+        , _height(0)
+    {}
+
+    /**
+     * @brief Constructs a size with the given @a width and @a height.
+     */
+    constexpr size (unit_type width, unit_type height) noexcept
+        : _width(width)
+        , _height(height)
+    {}
+
+    ~size () = default;
+    size (size const & rhs) = default;
+    size & operator = (size const & rhs) = default;
+    size (size && rhs) = default;
+    size & operator = (size && rhs) = default;
+
+    /**
+     * @return The width.
+     */
+    constexpr inline unit_type get_width () const noexcept
+    {
+        return _width;
+    }
+
+    /**
+     * @return The height.
+     */
+    constexpr inline unit_type get_height () const noexcept
+    {
+        return _height;
+    }
+
+    /**
+     * @brief Sets the width to the given @a width.
+     */
+    inline void set_width (unit_type width) noexcept
+    {
+        _width = width;
+    }
+
+    /**
+     * @brief Sets the height to the given @a height.
+     */
+    inline void set_height (unit_type height) noexcept
+    {
+        _height = height;
+    }
+
+    constexpr inline bool operator == (size const & rhs) const noexcept
+    {
+        return _width == rhs._width && _height == rhs._height;
+    }
+
+    constexpr inline bool operator != (size const & rhs) const noexcept
+    {
+        return ! operator == (rhs);
+    }
+};
+
+}} // namespace pfs::griotte
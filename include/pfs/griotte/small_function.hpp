@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.23 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pfs {
+namespace griotte {
+
+template <typename Signature, std::size_t Capacity = 4 * sizeof(void *)>
+class small_function;
+
+/**
+ * @class small_function
+ * @brief Polymorphic function wrapper like std::function, but storing the
+ *        callable object inside the wrapper, so it never allocates memory.
+ *        Callables larger than @a Capacity are rejected at compile-time.
+ */
+template <typename R, typename ...Args, std::size_t Capacity>
+class small_function<R (Args...), Capacity>
+{
+    using storage_type = typename std::aligned_storage<Capacity>::type;
+
+    struct vtable
+    {
+        R    (* invoke) (void * callable, Args &&... args);
+        void (* copy) (void * dest, void const * src);
+        void (* move) (void * dest, void * src);
+        void (* destroy) (void * callable);
+    };
+
+    template <typename F>
+    struct vtable_for
+    {
+        static R invoke (void * callable, Args &&... args)
+        {
+            return (*static_cast<F *>(callable))(std::forward<Args>(args)...);
+        }
+
+        static void copy (void * dest, void const * src)
+        {
+            new (dest) F(*static_cast<F const *>(src));
+        }
+
+        static void move (void * dest, void * src)
+        {
+            new (dest) F(std::move(*static_cast<F *>(src)));
+        }
+
+        static void destroy (void * callable)
+        {
+            static_cast<F *>(callable)->~F();
+        }
+
+        static vtable const * get ()
+        {
+            static vtable const instance = { invoke, copy, move, destroy };
+            return & instance;
+        }
+    };
+
+    storage_type   _storage;
+    vtable const * _vtable {nullptr};
+
+public:
+    small_function () noexcept = default;
+
+    small_function (std::nullptr_t) noexcept {}
+
+    template <typename F
+        , typename Callable = typename std::decay<F>::type
+        , typename = typename std::enable_if<!std::is_same<Callable, small_function>::value>::type>
+    small_function (F && f)
+    {
+        static_assert(sizeof(Callable) <= Capacity
+            , "callable is too large for small_function storage");
+        static_assert(alignof(Callable) <= alignof(storage_type)
+            , "callable alignment is not supported by small_function storage");
+
+        new (& _storage) Callable(std::forward<F>(f));
+        _vtable = vtable_for<Callable>::get();
+    }
+
+    small_function (small_function const & rhs)
+    {
+        if (rhs._vtable) {
+            rhs._vtable->copy(& _storage, & rhs._storage);
+            _vtable = rhs._vtable;
+        }
+    }
+
+    small_function (small_function && rhs)
+    {
+        if (rhs._vtable) {
+            rhs._vtable->move(& _storage, & rhs._storage);
+            _vtable = rhs._vtable;
+            rhs.reset();
+        }
+    }
+
+    ~small_function ()
+    {
+        reset();
+    }
+
+    small_function & operator = (small_function const & rhs)
+    {
+        if (this != & rhs) {
+            reset();
+
+            if (rhs._vtable) {
+                rhs._vtable->copy(& _storage, & rhs._storage);
+                _vtable = rhs._vtable;
+            }
+        }
+
+        return *this;
+    }
+
+    small_function & operator = (small_function && rhs)
+    {
+        if (this != & rhs) {
+            reset();
+
+            if (rhs._vtable) {
+                rhs._vtable->move(& _storage, & rhs._storage);
+                _vtable = rhs._vtable;
+                rhs.reset();
+            }
+        }
+
+        return *this;
+    }
+
+    small_function & operator = (std::nullptr_t)
+    {
+        reset();
+        return *this;
+    }
+
+    template <typename F
+        , typename Callable = typename std::decay<F>::type
+        , typename = typename std::enable_if<!std::is_same<Callable, small_function>::value>::type>
+    small_function & operator = (F && f)
+    {
+        small_function tmp{std::forward<F>(f)};
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return _vtable != nullptr;
+    }
+
+    R operator () (Args... args) const
+    {
+        assert(_vtable);
+        return _vtable->invoke(const_cast<storage_type *>(& _storage)
+            , std::forward<Args>(args)...);
+    }
+
+    void reset () noexcept
+    {
+        if (_vtable) {
+            _vtable->destroy(& _storage);
+            _vtable = nullptr;
+        }
+    }
+};
+
+}} // namespace pfs::griotte
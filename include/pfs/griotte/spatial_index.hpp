@@ -0,0 +1,561 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.14 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <pfs/griotte/point.hpp>
+#include <pfs/griotte/rect.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+//
+// Dynamic AABB tree (bounding volume hierarchy).
+// Leaves hold the bounds of views/shapes enlarged by a margin ("fat" bounds),
+// so small moves and resizes do not restructure the tree. Internal nodes are
+// kept balanced by AVL-like rotations, so point and rect queries take
+// O(log n) on average.
+//
+// See [Box2D b2DynamicTree](https://github.com/erincatto/box2d/blob/main/src/collision/b2_dynamic_tree.cpp)
+//
+
+namespace pfs {
+namespace griotte {
+
+template <typename UnitT, typename T>
+class spatial_index
+{
+public:
+    using unit_type  = UnitT;
+    using value_type = T;
+    using point_type = point<unit_type>;
+    using rect_type  = rect<unit_type>;
+    using id_type    = int;
+
+    static constexpr id_type null_id = -1;
+
+private:
+    struct node
+    {
+        rect_type  fat;            // enlarged bounds (tree bounds for internal nodes)
+        rect_type  tight;          // item bounds (leaves only)
+        id_type    parent {null_id}; // parent or next free node if node is free
+        id_type    child1 {null_id};
+        id_type    child2 {null_id};
+        int        height {-1};    // 0 for leaves, -1 for free nodes
+        value_type value {};
+
+        bool is_leaf () const noexcept
+        {
+            return child1 == null_id;
+        }
+    };
+
+    std::vector<node> _nodes;
+    id_type   _root {null_id};
+    id_type   _free_list {null_id};
+    unit_type _margin {0};
+    std::size_t _count {0};
+
+public:
+    /**
+     * @brief Constructs empty spatial index.
+     * @param margin Enlargement of the item bounds stored in the tree. The tree
+     *        is not restructured while updated item bounds fit into the
+     *        enlarged ones.
+     */
+    spatial_index (unit_type margin = 0)
+        : _margin(margin)
+    {}
+
+    ~spatial_index () = default;
+    spatial_index (spatial_index const & rhs) = default;
+    spatial_index & operator = (spatial_index const & rhs) = default;
+    spatial_index (spatial_index && rhs) = default;
+    spatial_index & operator = (spatial_index && rhs) = default;
+
+    /**
+     * @return Number of items in the index.
+     */
+    std::size_t size () const noexcept
+    {
+        return _count;
+    }
+
+    bool empty () const noexcept
+    {
+        return _count == 0;
+    }
+
+    /**
+     * @return Height of the tree (@c 0 for an empty index or single item).
+     */
+    int height () const noexcept
+    {
+        return _root == null_id ? 0 : _nodes[_root].height;
+    }
+
+    /**
+     * @brief Removes all items from the index.
+     */
+    void clear ()
+    {
+        _nodes.clear();
+        _root = null_id;
+        _free_list = null_id;
+        _count = 0;
+    }
+
+    /**
+     * @brief Inserts item @a value with bounds @a r into the index.
+     * @return Item identifier, it remains valid until item removed.
+     */
+    id_type insert (rect_type const & r, value_type const & value);
+
+    /**
+     * @brief Updates bounds of the item @a id (moved or resized view/shape).
+     * @return @c true if the tree was restructured, @c false if new bounds
+     *         fit into the enlarged ones.
+     */
+    bool update (id_type id, rect_type const & r);
+
+    /**
+     * @brief Removes item @a id from the index.
+     */
+    void remove (id_type id);
+
+    /**
+     * @return Bounds of the item @a id.
+     */
+    rect_type const & bounds (id_type id) const
+    {
+        assert(id >= 0 && static_cast<std::size_t>(id) < _nodes.size());
+        assert(_nodes[id].is_leaf());
+        return _nodes[id].tight;
+    }
+
+    /**
+     * @return Value of the item @a id.
+     */
+    value_type const & value (id_type id) const
+    {
+        assert(id >= 0 && static_cast<std::size_t>(id) < _nodes.size());
+        assert(_nodes[id].is_leaf());
+        return _nodes[id].value;
+    }
+
+    /**
+     * @brief Calls @a f for each item which bounds contain point @a p.
+     * @param f Visitor with signature 'bool (id_type id, value_type const & value)'.
+     *        The query is stopped when the visitor returns @c false.
+     */
+    template <typename Visitor>
+    void query (point_type const & p, Visitor && f) const
+    {
+        query_if([& p] (rect_type const & r) { return r.contains(p); }
+            , std::forward<Visitor>(f));
+    }
+
+    /**
+     * @brief Calls @a f for each item which bounds intersect rectangle @a r.
+     * @param f Visitor with signature 'bool (id_type id, value_type const & value)'.
+     *        The query is stopped when the visitor returns @c false.
+     */
+    template <typename Visitor>
+    void query (rect_type const & r, Visitor && f) const
+    {
+        query_if([& r] (rect_type const & b) { return r.intersects(b); }
+            , std::forward<Visitor>(f));
+    }
+
+private:
+    template <typename Predicate, typename Visitor>
+    void query_if (Predicate && pred, Visitor && f) const;
+
+    id_type allocate_node ();
+    void free_node (id_type id);
+    void insert_leaf (id_type leaf);
+    void remove_leaf (id_type leaf);
+    id_type balance (id_type a);
+
+    rect_type enlarge (rect_type const & r) const noexcept
+    {
+        return r.adjusted(-_margin, -_margin, _margin, _margin);
+    }
+
+    // Cost metric of the bounds
+    static unit_type perimeter (rect_type const & r) noexcept
+    {
+        return 2 * (r.get_width() + r.get_height());
+    }
+};
+
+template <typename UnitT, typename T>
+constexpr typename spatial_index<UnitT, T>::id_type spatial_index<UnitT, T>::null_id;
+
+template <typename UnitT, typename T>
+typename spatial_index<UnitT, T>::id_type
+spatial_index<UnitT, T>::allocate_node ()
+{
+    id_type id;
+
+    if (_free_list == null_id) {
+        id = static_cast<id_type>(_nodes.size());
+        _nodes.emplace_back();
+    } else {
+        id = _free_list;
+        _free_list = _nodes[id].parent;
+        _nodes[id] = node{};
+    }
+
+    _nodes[id].height = 0;
+    return id;
+}
+
+template <typename UnitT, typename T>
+void spatial_index<UnitT, T>::free_node (id_type id)
+{
+    _nodes[id] = node{};
+    _nodes[id].parent = _free_list;
+    _free_list = id;
+}
+
+template <typename UnitT, typename T>
+typename spatial_index<UnitT, T>::id_type
+spatial_index<UnitT, T>::insert (rect_type const & r, value_type const & value)
+{
+    id_type id = allocate_node();
+    node & leaf = _nodes[id];
+    leaf.tight = r;
+    leaf.fat = enlarge(r);
+    leaf.value = value;
+
+    insert_leaf(id);
+    ++_count;
+
+    return id;
+}
+
+template <typename UnitT, typename T>
+bool spatial_index<UnitT, T>::update (id_type id, rect_type const & r)
+{
+    assert(id >= 0 && static_cast<std::size_t>(id) < _nodes.size());
+    assert(_nodes[id].is_leaf());
+
+    _nodes[id].tight = r;
+
+    if (_nodes[id].fat.contains(r))
+        return false;
+
+    remove_leaf(id);
+    _nodes[id].fat = enlarge(r);
+    insert_leaf(id);
+
+    return true;
+}
+
+template <typename UnitT, typename T>
+void spatial_index<UnitT, T>::remove (id_type id)
+{
+    assert(id >= 0 && static_cast<std::size_t>(id) < _nodes.size());
+    assert(_nodes[id].is_leaf());
+
+    remove_leaf(id);
+    free_node(id);
+    --_count;
+}
+
+template <typename UnitT, typename T>
+void spatial_index<UnitT, T>::insert_leaf (id_type leaf)
+{
+    if (_root == null_id) {
+        _root = leaf;
+        _nodes[_root].parent = null_id;
+        return;
+    }
+
+    // Find the best sibling for the leaf using surface area heuristic
+    rect_type const leaf_fat = _nodes[leaf].fat;
+    id_type index = _root;
+
+    while (!_nodes[index].is_leaf()) {
+        id_type child1 = _nodes[index].child1;
+        id_type child2 = _nodes[index].child2;
+
+        unit_type area = perimeter(_nodes[index].fat);
+        unit_type combined_area = perimeter(_nodes[index].fat.united(leaf_fat));
+
+        // Cost of creating a new parent for this node and the new leaf
+        unit_type cost = 2 * combined_area;
+
+        // Minimum cost of pushing the leaf further down the tree
+        unit_type inheritance_cost = 2 * (combined_area - area);
+
+        auto descend_cost = [&] (id_type child) -> unit_type {
+            unit_type c = perimeter(_nodes[child].fat.united(leaf_fat));
+
+            if (!_nodes[child].is_leaf())
+                c -= perimeter(_nodes[child].fat);
+
+            return c + inheritance_cost;
+        };
+
+        unit_type cost1 = descend_cost(child1);
+        unit_type cost2 = descend_cost(child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    id_type sibling = index;
+
+    // Create a new parent (note: allocate_node() may invalidate references)
+    id_type old_parent = _nodes[sibling].parent;
+    id_type new_parent = allocate_node();
+    _nodes[new_parent].parent = old_parent;
+    _nodes[new_parent].fat = _nodes[sibling].fat.united(leaf_fat);
+    _nodes[new_parent].height = _nodes[sibling].height + 1;
+    _nodes[new_parent].child1 = sibling;
+    _nodes[new_parent].child2 = leaf;
+    _nodes[sibling].parent = new_parent;
+    _nodes[leaf].parent = new_parent;
+
+    if (old_parent != null_id) {
+        if (_nodes[old_parent].child1 == sibling)
+            _nodes[old_parent].child1 = new_parent;
+        else
+            _nodes[old_parent].child2 = new_parent;
+    } else {
+        _root = new_parent;
+    }
+
+    // Walk back up the tree fixing heights and bounds
+    index = _nodes[leaf].parent;
+
+    while (index != null_id) {
+        index = balance(index);
+
+        id_type child1 = _nodes[index].child1;
+        id_type child2 = _nodes[index].child2;
+
+        _nodes[index].height = 1 + (std::max)(_nodes[child1].height, _nodes[child2].height);
+        _nodes[index].fat = _nodes[child1].fat.united(_nodes[child2].fat);
+
+        index = _nodes[index].parent;
+    }
+}
+
+template <typename UnitT, typename T>
+void spatial_index<UnitT, T>::remove_leaf (id_type leaf)
+{
+    if (leaf == _root) {
+        _root = null_id;
+        return;
+    }
+
+    id_type parent = _nodes[leaf].parent;
+    id_type grand_parent = _nodes[parent].parent;
+    id_type sibling = _nodes[parent].child1 == leaf
+        ? _nodes[parent].child2
+        : _nodes[parent].child1;
+
+    if (grand_parent != null_id) {
+        // Destroy parent and connect sibling to grand parent
+        if (_nodes[grand_parent].child1 == parent)
+            _nodes[grand_parent].child1 = sibling;
+        else
+            _nodes[grand_parent].child2 = sibling;
+
+        _nodes[sibling].parent = grand_parent;
+        free_node(parent);
+
+        // Adjust ancestor bounds
+        id_type index = grand_parent;
+
+        while (index != null_id) {
+            index = balance(index);
+
+            id_type child1 = _nodes[index].child1;
+            id_type child2 = _nodes[index].child2;
+
+            _nodes[index].fat = _nodes[child1].fat.united(_nodes[child2].fat);
+            _nodes[index].height = 1 + (std::max)(_nodes[child1].height, _nodes[child2].height);
+
+            index = _nodes[index].parent;
+        }
+    } else {
+        _root = sibling;
+        _nodes[sibling].parent = null_id;
+        free_node(parent);
+    }
+
+    _nodes[leaf].parent = null_id;
+}
+
+//
+// Performs a left or right rotation if node A is imbalanced.
+// Returns the new root index.
+//
+template <typename UnitT, typename T>
+typename spatial_index<UnitT, T>::id_type
+spatial_index<UnitT, T>::balance (id_type ia)
+{
+    node & a = _nodes[ia];
+
+    if (a.is_leaf() || a.height < 2)
+        return ia;
+
+    id_type ib = a.child1;
+    id_type ic = a.child2;
+    node & b = _nodes[ib];
+    node & c = _nodes[ic];
+
+    int bal = c.height - b.height;
+
+    // Rotate C up
+    if (bal > 1) {
+        id_type i_f = c.child1;
+        id_type i_g = c.child2;
+        node & f = _nodes[i_f];
+        node & g = _nodes[i_g];
+
+        // Swap A and C
+        c.child1 = ia;
+        c.parent = a.parent;
+        a.parent = ic;
+
+        // A's old parent should point to C
+        if (c.parent != null_id) {
+            if (_nodes[c.parent].child1 == ia)
+                _nodes[c.parent].child1 = ic;
+            else
+                _nodes[c.parent].child2 = ic;
+        } else {
+            _root = ic;
+        }
+
+        // Rotate
+        if (f.height > g.height) {
+            c.child2 = i_f;
+            a.child2 = i_g;
+            g.parent = ia;
+            a.fat = b.fat.united(g.fat);
+            c.fat = a.fat.united(f.fat);
+            a.height = 1 + (std::max)(b.height, g.height);
+            c.height = 1 + (std::max)(a.height, f.height);
+        } else {
+            c.child2 = i_g;
+            a.child2 = i_f;
+            f.parent = ia;
+            a.fat = b.fat.united(f.fat);
+            c.fat = a.fat.united(g.fat);
+            a.height = 1 + (std::max)(b.height, f.height);
+            c.height = 1 + (std::max)(a.height, g.height);
+        }
+
+        return ic;
+    }
+
+    // Rotate B up
+    if (bal < -1) {
+        id_type i_d = b.child1;
+        id_type i_e = b.child2;
+        node & d = _nodes[i_d];
+        node & e = _nodes[i_e];
+
+        // Swap A and B
+        b.child1 = ia;
+        b.parent = a.parent;
+        a.parent = ib;
+
+        // A's old parent should point to B
+        if (b.parent != null_id) {
+            if (_nodes[b.parent].child1 == ia)
+                _nodes[b.parent].child1 = ib;
+            else
+                _nodes[b.parent].child2 = ib;
+        } else {
+            _root = ib;
+        }
+
+        // Rotate
+        if (d.height > e.height) {
+            b.child2 = i_d;
+            a.child1 = i_e;
+            e.parent = ia;
+            a.fat = c.fat.united(e.fat);
+            b.fat = a.fat.united(d.fat);
+            a.height = 1 + (std::max)(c.height, e.height);
+            b.height = 1 + (std::max)(a.height, d.height);
+        } else {
+            b.child2 = i_e;
+            a.child1 = i_d;
+            d.parent = ia;
+            a.fat = c.fat.united(d.fat);
+            b.fat = a.fat.united(e.fat);
+            a.height = 1 + (std::max)(c.height, d.height);
+            b.height = 1 + (std::max)(a.height, e.height);
+        }
+
+        return ib;
+    }
+
+    return ia;
+}
+
+template <typename UnitT, typename T>
+template <typename Predicate, typename Visitor>
+void spatial_index<UnitT, T>::query_if (Predicate && pred, Visitor && f) const
+{
+    if (_root == null_id)
+        return;
+
+    // Balanced tree of 2^31 items is less than 64 levels deep,
+    // so the stack never spills into the heap in practice.
+    static constexpr int fixed_stack_size = 128;
+    id_type fixed_stack[fixed_stack_size];
+    std::vector<id_type> spill_stack;
+
+    int top = 0;
+    fixed_stack[top++] = _root;
+
+    while (top > 0 || !spill_stack.empty()) {
+        id_type index;
+
+        if (!spill_stack.empty()) {
+            index = spill_stack.back();
+            spill_stack.pop_back();
+        } else {
+            index = fixed_stack[--top];
+        }
+
+        node const & n = _nodes[index];
+
+        if (!pred(n.fat))
+            continue;
+
+        if (n.is_leaf()) {
+            if (pred(n.tight)) {
+                if (!f(index, n.value))
+                    return;
+            }
+        } else {
+            if (top + 2 <= fixed_stack_size) {
+                fixed_stack[top++] = n.child1;
+                fixed_stack[top++] = n.child2;
+            } else {
+                spill_stack.push_back(n.child1);
+                spill_stack.push_back(n.child2);
+            }
+        }
+    }
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.02 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/mesh.hpp"
+#include "pfs/griotte/pen.hpp"
+#include "pfs/griotte/point.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class streaming_path
+ * @brief Append-only polyline of the last @a capacity samples for live
+ *        plotting.
+ *
+ * Samples are kept in a ring buffer, when it is full every new sample
+ * retires the oldest one. Every sample is stored twice (at its ring
+ * position and one capacity further), so the samples always form one
+ * contiguous array and the polyline is passed to a painter with a single
+ * call. Appending takes constant time.
+ */
+template <typename UnitT>
+class streaming_path
+{
+public:
+    using unit_type  = UnitT;
+    using point_type = point<unit_type>;
+
+private:
+    std::vector<point_type> _points; // 2 * capacity
+    std::size_t _capacity;
+    std::size_t _size {0};
+    std::size_t _head {0}; // ring position of the oldest sample
+
+public:
+    explicit streaming_path (std::size_t capacity)
+        : _points(2 * (std::max)(capacity, std::size_t{2}))
+        , _capacity((std::max)(capacity, std::size_t{2}))
+    {}
+
+    std::size_t capacity () const noexcept
+    {
+        return _capacity;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _size;
+    }
+
+    bool empty () const noexcept
+    {
+        return _size == 0;
+    }
+
+    void clear () noexcept
+    {
+        _size = 0;
+        _head = 0;
+    }
+
+    /**
+     * @return Pointer to the oldest sample, samples are contiguous.
+     */
+    point_type const * data () const noexcept
+    {
+        return _points.data() + _head;
+    }
+
+    /**
+     * @return Sample @a i counting from the oldest one.
+     */
+    point_type const & operator [] (std::size_t i) const noexcept
+    {
+        return _points[_head + i];
+    }
+
+    point_type const & front () const noexcept
+    {
+        return _points[_head];
+    }
+
+    point_type const & back () const noexcept
+    {
+        return _points[_head + _size - 1];
+    }
+
+    /**
+     * @brief Appends sample @a p, retiring the oldest sample if the path is
+     *        full.
+     */
+    void append (point_type const & p) noexcept
+    {
+        std::size_t pos = _head + _size;
+
+        if (_size == _capacity) {
+            pos = _head;
+            _head = (_head + 1) % _capacity;
+        } else {
+            ++_size;
+        }
+
+        pos %= _capacity;
+        _points[pos] = p;
+        _points[pos + _capacity] = p;
+    }
+
+    /**
+     * @brief Strokes the polyline by @a apainter with a single
+     *        draw_polyline() call.
+     */
+    template <typename Painter>
+    void stroke (Painter & apainter, pen<unit_type> const & apen) const
+    {
+        if (_size > 1)
+            apainter.draw_polyline(data(), _size, apen);
+    }
+};
+
+/**
+ * @class streaming_stroke
+ * @brief Stroke mesh of a streaming polyline updated incrementally.
+ *
+ * The mesh consists of fixed slots, one per sample, with the segment
+ * ending at the sample and the join at its start. Appending a sample
+ * rewrites the slot of the retired sample and collapses the geometry
+ * attached to the retired segment, so updating takes constant time and
+ * the index buffer never changes (only vertices need to be uploaded).
+ *
+ * @note Ends of the polyline have butt caps, round joins are drawn as
+ *       bevel joins.
+ */
+template <typename UnitT>
+class streaming_stroke
+{
+public:
+    using unit_type  = UnitT;
+    using point_type = point<unit_type>;
+
+    static constexpr std::size_t slot_vertices = 8;
+    static constexpr std::size_t slot_indices = 12;
+
+    // Miter joins longer than (miter_limit * half width) are beveled
+    static constexpr float miter_limit = 4.0f;
+
+private:
+    mesh _mesh;
+    std::size_t _capacity;
+    float _hw;
+    join_style _join;
+
+    std::size_t _count {0}; // number of samples in the mesh
+    std::size_t _last {0};  // slot of the last sample
+    mesh_vertex _prev;
+    mesh_vertex _prev_normal;
+
+private:
+    mesh_vertex * slot (std::size_t s) noexcept
+    {
+        return & _mesh.vertices[(s % _capacity) * slot_vertices];
+    }
+
+    void collapse (mesh_vertex * v, std::size_t n) noexcept
+    {
+        std::fill(v, v + n, mesh_vertex{0, 0});
+    }
+
+    void write_join (mesh_vertex * v
+        , mesh_vertex const & p
+        , mesh_vertex const & n0
+        , mesh_vertex const & n1) noexcept;
+
+public:
+    /**
+     * @param capacity Maximum number of samples.
+     * @param apen Pen (width, color and join style) of the stroke.
+     */
+    streaming_stroke (std::size_t capacity, pen<unit_type> const & apen);
+
+    std::size_t capacity () const noexcept
+    {
+        return _capacity;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _count;
+    }
+
+    /**
+     * @return Mesh of the stroke, vertices of at most three slots are
+     *         changed by every append().
+     */
+    mesh const & get_mesh () const noexcept
+    {
+        return _mesh;
+    }
+
+    void clear () noexcept
+    {
+        collapse(_mesh.vertices.data(), _mesh.vertices.size());
+        _count = 0;
+    }
+
+    /**
+     * @brief Appends sample @a p retiring the oldest sample if the stroke
+     *        is full.
+     */
+    void append (point_type const & p) noexcept;
+};
+
+template <typename UnitT>
+constexpr std::size_t streaming_stroke<UnitT>::slot_vertices;
+
+template <typename UnitT>
+constexpr std::size_t streaming_stroke<UnitT>::slot_indices;
+
+template <typename UnitT>
+constexpr float streaming_stroke<UnitT>::miter_limit;
+
+template <typename UnitT>
+streaming_stroke<UnitT>::streaming_stroke (std::size_t capacity
+    , pen<unit_type> const & apen)
+    : _capacity((std::max)(capacity, std::size_t{2}))
+    , _hw(static_cast<float>(apen.get_width()) / 2)
+    , _join(apen.get_join())
+{
+    _mesh.vertices.assign(_capacity * slot_vertices, mesh_vertex{0, 0});
+    _mesh.indices.reserve(_capacity * slot_indices);
+
+    for (std::size_t s = 0; s < _capacity; s++) {
+        auto base = static_cast<std::uint32_t>(s * slot_vertices);
+
+        // Segment quad
+        _mesh.add_triangle(base, base + 1, base + 2);
+        _mesh.add_triangle(base + 2, base + 1, base + 3);
+
+        // Join
+        _mesh.add_triangle(base + 4, base + 5, base + 6);
+        _mesh.add_triangle(base + 4, base + 6, base + 7);
+    }
+
+    _mesh.commands.push_back(mesh_command{mesh_command_type::triangles
+        , apen.get_color(), 0, static_cast<std::uint32_t>(_mesh.indices.size())});
+}
+
+template <typename UnitT>
+void streaming_stroke<UnitT>::write_join (mesh_vertex * v
+    , mesh_vertex const & p
+    , mesh_vertex const & n0
+    , mesh_vertex const & n1) noexcept
+{
+    float cross = n0.x * n1.y - n0.y * n1.x;
+    float dot = n0.x * n1.x + n0.y * n1.y;
+
+    // Collinear segments need no join
+    if (std::fabs(cross) < 1e-6f && dot > 0) {
+        collapse(v, 4);
+        return;
+    }
+
+    // Outer side of the turn
+    float s = cross > 0 ? -1.0f : 1.0f;
+    mesh_vertex o0 {p.x + n0.x * _hw * s, p.y + n0.y * _hw * s};
+    mesh_vertex o1 {p.x + n1.x * _hw * s, p.y + n1.y * _hw * s};
+    mesh_vertex tip {(o0.x + o1.x) / 2, (o0.y + o1.y) / 2};
+
+    if (_join == join_style::miter) {
+        float mx = n0.x + n1.x;
+        float my = n0.y + n1.y;
+        float mlen = std::sqrt(mx * mx + my * my);
+
+        if (mlen > 1e-6f) {
+            mx /= mlen;
+            my /= mlen;
+
+            float len = _hw / (mx * n0.x + my * n0.y);
+
+            if (len <= miter_limit * _hw)
+                tip = mesh_vertex{p.x + mx * len * s, p.y + my * len * s};
+        }
+    }
+
+    v[0] = p;
+    v[1] = o0;
+    v[2] = tip;
+    v[3] = o1;
+}
+
+template <typename UnitT>
+void streaming_stroke<UnitT>::append (point_type const & p) noexcept
+{
+    mesh_vertex b {static_cast<float>(p.x()), static_cast<float>(p.y())};
+
+    if (_count == 0) {
+        _prev = b;
+        _count = 1;
+        collapse(slot(_last), slot_vertices);
+        return;
+    }
+
+    float dx = b.x - _prev.x;
+    float dy = b.y - _prev.y;
+    float len = std::sqrt(dx * dx + dy * dy);
+
+    // Skip degenerate segments
+    if (len == 0)
+        return;
+
+    mesh_vertex n {-dy / len, dx / len};
+    mesh_vertex const & a = _prev;
+    std::size_t s = (_last + 1) % _capacity;
+    mesh_vertex * v = slot(s);
+
+    float ox = n.x * _hw;
+    float oy = n.y * _hw;
+    v[0] = mesh_vertex{a.x + ox, a.y + oy};
+    v[1] = mesh_vertex{a.x - ox, a.y - oy};
+    v[2] = mesh_vertex{b.x + ox, b.y + oy};
+    v[3] = mesh_vertex{b.x - ox, b.y - oy};
+
+    if (_count > 1)
+        write_join(v + 4, a, _prev_normal, n);
+    else
+        collapse(v + 4, 4);
+
+    if (_count == _capacity) {
+        // Slot 's' was the oldest sample, the next one becomes the oldest:
+        // its segment and the join at its start are retired
+        collapse(slot(s + 1), slot_vertices);
+        collapse(slot(s + 2) + 4, 4);
+    } else {
+        ++_count;
+    }
+
+    _last = s;
+    _prev = b;
+    _prev_normal = n;
+}
+
+}} // namespace pfs::griotte
@@ -7,19 +7,18 @@
 namespace pfs {
 namespace griotte {
 
-template <typename UnitT>
+template <typename UnitT, typename Allocator = std::allocator<path_entry<UnitT>>>
 class stroker
 {
     using unit_type  = UnitT;
-    using path_type  = path<unit_type>;
-    using pen_type   = pen<unit_type>;
+    using path_type  = path<unit_type, Allocator>;
     using point_type = point<unit_type>;
 
     path_type * _path;
     point_type  _cp; // current point ((0, 0) by default)
 
 public:
-    stroker (path<UnitT> & apath) : _path(& apath) {}
+    stroker (path_type & apath) : _path(& apath) {}
 
     point_type const & current_point () const
     {
@@ -43,14 +42,12 @@ public:
 /**
  * @return Last point
  */
-template <typename UnitT>
+template <typename UnitT, typename Allocator>
 template <typename Painter>
-void stroker<UnitT>::stroke (Painter & apainter
+void stroker<UnitT, Allocator>::stroke (Painter & apainter
         , pen<UnitT> const & apen
         , std::error_code & ec) noexcept
 {
-    using entry_type = typename path_type::entry;
-
     if (_path->empty()) {
         ec = make_error_code(errc::success);
         return;
@@ -0,0 +1,578 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+//      2021.07.13 Caps of zero length dashes.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/dasher.hpp"
+#include "pfs/griotte/error.hpp"
+#include "pfs/griotte/mesh.hpp"
+#include "pfs/griotte/path.hpp"
+#include "pfs/griotte/pen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class tessellator
+ * @brief Converts paths into triangle meshes: curves are flattened into
+ *        polylines with the given tolerance, polylines are dashed by
+ *        dasher and stroked with pen width, joins and caps, or filled.
+ *
+ * Tessellator keeps its intermediate buffers between calls, so reusing one
+ * instance avoids allocations. It is not thread-safe, use an instance per
+ * thread (see parallel_tessellator).
+ */
+template <typename UnitT>
+class tessellator
+{
+public:
+    using unit_type = UnitT;
+
+    // Miter joins longer than (miter_limit * half width) are beveled
+    static constexpr float miter_limit = 4.0f;
+
+private:
+    float _tolerance {0.25f};
+    std::vector<mesh_vertex> _points;
+    std::vector<contour> _contours;
+    dasher<UnitT> _dasher;
+    std::vector<mesh_vertex> _dash_points;
+    std::vector<contour> _dash_contours;
+
+private:
+    static mesh_vertex to_vertex (point<unit_type> const & p)
+    {
+        return mesh_vertex{static_cast<float>(p.x()), static_cast<float>(p.y())};
+    }
+
+    void add_point (mesh_vertex const & v)
+    {
+        contour & c = _contours.back();
+
+        // Skip degenerate segments
+        if (c.count > 0) {
+            mesh_vertex const & last = _points.back();
+
+            if (last.x == v.x && last.y == v.y)
+                return;
+        }
+
+        _points.push_back(v);
+        ++c.count;
+    }
+
+    void begin_contour (mesh_vertex const & start)
+    {
+        _contours.push_back(contour{_points.size(), 0, false, mesh_vertex{0, 0}});
+        add_point(start);
+    }
+
+    void flatten_cubic (mesh_vertex const & p0
+        , mesh_vertex const & p1
+        , mesh_vertex const & p2
+        , mesh_vertex const & p3);
+
+    void add_arc (mesh & out
+        , mesh_vertex const & center
+        , float radius
+        , float start_angle
+        , float sweep);
+
+    void add_join (mesh & out
+        , mesh_vertex const & p
+        , mesh_vertex const & n0
+        , mesh_vertex const & n1
+        , float hw
+        , join_style join);
+
+    void add_cap (mesh & out
+        , mesh_vertex const & p
+        , mesh_vertex const & dir
+        , float hw
+        , cap_style cap);
+
+    void stroke_contour (mesh & out
+        , mesh_vertex const * points
+        , contour const & c
+        , float hw
+        , cap_style cap
+        , join_style join);
+
+public:
+    /**
+     * @brief Constructs tessellator with maximum distance @a tolerance
+     *        (in units) between a curve and its flattened polyline.
+     */
+    tessellator (float tolerance = 0.25f)
+        : _tolerance(tolerance)
+    {}
+
+    float get_tolerance () const noexcept
+    {
+        return _tolerance;
+    }
+
+    void set_tolerance (float tolerance) noexcept
+    {
+        _tolerance = tolerance;
+    }
+
+    /**
+     * @brief Flattens @a apath into polylines available by get_points() and
+     *        get_contours().
+     */
+    template <typename PathAllocator>
+    void flatten (path<UnitT, PathAllocator> const & apath, std::error_code & ec);
+
+    std::vector<mesh_vertex> const & get_points () const noexcept
+    {
+        return _points;
+    }
+
+    std::vector<contour> const & get_contours () const noexcept
+    {
+        return _contours;
+    }
+
+    /**
+     * @brief Sets whether the dash phase continues across subpaths instead
+     *        of restarting at every subpath.
+     */
+    void set_continuous_dashes (bool enable) noexcept
+    {
+        _dasher.set_continuous(enable);
+    }
+
+    /**
+     * @brief Appends triangles of @a apath stroked by @a apen to @a out.
+     */
+    template <typename PathAllocator>
+    void stroke (path<UnitT, PathAllocator> const & apath
+        , pen<UnitT> const & apen
+        , mesh & out
+        , std::error_code & ec);
+
+    template <typename PathAllocator>
+    void stroke (path<UnitT, PathAllocator> const & apath
+        , pen<UnitT> const & apen
+        , mesh & out)
+    {
+        std::error_code ec;
+        stroke(apath, apen, out, ec);
+        if (ec) throw exception(ec);
+    }
+
+    /**
+     * @brief Appends triangle fans of @a apath subpaths filled by @a c to
+     *        @a out.
+     */
+    template <typename PathAllocator>
+    void fill (path<UnitT, PathAllocator> const & apath
+        , color const & c
+        , mesh & out
+        , std::error_code & ec);
+
+    template <typename PathAllocator>
+    void fill (path<UnitT, PathAllocator> const & apath, color const & c, mesh & out)
+    {
+        std::error_code ec;
+        fill(apath, c, out, ec);
+        if (ec) throw exception(ec);
+    }
+};
+
+template <typename UnitT>
+constexpr float tessellator<UnitT>::miter_limit;
+
+template <typename UnitT>
+void tessellator<UnitT>::flatten_cubic (mesh_vertex const & p0
+    , mesh_vertex const & p1
+    , mesh_vertex const & p2
+    , mesh_vertex const & p3)
+{
+    // Number of segments from the maximum of the second derivative:
+    // flattening error of a segment does not exceed M * h^2 / 8
+    float ddx = (std::max)(std::fabs(p0.x - 2 * p1.x + p2.x), std::fabs(p1.x - 2 * p2.x + p3.x));
+    float ddy = (std::max)(std::fabs(p0.y - 2 * p1.y + p2.y), std::fabs(p1.y - 2 * p2.y + p3.y));
+    float dd = std::sqrt(ddx * ddx + ddy * ddy);
+
+    int n = static_cast<int>(std::ceil(std::sqrt(0.75f * dd / _tolerance)));
+    n = (std::min)((std::max)(n, 1), 1024);
+
+    float h = 1.0f / n;
+
+    for (int i = 1; i < n; i++) {
+        float t = i * h;
+        float u = 1 - t;
+        float b0 = u * u * u;
+        float b1 = 3 * u * u * t;
+        float b2 = 3 * u * t * t;
+        float b3 = t * t * t;
+
+        add_point(mesh_vertex{
+              b0 * p0.x + b1 * p1.x + b2 * p2.x + b3 * p3.x
+            , b0 * p0.y + b1 * p1.y + b2 * p2.y + b3 * p3.y});
+    }
+
+    add_point(p3);
+}
+
+template <typename UnitT>
+template <typename PathAllocator>
+void tessellator<UnitT>::flatten (path<UnitT, PathAllocator> const & apath
+    , std::error_code & ec)
+{
+    _points.clear();
+    _contours.clear();
+
+    if (apath.empty())
+        return;
+
+    auto first = apath.cbegin();
+    auto last  = apath.cend();
+
+    if (first->type != path_entry_enum::move_to) {
+        // Path must be started with 'move_to' or 'rel_move_to' elements
+        ec = make_error_code(errc::bad_path);
+        return;
+    }
+
+    mesh_vertex start = to_vertex(first->p);
+    mesh_vertex cp = start;
+    begin_contour(start);
+
+    for (++first; first != last; ++first) {
+        switch (first->type) {
+            case path_entry_enum::move_to:
+                start = cp = to_vertex(first->p);
+                begin_contour(start);
+                break;
+
+            case path_entry_enum::line_to:
+                if (_contours.back().closed)
+                    begin_contour(cp);
+
+                cp = to_vertex(first->p);
+                add_point(cp);
+                break;
+
+            case path_entry_enum::curve_to: {
+                if (std::distance(first, last) < 3) {
+                    ec = make_error_code(errc::bad_path); // incomplete curve
+                    return;
+                }
+
+                auto ic1 = first++;
+                auto ic2 = first++;
+                auto iep = first;
+
+                if (!(ic2->type == path_entry_enum::curve_to
+                        && iep->type == path_entry_enum::curve_to)) {
+                    ec = make_error_code(errc::bad_path); // incomplete curve
+                    return;
+                }
+
+                if (_contours.back().closed)
+                    begin_contour(cp);
+
+                mesh_vertex ep = to_vertex(iep->p);
+                flatten_cubic(cp, to_vertex(ic1->p), to_vertex(ic2->p), ep);
+                cp = ep;
+                break;
+            }
+
+            case path_entry_enum::close_path: {
+                contour & c = _contours.back();
+
+                // Closing point equal to the start point is redundant
+                if (c.count > 1) {
+                    mesh_vertex const & lp = _points.back();
+
+                    if (lp.x == start.x && lp.y == start.y)
+                        _points.pop_back(), --c.count;
+                }
+
+                c.closed = true;
+
+                // Point of 'close_path' entry is meaningless, the current
+                // point is moved to the start of the subpath
+                cp = start;
+                break;
+            }
+        }
+    }
+}
+
+template <typename UnitT>
+void tessellator<UnitT>::add_arc (mesh & out
+    , mesh_vertex const & center
+    , float radius
+    , float start_angle
+    , float sweep)
+{
+    // Angle step keeping chord deviation within the tolerance
+    float step = radius > _tolerance
+        ? 2 * std::acos(1 - _tolerance / radius)
+        : 3.14159265f / 2;
+
+    int n = static_cast<int>(std::ceil(std::fabs(sweep) / step));
+    n = (std::min)((std::max)(n, 1), 256);
+
+    auto ic = out.add_vertex(center.x, center.y);
+    auto prev = out.add_vertex(center.x + radius * std::cos(start_angle)
+        , center.y + radius * std::sin(start_angle));
+
+    for (int i = 1; i <= n; i++) {
+        float a = start_angle + sweep * i / n;
+        auto next = out.add_vertex(center.x + radius * std::cos(a)
+            , center.y + radius * std::sin(a));
+        out.add_triangle(ic, prev, next);
+        prev = next;
+    }
+}
+
+template <typename UnitT>
+void tessellator<UnitT>::add_join (mesh & out
+    , mesh_vertex const & p
+    , mesh_vertex const & n0
+    , mesh_vertex const & n1
+    , float hw
+    , join_style join)
+{
+    float cross = n0.x * n1.y - n0.y * n1.x;
+    float dot = n0.x * n1.x + n0.y * n1.y;
+
+    // Collinear segments need no join
+    if (std::fabs(cross) < 1e-6f && dot > 0)
+        return;
+
+    // Outer side of the turn
+    float s = cross > 0 ? -1.0f : 1.0f;
+    mesh_vertex o0 {p.x + n0.x * hw * s, p.y + n0.y * hw * s};
+    mesh_vertex o1 {p.x + n1.x * hw * s, p.y + n1.y * hw * s};
+
+    switch (join) {
+        case join_style::round: {
+            float a0 = std::atan2(o0.y - p.y, o0.x - p.x);
+            add_arc(out, p, hw, a0, std::atan2(cross, dot));
+            return;
+        }
+
+        case join_style::miter: {
+            float mx = n0.x + n1.x;
+            float my = n0.y + n1.y;
+            float mlen = std::sqrt(mx * mx + my * my);
+
+            if (mlen > 1e-6f) {
+                mx /= mlen;
+                my /= mlen;
+
+                // Distance from the join point to the miter tip
+                float cosine = mx * n0.x + my * n0.y;
+                float len = hw / cosine;
+
+                if (len <= miter_limit * hw) {
+                    auto ip = out.add_vertex(p.x, p.y);
+                    auto i0 = out.add_vertex(o0.x, o0.y);
+                    auto it = out.add_vertex(p.x + mx * len * s, p.y + my * len * s);
+                    auto i1 = out.add_vertex(o1.x, o1.y);
+                    out.add_triangle(ip, i0, it);
+                    out.add_triangle(ip, it, i1);
+                    return;
+                }
+            }
+
+            // Fall back to bevel
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    auto ip = out.add_vertex(p.x, p.y);
+    auto i0 = out.add_vertex(o0.x, o0.y);
+    auto i1 = out.add_vertex(o1.x, o1.y);
+    out.add_triangle(ip, i0, i1);
+}
+
+template <typename UnitT>
+void tessellator<UnitT>::add_cap (mesh & out
+    , mesh_vertex const & p
+    , mesh_vertex const & dir
+    , float hw
+    , cap_style cap)
+{
+    // 'dir' is the unit vector directed outward from the line end
+    mesh_vertex n {-dir.y * hw, dir.x * hw};
+
+    switch (cap) {
+        case cap_style::square: {
+            mesh_vertex e {p.x + dir.x * hw, p.y + dir.y * hw};
+            auto a = out.add_vertex(p.x + n.x, p.y + n.y);
+            auto b = out.add_vertex(p.x - n.x, p.y - n.y);
+            auto c = out.add_vertex(e.x + n.x, e.y + n.y);
+            auto d = out.add_vertex(e.x - n.x, e.y - n.y);
+            out.add_triangle(a, b, c);
+            out.add_triangle(c, b, d);
+            break;
+        }
+
+        case cap_style::round: {
+            float a0 = std::atan2(n.y, n.x);
+            add_arc(out, p, hw, a0, -3.14159265f);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+template <typename UnitT>
+void tessellator<UnitT>::stroke_contour (mesh & out
+    , mesh_vertex const * points
+    , contour const & c
+    , float hw
+    , cap_style cap
+    , join_style join)
+{
+    mesh_vertex const * p = points + c.first;
+    std::size_t n = c.count;
+    std::size_t nsegments = c.closed ? n : n - 1;
+
+    if (n < 2)
+        return;
+
+    // Zero length dash: only caps are drawn (nothing for butt caps)
+    if (n == 2 && p[0].x == p[1].x && p[0].y == p[1].y) {
+        if (c.dir.x != 0 || c.dir.y != 0) {
+            add_cap(out, p[0], c.dir, hw, cap);
+            add_cap(out, p[0], mesh_vertex{-c.dir.x, -c.dir.y}, hw, cap);
+        }
+
+        return;
+    }
+
+    auto unit_normal = [p, n] (std::size_t i) {
+        mesh_vertex const & a = p[i];
+        mesh_vertex const & b = p[(i + 1) % n];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float len = std::sqrt(dx * dx + dy * dy);
+        return mesh_vertex{-dy / len, dx / len};
+    };
+
+    mesh_vertex first_normal = unit_normal(0);
+    mesh_vertex prev_normal = first_normal;
+
+    for (std::size_t i = 0; i < nsegments; i++) {
+        mesh_vertex const & a = p[i];
+        mesh_vertex const & b = p[(i + 1) % n];
+        mesh_vertex nv = i == 0 ? first_normal : unit_normal(i);
+
+        if (i > 0)
+            add_join(out, a, prev_normal, nv, hw, join);
+
+        float ox = nv.x * hw;
+        float oy = nv.y * hw;
+        auto i0 = out.add_vertex(a.x + ox, a.y + oy);
+        auto i1 = out.add_vertex(a.x - ox, a.y - oy);
+        auto i2 = out.add_vertex(b.x + ox, b.y + oy);
+        auto i3 = out.add_vertex(b.x - ox, b.y - oy);
+        out.add_triangle(i0, i1, i2);
+        out.add_triangle(i2, i1, i3);
+
+        prev_normal = nv;
+    }
+
+    if (c.closed) {
+        add_join(out, p[0], prev_normal, first_normal, hw, join);
+    } else {
+        // Segment direction from its normal: (nx, ny) -> (ny, -nx)
+        add_cap(out, p[0], mesh_vertex{-first_normal.y, first_normal.x}
+            , hw, cap);
+        add_cap(out, p[n - 1], mesh_vertex{prev_normal.y, -prev_normal.x}
+            , hw, cap);
+    }
+}
+
+template <typename UnitT>
+template <typename PathAllocator>
+void tessellator<UnitT>::stroke (path<UnitT, PathAllocator> const & apath
+    , pen<UnitT> const & apen
+    , mesh & out
+    , std::error_code & ec)
+{
+    if (apen.get_width() <= 0)
+        return;
+
+    flatten(apath, ec);
+
+    if (ec)
+        return;
+
+    float hw = static_cast<float>(apen.get_width()) / 2;
+    out.begin_command(mesh_command_type::triangles, apen.get_color());
+
+    if (_dasher.set_pattern(apen)) {
+        _dash_points.clear();
+        _dash_contours.clear();
+
+        for (auto const & c: _contours)
+            _dasher.dash(& _points[c.first], c.count, c.closed, _dash_points, _dash_contours);
+
+        for (auto const & c: _dash_contours)
+            stroke_contour(out, _dash_points.data(), c, hw, apen.get_cap(), apen.get_join());
+    } else {
+        for (auto const & c: _contours)
+            stroke_contour(out, _points.data(), c, hw, apen.get_cap(), apen.get_join());
+    }
+
+    out.end_command();
+}
+
+template <typename UnitT>
+template <typename PathAllocator>
+void tessellator<UnitT>::fill (path<UnitT, PathAllocator> const & apath
+    , color const & fill_color
+    , mesh & out
+    , std::error_code & ec)
+{
+    flatten(apath, ec);
+
+    if (ec)
+        return;
+
+    out.begin_command(mesh_command_type::stencil_fan, fill_color);
+
+    for (auto const & c: _contours) {
+        if (c.count < 3)
+            continue;
+
+        // Subpaths are implicitly closed for filling
+        auto base = static_cast<std::uint32_t>(out.vertices.size());
+
+        for (std::size_t i = 0; i < c.count; i++) {
+            mesh_vertex const & v = _points[c.first + i];
+            out.add_vertex(v.x, v.y);
+        }
+
+        for (std::uint32_t i = 1; i + 1 < c.count; i++)
+            out.add_triangle(base, base + i, base + i + 1);
+    }
+
+    out.end_command();
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.12 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/fixed.hpp"
+#include "pfs/griotte/utf8.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @brief Ink bounding box relative to the pen position on the baseline
+ *        (y axis points down).
+ */
+struct ink_box
+{
+    fixed26_6 x0, y0, x1, y1; // empty if x0 >= x1
+
+    bool empty () const noexcept
+    {
+        return !(x0 < x1 && y0 < y1);
+    }
+};
+
+/**
+ * @brief Extents of a single line of text.
+ */
+struct text_extents
+{
+    fixed26_6 advance; ///< Sum of glyph advances
+    fixed26_6 ascent;  ///< Distance from the baseline to the top of the line
+    fixed26_6 descent; ///< Distance from the baseline to the bottom of the line (negative)
+    ink_box ink;       ///< Union of glyph ink boxes, empty for blank text
+};
+
+/**
+ * @brief Measures single line @a text (UTF-8) of @a len bytes.
+ *
+ * Only metrics are used (nothing is rasterized or uploaded), so text can
+ * be measured without a graphics context. Advances are not kerned, as in
+ * paragraph.
+ *
+ * @a FontMetrics must provide ascender(), descender(), advance(cp) and
+ * ink_bounds(cp) (see font_metrics), its cache makes repeated measurements
+ * cheap.
+ */
+template <typename FontMetrics>
+text_extents measure_text (FontMetrics & m, char const * text, std::size_t len)
+{
+    text_extents result;
+    result.ascent = m.ascender();
+    result.descent = m.descender();
+    result.ink = ink_box{};
+
+    fixed26_6 x;
+    std::size_t pos = 0;
+
+    while (pos < len) {
+        char32_t cp = utf8_decode(text, len, pos);
+        ink_box const & box = m.ink_bounds(cp);
+
+        if (!box.empty()) {
+            if (result.ink.empty()) {
+                result.ink = ink_box{x + box.x0, box.y0, x + box.x1, box.y1};
+            } else {
+                result.ink.x0 = (std::min)(result.ink.x0, x + box.x0);
+                result.ink.y0 = (std::min)(result.ink.y0, box.y0);
+                result.ink.x1 = (std::max)(result.ink.x1, x + box.x1);
+                result.ink.y1 = (std::max)(result.ink.y1, box.y1);
+            }
+        }
+
+        x += m.advance(cp);
+    }
+
+    result.advance = x;
+    return result;
+}
+
+template <typename FontMetrics>
+inline text_extents measure_text (FontMetrics & m, std::string const & text)
+{
+    return measure_text(m, text.data(), text.size());
+}
+
+/**
+ * @brief Measures @a count strings @a texts into @a out (e.g. cells of a
+ *        table column) sharing the metrics cache.
+ *
+ * @note FreeType faces are not thread-safe: worker threads measuring in
+ *       parallel need metrics of their own faces.
+ */
+template <typename FontMetrics>
+void measure_text (FontMetrics & m, std::string const * texts, std::size_t count
+    , text_extents * out)
+{
+    for (std::size_t i = 0; i < count; i++)
+        out[i] = measure_text(m, texts[i].data(), texts[i].size());
+}
+
+}} // namespace pfs::griotte
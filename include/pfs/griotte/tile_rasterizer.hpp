@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.27 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "pfs/griotte/image.hpp"
+#include "pfs/griotte/job_system.hpp"
+#include "pfs/griotte/mesh.hpp"
+#include "pfs/griotte/rect.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class tile_rasterizer
+ * @brief Software rasterizer of meshes into an image using all cores.
+ *
+ * The image is split into square tiles. Triangles are binned to the tiles
+ * overlapped by their bounding rectangles, then every tile is rasterized by
+ * a separate job. Jobs write only pixels of their own tiles, so no locking is
+ * needed. Inside a tile, commands are processed in submission order: samples
+ * covered by the triangles of a command are accumulated in a tile-local
+ * winding buffer (nonzero rule for stencil fans), then the command color is
+ * blended with the coverage, so overlapping stroke triangles are not blended
+ * twice.
+ */
+class tile_rasterizer
+{
+public:
+    static constexpr int default_tile_size = 64;
+
+private:
+    struct bin_entry
+    {
+        std::uint32_t command;
+        std::uint32_t first_index; // index of the first triangle vertex
+    };
+
+    job_system * _jobs;
+    int _tile_size;
+    int _subsamples; // per axis
+    int _tiles_x {0};
+    int _tiles_y {0};
+    std::vector<std::vector<bin_entry>> _bins;
+
+private:
+    static bool is_top_left (float dx, float dy) noexcept
+    {
+        // Any rule asymmetric for opposite directions excludes double
+        // coverage of samples on the edge shared by adjacent triangles
+        return dy > 0 || (dy == 0 && dx > 0);
+    }
+
+    static int to_pixel (float v) noexcept
+    {
+        // Keep far outside coordinates in the integer range
+        float const limit = 1 << 24;
+        return static_cast<int>(std::floor((std::min)((std::max)(v, -limit), limit)));
+    }
+
+    /**
+     * @return Rectangle of pixels overlapped by triangle (@a a, @a b, @a c).
+     */
+    static rect<int> bounding_rect (mesh_vertex const & a
+        , mesh_vertex const & b
+        , mesh_vertex const & c) noexcept
+    {
+        return rect<int>{
+              point<int>{to_pixel((std::min)({a.x, b.x, c.x})), to_pixel((std::min)({a.y, b.y, c.y}))}
+            , point<int>{to_pixel((std::max)({a.x, b.x, c.x})), to_pixel((std::max)({a.y, b.y, c.y}))}};
+    }
+
+    void bin (mesh const & m, rect<int> const & bounds);
+
+    void rasterize_triangle (rect<int> const & tile
+        , mesh_vertex a
+        , mesh_vertex b
+        , mesh_vertex c
+        , bool accumulate
+        , std::int16_t * winding
+        , rect<int> & dirty) const;
+
+    void composite (rect<int> const & tile
+        , rect<int> const & dirty
+        , color const & c
+        , std::int16_t * winding
+        , image & target) const;
+
+    void rasterize_tile (int tile_index
+        , mesh const & m
+        , std::int16_t * winding
+        , image & target) const;
+
+public:
+    /**
+     * @param jobs Job system to run tile jobs.
+     * @param tile_size Size of the square tile in pixels.
+     * @param subsamples Number of samples per pixel along each axis for
+     *        antialiasing (1 to 4).
+     */
+    tile_rasterizer (job_system & jobs
+        , int tile_size = default_tile_size
+        , int subsamples = 2)
+        : _jobs(& jobs)
+        , _tile_size((std::max)(tile_size, 8))
+        , _subsamples((std::min)((std::max)(subsamples, 1), 4))
+    {}
+
+    int get_tile_size () const noexcept
+    {
+        return _tile_size;
+    }
+
+    /**
+     * @return Number of tiles used by the last draw().
+     */
+    int tile_count () const noexcept
+    {
+        return _tiles_x * _tiles_y;
+    }
+
+    /**
+     * @return Rectangle of the tile @a tile_index in @a target.
+     */
+    rect<int> tile_rect (int tile_index, image const & target) const noexcept
+    {
+        int x = (tile_index % _tiles_x) * _tile_size;
+        int y = (tile_index / _tiles_x) * _tile_size;
+        return rect<int>{x, y, _tile_size, _tile_size}.intersected(target.get_rect());
+    }
+
+    /**
+     * @brief Draws mesh @a m over the content of @a target.
+     */
+    void draw (mesh const & m, image & target);
+};
+
+inline void tile_rasterizer::bin (mesh const & m, rect<int> const & bounds)
+{
+    for (std::size_t ci = 0; ci < m.commands.size(); ci++) {
+        mesh_command const & cmd = m.commands[ci];
+        std::uint32_t last = cmd.first_index + cmd.index_count;
+
+        for (std::uint32_t i = cmd.first_index; i + 2 < last; i += 3) {
+            mesh_vertex const & a = m.vertices[m.indices[i]];
+            mesh_vertex const & b = m.vertices[m.indices[i + 1]];
+            mesh_vertex const & c = m.vertices[m.indices[i + 2]];
+
+            rect<int> r = bounding_rect(a, b, c).intersected(bounds);
+
+            if (r.is_empty())
+                continue;
+
+            int tx1 = r.get_x() / _tile_size;
+            int ty1 = r.get_y() / _tile_size;
+            int tx2 = r.get_right() / _tile_size;
+            int ty2 = r.get_bottom() / _tile_size;
+
+            for (int ty = ty1; ty <= ty2; ty++) {
+                for (int tx = tx1; tx <= tx2; tx++) {
+                    _bins[ty * _tiles_x + tx].push_back(
+                        bin_entry{static_cast<std::uint32_t>(ci), i});
+                }
+            }
+        }
+    }
+}
+
+inline void tile_rasterizer::rasterize_triangle (rect<int> const & tile
+    , mesh_vertex a
+    , mesh_vertex b
+    , mesh_vertex c
+    , bool accumulate
+    , std::int16_t * winding
+    , rect<int> & dirty) const
+{
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+    if (area == 0)
+        return;
+
+    std::int16_t sign = 1;
+
+    // Normalize orientation, keep the sign for winding accumulation
+    if (area < 0) {
+        std::swap(b, c);
+        sign = -1;
+    }
+
+    rect<int> r = bounding_rect(a, b, c).intersected(tile);
+
+    if (r.is_empty())
+        return;
+
+    dirty = dirty.united(r);
+
+    mesh_vertex const v[3] = {a, b, c};
+    float dx[3], dy[3];
+    bool tl[3];
+
+    for (int e = 0; e < 3; e++) {
+        dx[e] = v[(e + 1) % 3].x - v[e].x;
+        dy[e] = v[(e + 1) % 3].y - v[e].y;
+        tl[e] = is_top_left(dx[e], dy[e]);
+    }
+
+    int const ns = _subsamples;
+    int const samples = ns * ns;
+    float const step = 1.0f / ns;
+
+    for (int y = r.get_y(); y <= r.get_bottom(); y++) {
+        for (int x = r.get_x(); x <= r.get_right(); x++) {
+            std::int16_t * w = winding
+                + ((y - tile.get_y()) * _tile_size + (x - tile.get_x())) * samples;
+
+            for (int sy = 0; sy < ns; sy++) {
+                float py = y + (sy + 0.5f) * step;
+
+                for (int sx = 0; sx < ns; sx++, w++) {
+                    float px = x + (sx + 0.5f) * step;
+                    bool inside = true;
+
+                    for (int e = 0; e < 3 && inside; e++) {
+                        float ev = dx[e] * (py - v[e].y) - dy[e] * (px - v[e].x);
+                        inside = ev > 0 || (ev == 0 && tl[e]);
+                    }
+
+                    if (inside) {
+                        if (accumulate)
+                            *w += sign;
+                        else
+                            *w = 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline void tile_rasterizer::composite (rect<int> const & tile
+    , rect<int> const & dirty
+    , color const & c
+    , std::int16_t * winding
+    , image & target) const
+{
+    int const samples = _subsamples * _subsamples;
+    float const sa = c.get_alpha() / 255.0f;
+
+    for (int y = dirty.get_y(); y <= dirty.get_bottom(); y++) {
+        std::uint32_t * line = target.scanline(y);
+
+        for (int x = dirty.get_x(); x <= dirty.get_right(); x++) {
+            std::int16_t * w = winding
+                + ((y - tile.get_y()) * _tile_size + (x - tile.get_x())) * samples;
+            int covered = 0;
+
+            for (int s = 0; s < samples; s++) {
+                covered += w[s] != 0 ? 1 : 0;
+                w[s] = 0;
+            }
+
+            if (covered == 0)
+                continue;
+
+            float a = sa * covered / samples;
+            color d = image::unpack(line[x]);
+            float da = d.get_alpha() / 255.0f;
+            float oa = a + da * (1 - a);
+
+            if (oa <= 0)
+                continue;
+
+            auto mix = [a, da, oa] (int s, int d) {
+                return static_cast<int>(std::lround((s * a + d * da * (1 - a)) / oa));
+            };
+
+            line[x] = image::pack(color{mix(c.get_red(), d.get_red())
+                , mix(c.get_green(), d.get_green())
+                , mix(c.get_blue(), d.get_blue())
+                , static_cast<int>(std::lround(oa * 255))});
+        }
+    }
+}
+
+inline void tile_rasterizer::rasterize_tile (int tile_index
+    , mesh const & m
+    , std::int16_t * winding
+    , image & target) const
+{
+    std::vector<bin_entry> const & entries = _bins[tile_index];
+    rect<int> tile = tile_rect(tile_index, target);
+
+    for (std::size_t i = 0; i < entries.size();) {
+        std::uint32_t ci = entries[i].command;
+        mesh_command const & cmd = m.commands[ci];
+        bool accumulate = cmd.type == mesh_command_type::stencil_fan;
+        rect<int> dirty;
+
+        // All triangles of the command in this tile
+        for (; i < entries.size() && entries[i].command == ci; i++) {
+            std::uint32_t k = entries[i].first_index;
+            rasterize_triangle(tile
+                , m.vertices[m.indices[k]]
+                , m.vertices[m.indices[k + 1]]
+                , m.vertices[m.indices[k + 2]]
+                , accumulate
+                , winding
+                , dirty);
+        }
+
+        if (!dirty.is_empty())
+            composite(tile, dirty, cmd.fill_color, winding, target);
+    }
+}
+
+inline void tile_rasterizer::draw (mesh const & m, image & target)
+{
+    _tiles_x = (target.get_width() + _tile_size - 1) / _tile_size;
+    _tiles_y = (target.get_height() + _tile_size - 1) / _tile_size;
+
+    std::size_t ntiles = static_cast<std::size_t>(_tiles_x) * _tiles_y;
+
+    if (_bins.size() < ntiles)
+        _bins.resize(ntiles);
+
+    for (std::size_t i = 0; i < ntiles; i++)
+        _bins[i].clear();
+
+    if (ntiles == 0)
+        return;
+
+    bin(m, target.get_rect());
+
+    std::size_t scratch_size = static_cast<std::size_t>(_tile_size) * _tile_size
+        * _subsamples * _subsamples;
+
+    _jobs->parallel_for(ntiles, 1, [&] (std::size_t first, std::size_t last) {
+        // Winding buffer is kept zeroed by composite()
+        std::vector<std::int16_t> winding(scratch_size, 0);
+
+        for (std::size_t t = first; t < last; t++) {
+            if (!_bins[t].empty())
+                rasterize_tile(static_cast<int>(t), m, winding.data(), target);
+        }
+    });
+}
+
+}} // namespace pfs::griotte
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.25 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <atomic>
+
+namespace pfs {
+namespace griotte {
+
+/**
+ * @class triple_buffer
+ * @brief Lock-free single producer / single consumer handoff of the latest
+ *        value (e.g. frame description) between two threads.
+ *
+ * Producer fills back() and publishes it, consumer fetches the latest
+ * published value into front(). Neither side ever waits for the other:
+ * the producer always has a free buffer to write and the consumer always
+ * sees a complete value. Values published but not fetched in time are
+ * overwritten by the newer ones.
+ */
+template <typename T>
+class triple_buffer
+{
+    static constexpr unsigned int index_mask = 0x3;
+    static constexpr unsigned int fresh_bit  = 0x4;
+
+    T _buffers[3];
+
+    // Index of the buffer shared between producer and consumer, and flag of
+    // unfetched value in it.
+    std::atomic<unsigned int> _middle {1};
+
+    unsigned int _back {0};  // owned by producer
+    unsigned int _front {2}; // owned by consumer
+
+public:
+    triple_buffer () = default;
+    triple_buffer (triple_buffer const &) = delete;
+    triple_buffer & operator = (triple_buffer const &) = delete;
+
+    /**
+     * @brief Buffer to fill by the producer.
+     */
+    T & back () noexcept
+    {
+        return _buffers[_back];
+    }
+
+    /**
+     * @brief Publishes the back buffer, the producer gets a free buffer
+     *        instead.
+     */
+    void publish () noexcept
+    {
+        _back = _middle.exchange(_back | fresh_bit, std::memory_order_acq_rel)
+            & index_mask;
+    }
+
+    /**
+     * @return @c true if there is a published value not fetched yet.
+     */
+    bool has_fresh () const noexcept
+    {
+        return (_middle.load(std::memory_order_acquire) & fresh_bit) != 0;
+    }
+
+    /**
+     * @brief Makes the latest published value available by front().
+     * @return @c false if nothing was published since the last fetch.
+     */
+    bool fetch () noexcept
+    {
+        if (!has_fresh())
+            return false;
+
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & index_mask;
+        return true;
+    }
+
+    /**
+     * @brief Latest fetched value for the consumer.
+     */
+    T & front () noexcept
+    {
+        return _buffers[_front];
+    }
+
+    T const & front () const noexcept
+    {
+        return _buffers[_front];
+    }
+};
+
+template <typename T>
+constexpr unsigned int triple_buffer<T>::index_mask;
+
+template <typename T>
+constexpr unsigned int triple_buffer<T>::fresh_bit;
+
+}} // namespace pfs::griotte
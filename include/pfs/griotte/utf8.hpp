@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.05 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace pfs {
+namespace griotte {
+
+constexpr char32_t replacement_char = 0xFFFD;
+
+/**
+ * @brief Decodes UTF-8 code point at @a pos of @a text of @a len bytes
+ *        and advances @a pos past it.
+ *
+ * @return Decoded code point, replacement_char for ill-formed sequence
+ *         (one byte is skipped then).
+ */
+inline char32_t utf8_decode (char const * text, std::size_t len, std::size_t & pos) noexcept
+{
+    auto s = reinterpret_cast<std::uint8_t const *>(text);
+    std::uint8_t b = s[pos++];
+
+    if (b < 0x80)
+        return b;
+
+    int n = 0;
+    char32_t cp = 0;
+    char32_t min = 0;
+
+    if ((b & 0xE0) == 0xC0) {
+        n = 1; cp = b & 0x1F; min = 0x80;
+    } else if ((b & 0xF0) == 0xE0) {
+        n = 2; cp = b & 0x0F; min = 0x800;
+    } else if ((b & 0xF8) == 0xF0) {
+        n = 3; cp = b & 0x07; min = 0x10000;
+    } else {
+        return replacement_char;
+    }
+
+    if (len - pos < static_cast<std::size_t>(n))
+        return replacement_char;
+
+    for (int i = 0; i < n; i++) {
+        if ((s[pos + i] & 0xC0) != 0x80)
+            return replacement_char;
+
+        cp = (cp << 6) | (s[pos + i] & 0x3F);
+    }
+
+    // Overlong forms, surrogates and out of range values
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        return replacement_char;
+
+    pos += n;
+    return cp;
+}
+
+}} // namespace pfs::griotte
@@ -12,6 +12,23 @@ class view
 
     rect_type _rect;
 
+public:
+    /**
+     * @return The geometry of the view relative to its parent.
+     */
+    rect_type const & get_geometry () const noexcept
+    {
+        return _rect;
+    }
+
+    /**
+     * @brief Sets the geometry of the view relative to its parent.
+     */
+    void set_geometry (rect_type const & r) noexcept
+    {
+        _rect = r;
+    }
+
 // class QWidgetData
 // {
 // public:
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+################################################################################
+# Copyright (c) 2021 Vladislav Trifochkin
+#
+# This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+#
+# Generates GriotteTestVariable.ttf used by tests/font_instance.cpp
+# (requires fontTools).
+#
+# The font has a single 'wght' axis (100..900, default 400) and three named
+# instances: "Thin" (100), "Regular" (400) and "Bold" (700). Glyph 'a' is a rectangle whose
+# width and advance grow with the weight:
+#
+#   wght    ink width   advance (font units, 1000 per EM)
+#   100        50         450
+#   400       100         500
+#   900       400         800
+#
+# Glyph 'i' does not vary.
+#
+# Changelog:
+#      2021.07.13 Initial version
+################################################################################
+import os
+import sys
+
+from fontTools.fontBuilder import FontBuilder
+from fontTools.misc.timeTools import timestampFromString
+from fontTools.pens.ttGlyphPen import TTGlyphPen
+from fontTools.ttLib.tables.TupleVariation import TupleVariation
+
+
+def rect (width):
+    pen = TTGlyphPen(None)
+    pen.moveTo((50, 0))
+    pen.lineTo((50 + width, 0))
+    pen.lineTo((50 + width, 700))
+    pen.lineTo((50, 700))
+    pen.closePath()
+    return pen.glyph()
+
+
+def width_deltas (dx):
+    # Four contour points followed by four phantom points (the second one
+    # is the advance)
+    return [(0, 0), (dx, 0), (dx, 0), (0, 0), (0, 0), (dx, 0), (0, 0), (0, 0)]
+
+
+def main (path):
+    fb = FontBuilder(1000, isTTF = True)
+    fb.setupGlyphOrder([".notdef", "a", "i"])
+    fb.setupCharacterMap({ord('a'): "a", ord('i'): "i"})
+    fb.setupGlyf({".notdef": rect(100), "a": rect(100), "i": rect(100)})
+    fb.setupHorizontalMetrics({".notdef": (500, 50), "a": (500, 50), "i": (500, 50)})
+    fb.setupHorizontalHeader(ascent = 800, descent = -200)
+    fb.setupNameTable({"familyName": "Griotte Test Variable", "styleName": "Regular"})
+    fb.setupOS2(sTypoAscender = 800, sTypoDescender = -200, usWinAscent = 800, usWinDescent = 200)
+    fb.setupPost()
+
+    fb.setupFvar([("wght", 100, 400, 900, "Weight")], [
+          dict(location = dict(wght = 100), stylename = "Thin")
+        , dict(location = dict(wght = 400), stylename = "Regular")
+        , dict(location = dict(wght = 700), stylename = "Bold")])
+
+    fb.setupGvar({
+          ".notdef": []
+        , "i": []
+        , "a": [
+              TupleVariation({"wght": (0, 1.0, 1.0)}, width_deltas(300))
+            , TupleVariation({"wght": (-1.0, -1.0, 0)}, width_deltas(-50))]})
+
+    # Reproducible output
+    fb.font["head"].created = timestampFromString("Tue Jul 13 00:00:00 2021")
+    fb.font["head"].modified = fb.font["head"].created
+    fb.font.recalcTimestamp = False
+    fb.save(path)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1
+        else os.path.join(os.path.dirname(os.path.abspath(__file__)), "GriotteTestVariable.ttf"))
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.28 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/arena.hpp"
+#include "pfs/griotte/path.hpp"
+#include "pfs/griotte/pen.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+static std::size_t heap_allocations = 0;
+
+void * operator new (std::size_t size)
+{
+    ++heap_allocations;
+
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc{};
+}
+
+void operator delete (void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using namespace pfs::griotte;
+
+using path_allocator = arena_allocator<path_entry<float>>;
+using arena_path = path<float, path_allocator>;
+
+TEST_CASE("Alignment and reset") {
+    frame_arena arena {256};
+
+    auto p1 = arena.allocate(1, 1);
+    auto p2 = arena.allocate(8, 8);
+    auto p3 = arena.allocate(300, 16);
+
+    REQUIRE(p1 != nullptr);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(p2) % 8 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(p3) % 16 == 0);
+    REQUIRE(arena.used() >= 309);
+
+    auto capacity = arena.capacity();
+    arena.reset();
+
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.peak() >= 309);
+    REQUIRE(arena.allocate(1, 1) == p1);
+    REQUIRE(arena.capacity() == capacity);
+}
+
+TEST_CASE("Frames without heap traffic") {
+    frame_arena arena;
+
+    auto build_frame = [& arena] {
+        float sum = 0;
+
+        for (int i = 0; i < 100; i++) {
+            arena_path p {point<float>{0, 0}, path_allocator{arena}};
+
+            for (int j = 0; j < 50; j++)
+                p.line_to(static_cast<float>(j), static_cast<float>(i));
+
+            pen<float> apen {color{}, 1.0f};
+            apen.set_dasharray({4, 2, 1, 2});
+
+            sum += p.cbegin()[p.size() - 1].p.x() + apen.get_dasharray()[0];
+        }
+
+        arena.reset();
+        return sum;
+    };
+
+    // Warm up: arena reaches its working size
+    build_frame();
+
+    auto before = heap_allocations;
+
+    for (int frame = 0; frame < 10; frame++)
+        REQUIRE(build_frame() == doctest::Approx(100 * (49 + 4)));
+
+    REQUIRE(heap_allocations == before);
+}
+
+TEST_CASE("Path with default allocator") {
+    path<int> p;
+    p.line_to(10, 10);
+    p.clear();
+
+    REQUIRE(p.size() == 1);
+    REQUIRE(p.cbegin()->type == path_entry_enum::move_to);
+}
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.06 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/bidi.hpp"
+#include <string>
+#include <vector>
+
+using namespace pfs::griotte;
+
+namespace {
+
+// Visual runs as "text:level" strings
+std::vector<std::string> runs_of (std::string const & text
+    , text_direction base = text_direction::automatic)
+{
+    bidi_paragraph bidi {text.data(), text.size(), base};
+    std::vector<visual_run> runs;
+    bidi.visual_runs(0, text.size(), runs);
+
+    std::vector<std::string> result;
+
+    for (auto const & r: runs)
+        result.push_back(text.substr(r.first, r.last - r.first) + ":" + std::to_string(r.level));
+
+    return result;
+}
+
+using strings = std::vector<std::string>;
+
+} // namespace
+
+TEST_CASE("Bidi classes") {
+    REQUIRE(bidi_class_of('a') == bidi_class::l);
+    REQUIRE(bidi_class_of('1') == bidi_class::en);
+    REQUIRE(bidi_class_of(' ') == bidi_class::ws);
+    REQUIRE(bidi_class_of(0x05D0) == bidi_class::r);   // Alef
+    REQUIRE(bidi_class_of(0x0627) == bidi_class::al);  // Arabic alef
+    REQUIRE(bidi_class_of(0x0661) == bidi_class::an);  // Arabic-indic one
+    REQUIRE(bidi_class_of(0x064E) == bidi_class::nsm); // Fatha
+    REQUIRE(bidi_class_of(0x202B) == bidi_class::bn);  // RLE
+}
+
+TEST_CASE("Bidi left-to-right text") {
+    bidi_paragraph bidi {"Hello, world", 12};
+
+    REQUIRE(bidi.is_ltr());
+    REQUIRE(runs_of("Hello, world") == strings{"Hello, world:0"});
+    REQUIRE(runs_of("").empty());
+}
+
+TEST_CASE("Bidi mixed text") {
+    // Hebrew word inside Latin text
+    REQUIRE(runs_of("abc אבג def") == strings{"abc :0", "אבג:1", " def:0"});
+
+    // Latin word inside Hebrew text: the paragraph is right-to-left
+    REQUIRE(runs_of("אב abc ג") == strings{" ג:1", "abc:2", "אב :1"});
+
+    // Forced base direction
+    REQUIRE(runs_of("abc אב", text_direction::rtl) == strings{" אב:1", "abc:2"});
+
+    // Numbers after Arabic letters are Arabic numbers (higher level)
+    REQUIRE(runs_of("ال 123") == strings{"123:2", "ال :1"});
+
+    // European number with terminator and separator inside Hebrew
+    REQUIRE(runs_of("א $1,5") == strings{"$1,5:2", "א :1"});
+
+    // Combining mark follows its base
+    REQUIRE(runs_of("a אָ") == strings{"a :0", "אָ:1"});
+
+    // Trailing whitespace takes the paragraph level (L1)
+    REQUIRE(runs_of("אב abc  ", text_direction::ltr) == strings{"אב:1", " abc  :0"});
+}
+
+TEST_CASE("Bidi paragraphs") {
+    std::string text {"אב\nabc ג"};
+    bidi_paragraph bidi {text.data(), text.size()};
+
+    REQUIRE(bidi.get_base_level(0) == 1);
+    REQUIRE(bidi.get_base_level(text.find('a')) == 0);
+
+    std::vector<visual_run> runs;
+    bidi.visual_runs(text.find('a'), text.size(), runs);
+
+    REQUIRE(runs.size() == 2);
+    REQUIRE(runs[0].direction() == text_direction::ltr);
+    REQUIRE(runs[1].direction() == text_direction::rtl);
+}
+
+TEST_CASE("Visual run cache") {
+    visual_run_cache cache {2};
+
+    auto a = cache.get("abc א");
+    REQUIRE(a->runs.size() == 2);
+    REQUIRE(a->base_level == 0);
+    REQUIRE(cache.get("abc א").get() == a.get());
+    REQUIRE(cache.hits() == 1);
+
+    REQUIRE(cache.get("abc א", text_direction::rtl).get() != a.get());
+    REQUIRE(cache.get("abc א", text_direction::rtl)->base_level == 1);
+
+    cache.get("x");
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.misses() == 3);
+}
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.30 Initial version
+//      2021.07.13 Dots and dashes across the start of closed polylines.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/tessellator.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace pfs::griotte;
+
+using pen_type = pen<float>;
+
+namespace {
+
+struct dash_result
+{
+    std::vector<mesh_vertex> points;
+    std::vector<contour> contours;
+
+    mesh_vertex const & front (std::size_t i) const
+    {
+        return points[contours[i].first];
+    }
+
+    mesh_vertex const & back (std::size_t i) const
+    {
+        return points[contours[i].first + contours[i].count - 1];
+    }
+};
+
+} // namespace
+
+TEST_CASE("Solid pen is not dashed") {
+    dasher<float> d;
+    REQUIRE_FALSE(d.set_pattern(pen_type{color{}, 1.0f}));
+
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({0, 0});
+    REQUIRE_FALSE(d.set_pattern(p));
+
+    p.set_dasharray({2, -1});
+    REQUIRE_FALSE(d.set_pattern(p));
+}
+
+TEST_CASE("Dashes of a polyline") {
+    dasher<float> d;
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({4, 2});
+    REQUIRE(d.set_pattern(p));
+    REQUIRE(d.get_period() == 6.0f);
+
+    // Corner at (14, 0): the dash [12, 16) crosses it
+    mesh_vertex line[] = {{0, 0}, {14, 0}, {14, 10}};
+    dash_result r;
+    d.dash(line, 3, false, r.points, r.contours);
+
+    // Dashes: [0,4) [6,10) [12,16) [18,22)
+    REQUIRE(r.contours.size() == 4);
+    REQUIRE(r.front(0).x == 0);
+    REQUIRE(r.back(0).x == 4);
+    REQUIRE(r.front(1).x == 6);
+    REQUIRE(r.back(1).x == 10);
+
+    REQUIRE(r.contours[2].count == 3);
+    REQUIRE(r.front(2).x == 12);
+    REQUIRE(r.points[r.contours[2].first + 1].x == 14);
+    REQUIRE(r.points[r.contours[2].first + 1].y == 0);
+    REQUIRE(r.back(2).x == 14);
+    REQUIRE(r.back(2).y == 2);
+
+    REQUIRE(r.front(3).y == 4);
+    REQUIRE(r.back(3).y == 8);
+}
+
+TEST_CASE("Dash offset and odd pattern") {
+    dasher<float> d;
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({3});
+    p.set_dash_offset(-1);
+    REQUIRE(d.set_pattern(p));
+    REQUIRE(d.get_period() == 6.0f);
+
+    mesh_vertex line[] = {{0, 0}, {12, 0}};
+    dash_result r;
+    d.dash(line, 2, false, r.points, r.contours);
+
+    // Phase 5: gap [0,1), dashes [1,4) [7,10)
+    REQUIRE(r.contours.size() == 2);
+    REQUIRE(r.front(0).x == 1);
+    REQUIRE(r.back(0).x == 4);
+    REQUIRE(r.front(1).x == 7);
+    REQUIRE(r.back(1).x == 10);
+
+    // Large offset is reduced by the pattern period
+    p.set_dash_offset(601);
+    d.set_pattern(p);
+    dash_result r2;
+    d.dash(line, 2, false, r2.points, r2.contours);
+    // Phase 1: dashes [0,2) [5,8) [11,12)
+    REQUIRE(r2.contours.size() == 3);
+    REQUIRE(r2.front(0).x == 0);
+    REQUIRE(r2.back(0).x == 2);
+    REQUIRE(r2.front(1).x == 5);
+    REQUIRE(r2.back(1).x == 8);
+    REQUIRE(r2.front(2).x == 11);
+    REQUIRE(r2.back(2).x == 12);
+}
+
+TEST_CASE("Phase across subpaths") {
+    dasher<float> d;
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({4, 4});
+    d.set_pattern(p);
+
+    mesh_vertex a[] = {{0, 0}, {6, 0}};
+    mesh_vertex b[] = {{0, 10}, {6, 10}};
+
+    dash_result r;
+    d.dash(a, 2, false, r.points, r.contours);
+    d.dash(b, 2, false, r.points, r.contours);
+
+    // Restarted at every subpath
+    REQUIRE(r.contours.size() == 2);
+    REQUIRE(r.front(1).x == 0);
+
+    d.set_continuous(true);
+    d.restart();
+
+    dash_result rc;
+    d.dash(a, 2, false, rc.points, rc.contours);
+    d.dash(b, 2, false, rc.points, rc.contours);
+
+    // Second subpath starts in the gap [6, 8)
+    REQUIRE(rc.contours.size() == 2);
+    REQUIRE(rc.front(1).x == 2);
+    REQUIRE(rc.back(1).x == 6);
+}
+
+TEST_CASE("Closed polyline") {
+    dasher<float> d;
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({5, 5});
+    d.set_pattern(p);
+
+    mesh_vertex square[] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    dash_result r;
+    d.dash(square, 4, true, r.points, r.contours);
+
+    // Perimeter 40: four dashes, the last on the closing segment
+    REQUIRE(r.contours.size() == 4);
+    REQUIRE_FALSE(r.contours[3].closed);
+    REQUIRE(r.front(3).y == 10);
+    REQUIRE(r.back(3).y == 5);
+}
+
+TEST_CASE("Dashes across the start of a closed polyline") {
+    dasher<float> d;
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({6, 4});
+    p.set_dash_offset(2);
+    d.set_pattern(p);
+
+    mesh_vertex square[] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    dash_result r;
+    d.dash(square, 4, true, r.points, r.contours);
+
+    // Phase 2: dashes [0,4) [8,14) [18,24) [28,34) [38,40), the first and
+    // the last are one dash with the start corner inside
+    REQUIRE(r.contours.size() == 4);
+    REQUIRE(r.front(0).x == 8);
+    REQUIRE(r.front(0).y == 0);
+
+    contour const & c = r.contours[3];
+    REQUIRE_FALSE(c.closed);
+    REQUIRE(c.count == 3);
+    REQUIRE(r.front(3).x == 0);
+    REQUIRE(r.front(3).y == 2);
+    REQUIRE(r.points[c.first + 1].x == 0);
+    REQUIRE(r.points[c.first + 1].y == 0);
+    REQUIRE(r.back(3).x == 4);
+    REQUIRE(r.back(3).y == 0);
+    REQUIRE(c.first + c.count == r.points.size());
+
+    // Dash longer than the polyline keeps it closed
+    p.set_dasharray({100, 10});
+    p.set_dash_offset(0);
+    d.set_pattern(p);
+
+    dash_result r2;
+    d.dash(square, 4, true, r2.points, r2.contours);
+    REQUIRE(r2.contours.size() == 1);
+    REQUIRE(r2.contours[0].closed);
+    REQUIRE(r2.contours[0].count == 4);
+}
+
+TEST_CASE("Zero length dashes") {
+    dasher<float> d;
+    pen_type p {color{}, 2.0f};
+    p.set_dasharray({0, 4});
+    REQUIRE(d.set_pattern(p));
+
+    mesh_vertex line[] = {{0, 0}, {10, 0}};
+    dash_result r;
+    d.dash(line, 2, false, r.points, r.contours);
+
+    // Dots at 0, 4 and 8
+    REQUIRE(r.contours.size() == 3);
+
+    for (std::size_t i = 0; i < r.contours.size(); i++) {
+        REQUIRE(r.contours[i].count == 2);
+        REQUIRE(r.front(i).x == 4.0f * i);
+        REQUIRE(r.back(i).x == r.front(i).x);
+        REQUIRE(r.contours[i].dir.x == 1);
+        REQUIRE(r.contours[i].dir.y == 0);
+    }
+
+    tessellator<float> t;
+    path<float> apath;
+    apath.move_to(0, 0);
+    apath.line_to(10, 0);
+
+    // Butt caps draw nothing, square caps draw squares of the pen width
+    mesh butt;
+    t.stroke(apath, p, butt);
+    REQUIRE(butt.indices.empty());
+
+    pen_type square_pen {color{}, 2.0f, cap_style::square};
+    square_pen.set_dasharray({0, 4});
+    mesh squares;
+    t.stroke(apath, square_pen, squares);
+    REQUIRE(squares.indices.size() == 3 * 4 * 3);
+
+    for (std::size_t i = 0; i < 3; i++) {
+        float x0 = 1000;
+        float x1 = -1000;
+
+        for (std::size_t k = i * 12; k < (i + 1) * 12; k++) {
+            x0 = (std::min)(x0, squares.vertices[squares.indices[k]].x);
+            x1 = (std::max)(x1, squares.vertices[squares.indices[k]].x);
+        }
+
+        REQUIRE(x0 == doctest::Approx(4.0f * i - 1));
+        REQUIRE(x1 == doctest::Approx(4.0f * i + 1));
+    }
+
+    pen_type round_pen {color{}, 2.0f, cap_style::round};
+    round_pen.set_dasharray({0, 4});
+    mesh dots;
+    t.stroke(apath, round_pen, dots);
+    REQUIRE_FALSE(dots.indices.empty());
+}
+
+TEST_CASE("Dashed stroke") {
+    tessellator<float> t;
+    mesh solid;
+    mesh dashed;
+
+    path<float> apath;
+    apath.move_to(0, 0);
+    apath.line_to(1000, 0);
+
+    pen_type p {color{}, 2.0f};
+    t.stroke(apath, p, solid);
+
+    p.set_dasharray({1, 9});
+    t.stroke(apath, p, dashed);
+
+    // 100 dashes, two triangles each
+    REQUIRE(solid.indices.size() == 6);
+    REQUIRE(dashed.indices.size() == 100 * 6);
+}
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.24 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/event_queue.hpp"
+#include <vector>
+
+using namespace pfs::griotte;
+
+namespace {
+
+GLFWwindow * const window1 = reinterpret_cast<GLFWwindow *>(0x10);
+GLFWwindow * const window2 = reinterpret_cast<GLFWwindow *>(0x20);
+
+event make_cursor (GLFWwindow * window, double x, double y)
+{
+    event ev;
+    ev.type = event_type::cursor_pos;
+    ev.window = window;
+    ev.cursor_pos = cursor_pos_event{x, y};
+    return ev;
+}
+
+event make_scroll (GLFWwindow * window, double dx, double dy)
+{
+    event ev;
+    ev.type = event_type::scroll;
+    ev.window = window;
+    ev.scroll = scroll_event{dx, dy};
+    return ev;
+}
+
+event make_resize (GLFWwindow * window, int w, int h)
+{
+    event ev;
+    ev.type = event_type::framebuffer_size;
+    ev.window = window;
+    ev.framebuffer_size = framebuffer_size_event{w, h};
+    return ev;
+}
+
+event make_key (GLFWwindow * window, int key)
+{
+    event ev;
+    ev.type = event_type::key;
+    ev.window = window;
+    ev.key = key_event{key, 0, 1, 0};
+    return ev;
+}
+
+} // namespace
+
+TEST_CASE("Adjacent cursor and scroll events are coalesced") {
+    event_queue q;
+
+    q.push(make_cursor(window1, 1, 1));
+    q.push(make_cursor(window1, 2, 2));
+    q.push(make_cursor(window1, 3, 3));
+    q.push(make_scroll(window1, 0, 1));
+    q.push(make_scroll(window1, 0, 2));
+    q.push(make_key(window1, 65));
+    q.push(make_cursor(window1, 4, 4));
+    q.push(make_cursor(window2, 5, 5));
+
+    REQUIRE(q.size() == 5);
+    REQUIRE(q.coalesced() == 3);
+
+    event ev;
+    REQUIRE(q.pop(ev));
+    REQUIRE(ev.type == event_type::cursor_pos);
+    REQUIRE(ev.cursor_pos.x == 3);
+
+    REQUIRE(q.pop(ev));
+    REQUIRE(ev.type == event_type::scroll);
+    REQUIRE(ev.scroll.dy == 3);
+
+    REQUIRE(q.pop(ev));
+    REQUIRE(ev.type == event_type::key);
+
+    REQUIRE(q.pop(ev));
+    REQUIRE(ev.cursor_pos.x == 4);
+
+    REQUIRE(q.pop(ev));
+    REQUIRE(ev.window == window2);
+
+    REQUIRE_FALSE(q.pop(ev));
+}
+
+TEST_CASE("Resize storm gives one event per window") {
+    event_queue q;
+
+    for (int i = 0; i < 50; i++) {
+        q.push(make_resize(window1, 100 + i, 100));
+        q.push(make_cursor(window1, i, i));
+        q.push(make_key(window1, i));
+    }
+
+    q.push(make_resize(window2, 10, 10));
+
+    int resizes = 0;
+    int keys = 0;
+
+    auto n = q.drain([&] (event const & ev) {
+        if (ev.type == event_type::framebuffer_size && ev.window == window1) {
+            REQUIRE(ev.framebuffer_size.width == 149);
+            ++resizes;
+        } else if (ev.type == event_type::key) {
+            ++keys;
+        }
+    });
+
+    REQUIRE(resizes == 1);
+    REQUIRE(keys == 50);
+    REQUIRE(n == 1 + 50 + 50 + 1);
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("Ring buffer grows and keeps order") {
+    event_queue q {4};
+    REQUIRE(q.capacity() == 4);
+
+    event ev;
+
+    // Move head off zero to wrap around
+    q.push(make_key(window1, 0));
+    q.push(make_key(window1, 1));
+    q.pop(ev);
+    q.pop(ev);
+
+    for (int i = 0; i < 10; i++)
+        q.push(make_key(window1, i));
+
+    REQUIRE(q.capacity() == 16);
+
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(q.pop(ev));
+        REQUIRE(ev.key.key == i);
+    }
+
+    REQUIRE(q.empty());
+}
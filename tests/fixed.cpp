@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.03 Initial version
+//      2021.07.13 Dashed fixed-point pen.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/fixed.hpp"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/path.hpp"
+#include "pfs/griotte/rect.hpp"
+#include "pfs/griotte/tessellator.hpp"
+
+using namespace pfs::griotte;
+
+TEST_CASE("Fixed point arithmetic") {
+    fixed26_6 a {3};
+    fixed26_6 b {1.5};
+
+    REQUIRE(a.raw() == 3 * 64);
+    REQUIRE(b.raw() == 96);
+    REQUIRE(fixed26_6::from_raw(96) == b);
+
+    REQUIRE((a + b).raw() == 4 * 64 + 32);
+    REQUIRE((a - b) == b);
+    REQUIRE((a * b).raw() == 4 * 64 + 32);
+    REQUIRE((a / b) == fixed26_6{2});
+    REQUIRE((-b).raw() == -96);
+    REQUIRE(2 * b == a);
+    REQUIRE(a / 2 == b);
+    REQUIRE(b * 2.0 == a);
+    REQUIRE(a > b);
+    REQUIRE(b < 2);
+    REQUIRE(a == 3);
+
+    // Rounding to the nearest representable value
+    REQUIRE((fixed26_6::from_raw(1) / 2).raw() == 1);
+    REQUIRE((fixed26_6::from_raw(-1) / 2).raw() == -1);
+    REQUIRE((fixed26_6{1} / fixed26_6{3}).raw() == 21);
+
+    REQUIRE(fixed26_6{2.5}.floor() == 2);
+    REQUIRE(fixed26_6{-2.5}.floor() == -3);
+    REQUIRE(fixed26_6{2.25}.ceil() == 3);
+    REQUIRE(fixed26_6{-2.25}.ceil() == -2);
+    REQUIRE(fixed26_6{2.5}.round() == 3);
+    REQUIRE(fixed26_6{-2.5}.round() == -3);
+    REQUIRE(static_cast<int>(fixed26_6{-2.75}) == -2);
+    REQUIRE(static_cast<double>(fixed16_16{0.25}) == 0.25);
+
+    fixed16_16 c {1.0 / 65536};
+    REQUIRE(c.raw() == 1);
+    c *= 3;
+    c += fixed16_16{1};
+    REQUIRE(c.raw() == 65536 + 3);
+}
+
+TEST_CASE("Fixed point geometry") {
+    using unit = fixed26_6;
+
+    point<unit> p {unit{10}, unit{2.5}};
+    p *= 0.5;
+
+    REQUIRE(p.x() == 5);
+    REQUIRE(p.y() == unit{1.25});
+
+    p += point<unit>{unit{0.25}, unit{0.25}};
+    REQUIRE(p == point<unit>{unit{5.25}, unit{1.5}});
+
+    rect<unit> r {unit{1.5}, unit{2}, unit{10}, unit{4}};
+    REQUIRE(r.get_right() == unit{10.5});
+    REQUIRE(r.contains(point<unit>{unit{10.25}, unit{3}}));
+    REQUIRE_FALSE(r.contains(point<unit>{unit{10.75}, unit{3}}));
+
+    path<unit> apath;
+    apath.move_to(unit{0}, unit{0});
+    apath.line_to(unit{4.5}, unit{0});
+    apath.curve_to(point<unit>{unit{6}, unit{3}}, point<unit>{unit{3}, unit{6}});
+
+    auto br = control_point_rect(apath);
+    REQUIRE(br.get_x() == 0);
+    REQUIRE(br.get_right() == unit{5.5});
+    REQUIRE(br.get_bottom() == 6);
+
+    // Quadratic curve elevated to cubic with exact subpixel control points
+    auto it = apath.cbegin() + 2;
+    REQUIRE(it->type == path_entry_enum::curve_to);
+    REQUIRE(it->p == point<unit>{unit{5.5}, unit{2}});
+
+    tessellator<unit> t;
+    mesh m;
+    t.stroke(apath, pen<unit>{color{}, unit{1}}, m);
+    REQUIRE_FALSE(m.empty());
+}
+
+TEST_CASE("Fixed point dashed pen") {
+    using unit = fixed26_6;
+
+    REQUIRE(std::hash<unit>{}(unit{1.5}) == std::hash<unit>{}(unit{1.5}));
+
+    pen<unit> p {color{}, unit{1}};
+    p.set_dasharray({unit{4}, unit{2}});
+    REQUIRE(p.get_dash_period() == 6);
+
+    pen<unit> q {color{}, unit{1}};
+    q.set_dasharray({unit{4}, unit{2}});
+    REQUIRE(p == q);
+
+    dasher<unit> d;
+    REQUIRE(d.set_pattern(p));
+
+    path<unit> apath;
+    apath.move_to(unit{0}, unit{0});
+    apath.line_to(unit{20}, unit{0});
+
+    tessellator<unit> t;
+    mesh m;
+    t.stroke(apath, p, m);
+    REQUIRE_FALSE(m.empty());
+}
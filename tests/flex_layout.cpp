@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.18 Initial version
+//      2021.07.13 Added items managed through the base layout test.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/flex_layout.hpp"
+
+using rect = pfs::griotte::rect<int>;
+using size = pfs::griotte::size<int>;
+using margins = pfs::griotte::margins<int>;
+using flex_solver = pfs::griotte::flex_solver<int>;
+using flex_layout = pfs::griotte::flex_layout<int>;
+using layout_item = pfs::griotte::layout_item<int>;
+using orientation = pfs::griotte::orientation;
+
+TEST_CASE("Grow distributes free space") {
+    flex_solver s;
+    auto root = s.add_container(flex_solver::null_id, orientation::horizontal);
+    auto a = s.add_item(root);
+    auto b = s.add_item(root);
+    auto c = s.add_item(root);
+
+    s.set_basis(a, 100);
+    s.set_basis(b, 100);
+    s.set_grow(b, 1);
+    s.set_basis(c, 100);
+    s.set_grow(c, 3);
+
+    s.solve(rect{0, 0, 500, 50});
+
+    REQUIRE(s.get_rect(a) == rect{0, 0, 100, 50});
+    REQUIRE(s.get_rect(b) == rect{100, 0, 150, 50});
+    REQUIRE(s.get_rect(c) == rect{250, 0, 250, 50});
+}
+
+TEST_CASE("Shrink is weighted by basis and respects min/max") {
+    flex_solver s;
+    auto root = s.add_container(flex_solver::null_id, orientation::horizontal);
+    auto a = s.add_item(root);
+    auto b = s.add_item(root);
+    auto c = s.add_item(root);
+
+    s.set_basis(a, 100);
+    s.set_basis(b, 300);
+    s.set_basis(c, 100);
+    s.set_min_max(c, 90, 1000);
+
+    // 100 units overflow
+    s.solve(rect{0, 0, 400, 10});
+
+    // 'c' is frozen at its minimum, 90 units left to 'a' and 'b' (1:3)
+    REQUIRE(s.get_rect(c).get_width() == 90);
+    REQUIRE(s.get_rect(a).get_width() + s.get_rect(b).get_width() == 310);
+    REQUIRE(s.get_rect(a).get_width() == 78);
+    REQUIRE(s.get_rect(b).get_width() == 232);
+}
+
+TEST_CASE("Wrap breaks items into lines") {
+    flex_solver s;
+    auto root = s.add_container(flex_solver::null_id, orientation::horizontal, true);
+    s.set_gap(root, 10);
+
+    flex_solver::id_type items[5];
+
+    for (auto & id: items) {
+        id = s.add_item(root);
+        s.set_size_hint(id, size{40, 20});
+    }
+
+    s.solve(rect{0, 0, 100, 100});
+
+    REQUIRE(s.get_rect(items[0]) == rect{0, 0, 40, 20});
+    REQUIRE(s.get_rect(items[1]) == rect{50, 0, 40, 20});
+    REQUIRE(s.get_rect(items[2]) == rect{0, 30, 40, 20});
+    REQUIRE(s.get_rect(items[3]) == rect{50, 30, 40, 20});
+    REQUIRE(s.get_rect(items[4]) == rect{0, 60, 40, 20});
+}
+
+TEST_CASE("Nested containers") {
+    flex_solver s;
+    auto root = s.add_container(flex_solver::null_id, orientation::vertical);
+    auto header = s.add_item(root);
+    auto body = s.add_container(root, orientation::horizontal);
+    auto left = s.add_item(body);
+    auto right = s.add_item(body);
+
+    s.set_size_hint(header, size{0, 30});
+    s.set_grow(body, 1);
+    s.set_size_hint(left, size{50, 0});
+    s.set_grow(right, 1);
+    s.set_margins(right, margins{0, 0, 0, 5});
+
+    s.solve(rect{0, 0, 200, 100});
+
+    REQUIRE(s.get_content_size(body) == size{55, 0});
+    REQUIRE(s.get_rect(header) == rect{0, 0, 200, 30});
+    REQUIRE(s.get_rect(body) == rect{0, 30, 200, 70});
+    REQUIRE(s.get_rect(left) == rect{0, 30, 50, 70});
+    REQUIRE(s.get_rect(right) == rect{55, 30, 145, 70});
+}
+
+TEST_CASE("Flex layout") {
+    layout_item a{size{20, 10}};
+    layout_item b{size{20, 10}};
+    flex_layout l{orientation::horizontal};
+
+    flex_layout::flex_params grow;
+    grow.grow = 1;
+
+    l.set_spacing(4);
+    l.add_item(& a);
+    l.add_item(& b, grow);
+
+    REQUIRE(l.measure() == size{44, 10});
+
+    l.arrange(rect{0, 0, 100, 10});
+
+    REQUIRE(a.get_geometry() == rect{0, 0, 20, 10});
+    REQUIRE(b.get_geometry() == rect{24, 0, 76, 10});
+}
+
+TEST_CASE("Flex layout items managed through the base layout") {
+    using layout = pfs::griotte::layout<int>;
+
+    layout_item a{size{20, 10}};
+    layout_item b{size{20, 10}};
+    layout_item c{size{20, 10}};
+    flex_layout l{orientation::horizontal};
+    layout & base = l;
+
+    flex_layout::flex_params grow;
+    grow.grow = 1;
+
+    base.add_item(& a);
+    l.add_item(& b, grow);
+    base.add_item(& c);
+    base.remove_item(& a);
+
+    REQUIRE(l.count() == 2);
+    REQUIRE(l.measure() == size{40, 10});
+
+    l.arrange(rect{0, 0, 100, 10});
+
+    // Parameters follow their items
+    REQUIRE(b.get_geometry() == rect{0, 0, 80, 10});
+    REQUIRE(c.get_geometry() == rect{80, 0, 20, 10});
+}
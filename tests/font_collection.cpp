@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.07 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/font_collection.hpp"
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace pfs::griotte;
+
+namespace {
+
+struct fake_font
+{
+    std::vector<std::pair<char32_t, char32_t>> ranges; // inclusive
+    bool valid;
+    int * coverage_calls;
+
+    fake_font ()
+        : valid(false)
+        , coverage_calls(nullptr)
+    {}
+
+    fake_font (std::vector<std::pair<char32_t, char32_t>> const & r, int * calls)
+        : ranges(r)
+        , valid(true)
+        , coverage_calls(calls)
+    {}
+
+    explicit operator bool () const noexcept
+    {
+        return valid;
+    }
+
+    coverage_bitmap get_coverage () const
+    {
+        ++*coverage_calls;
+        coverage_bitmap result;
+
+        for (auto const & r: ranges) {
+            for (char32_t cp = r.first; cp <= r.second; cp++)
+                result.set(cp);
+        }
+
+        return result;
+    }
+};
+
+struct fake_loader
+{
+    std::map<std::string, std::vector<std::pair<char32_t, char32_t>>> files;
+    std::vector<std::string> loaded;
+    int coverage_calls {0};
+
+    fake_font load_font (std::string const & path, int)
+    {
+        loaded.push_back(path);
+        auto pos = files.find(path);
+
+        if (pos == files.end())
+            return fake_font{};
+
+        return fake_font{pos->second, & coverage_calls};
+    }
+};
+
+using collection = basic_font_collection<fake_loader, fake_font>;
+
+} // namespace
+
+TEST_CASE("Coverage bitmap") {
+    coverage_bitmap c;
+
+    REQUIRE(c.empty());
+    REQUIRE_FALSE(c.test('a'));
+
+    c.set('a');
+    c.set('a');
+    c.set(0x10FFFF);
+    c.set(0x110000);
+
+    REQUIRE(c.count() == 2);
+    REQUIRE(c.test('a'));
+    REQUIRE_FALSE(c.test('b'));
+    REQUIRE(c.test(0x10FFFF));
+    REQUIRE_FALSE(c.test(0x110000));
+    REQUIRE_FALSE(c.test(0x10FF00));
+}
+
+TEST_CASE("Font fallback resolution") {
+    fake_loader loader;
+    loader.files["latin"] = {{0x20, 0x7E}};
+    loader.files["cyrillic"] = {{0x20, 0x20}, {0x0400, 0x04FF}};
+    loader.files["cjk"] = {{0x4E00, 0x9FFF}};
+
+    collection fonts {loader};
+
+    REQUIRE(fonts.add("latin") == 0);
+    REQUIRE(fonts.add("cyrillic") == 1);
+    REQUIRE(fonts.add("missing") == 2);
+    REQUIRE(fonts.add("cjk") == 3);
+    REQUIRE(loader.loaded.empty());
+
+    // Fallback faces are loaded on first need
+    REQUIRE(fonts.resolve('a') == 0);
+    REQUIRE(loader.loaded == std::vector<std::string>{"latin"});
+
+    REQUIRE(fonts.resolve(0x0416) == 1);
+    REQUIRE(loader.loaded.size() == 2);
+    REQUIRE(fonts.is_loaded(1));
+    REQUIRE_FALSE(fonts.is_loaded(3));
+
+    REQUIRE(fonts.resolve(0x4E2D) == 3);
+    REQUIRE(fonts.get_font(2) == nullptr);
+    REQUIRE(fonts.resolve(0x0627) == collection::npos);
+
+    // Resolved code points are cached, faces are loaded once
+    REQUIRE(loader.loaded.size() == 4);
+    REQUIRE(loader.coverage_calls == 3);
+    REQUIRE(fonts.resolve(0x0416) == 1);
+    REQUIRE(fonts.resolve(0x0627) == collection::npos);
+    REQUIRE(loader.loaded.size() == 4);
+
+    // Added face covers previously uncovered code point
+    loader.files["arabic"] = {{0x0600, 0x06FF}};
+    REQUIRE(fonts.add("arabic") == 4);
+    REQUIRE(fonts.resolve(0x0627) == 4);
+}
+
+TEST_CASE("Font fallback itemization") {
+    fake_loader loader;
+    loader.files["latin"] = {{0x20, 0x7E}};
+    loader.files["cyrillic"] = {{0x20, 0x20}, {0x0400, 0x04FF}};
+
+    collection fonts {loader};
+    fonts.add("latin");
+    fonts.add(loader.load_font("cyrillic", 0));
+
+    std::string text {"ab \xD0\x96\xD0\x96 c\xE2\x82\xAC"}; // "ab ЖЖ c€"
+    std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> runs;
+
+    fonts.itemize(text.data(), text.size(), [& runs] (std::size_t first
+            , std::size_t last, std::size_t face) {
+        runs.emplace_back(first, last, face);
+    });
+
+    // Space after Cyrillic letters stays in the Cyrillic run, uncovered
+    // Euro sign stays in the current run
+    REQUIRE(runs.size() == 3);
+    REQUIRE(runs[0] == std::make_tuple(std::size_t{0}, std::size_t{3}, std::size_t{0}));
+    REQUIRE(runs[1] == std::make_tuple(std::size_t{3}, std::size_t{8}, std::size_t{1}));
+    REQUIRE(runs[2] == std::make_tuple(std::size_t{8}, text.size(), std::size_t{0}));
+}
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.13 Initial version
+//      2021.07.13 Added variable font tests.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/font.hpp"
+#include "pfs/griotte/glyph_cache.hpp"
+#include "test_fonts.hpp"
+#include <string>
+
+using namespace pfs::griotte;
+
+TEST_CASE("Font that is not variable") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    {
+        font f {face};
+
+        REQUIRE_FALSE(f.is_variable());
+        REQUIRE(f.get_variation_axes().empty());
+        REQUIRE(f.named_instance_count() == 0);
+
+        std::error_code ec;
+        auto fi = f.make_instance({}, ec);
+
+        REQUIRE_FALSE(static_cast<bool>(ec));
+        REQUIRE(fi == font_instance{f});
+        REQUIRE(fi.get_id() == 0);
+        REQUIRE(fi.native_handle() == face);
+        REQUIRE(fi.activate());
+
+        auto bold = f.make_instance({{make_axis_tag('w', 'g', 'h', 't'), 700}}, ec);
+        REQUIRE((ec == make_error_code(errc::bad_variation)));
+        REQUIRE(bold.get_id() == 0);
+
+        ec.clear();
+        f.make_named_instance(0, ec);
+        REQUIRE((ec == make_error_code(errc::bad_variation)));
+
+        REQUIRE_THROWS_AS(f.make_instance({{make_axis_tag('w', 'g', 'h', 't'), 700}}), exception);
+
+        // The default instance has outlines, unknown instances are rejected
+        ec.clear();
+        auto o = fi.glyph_outline<float>('o', 32, ec);
+        REQUIRE_FALSE(static_cast<bool>(ec));
+        REQUIRE_FALSE(o.empty());
+
+        f.glyph_outline<float>('o', 32, 1, ec);
+        REQUIRE((ec == make_error_code(errc::freetype_error)));
+        REQUIRE_FALSE(font_instance{f, 1}.activate());
+    }
+
+    FT_Done_FreeType(library);
+}
+
+// GriotteTestVariable.ttf is generated by resources/fonts/make_test_variable_font.py:
+// 'wght' axis 100..900 (default 400), named instances "Thin" (100),
+// "Regular" (400) and "Bold" (700). Glyph 'a' is 100 units wide with advance 500 by default,
+// 50/450 at weight 100, 280/680 at weight 700 and 400/800 at weight 900
+// (1000 units per EM).
+TEST_CASE("Variable font") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("GriotteTestVariable.ttf").c_str(), 0, & face) == 0);
+
+    {
+        font f {face};
+        auto const wght = make_axis_tag('w', 'g', 'h', 't');
+
+        REQUIRE(f.is_variable());
+        REQUIRE(f.named_instance_count() == 3);
+
+        auto axes = f.get_variation_axes();
+        REQUIRE(axes.size() == 1);
+        REQUIRE(axes[0].tag == wght);
+        REQUIRE(axes[0].minimum == 100);
+        REQUIRE(axes[0].default_value == 400);
+        REQUIRE(axes[0].maximum == 900);
+
+        std::error_code ec;
+        auto regular = f.make_instance({}, ec);
+        REQUIRE_FALSE(static_cast<bool>(ec));
+        REQUIRE(regular.get_id() == 0);
+
+        auto bold = f.make_instance({{wght, 700}}, ec);
+        REQUIRE_FALSE(static_cast<bool>(ec));
+        REQUIRE(bold.get_id() != 0);
+
+        // Instances with the same coordinates share the identifier
+        REQUIRE(f.make_instance({{wght, 700}}) == bold);
+        REQUIRE(f.make_named_instance(2) == bold);
+
+        // Values out of the axis range are clamped
+        auto black = f.make_instance({{wght, 900}});
+        REQUIRE(f.make_instance({{wght, 1000}}) == black);
+        REQUIRE(f.make_instance({{wght, 50}}) == f.make_named_instance(0));
+        REQUIRE(f.make_instance({{wght, 50}}) != regular);
+
+        f.make_named_instance(3, ec);
+        REQUIRE((ec == make_error_code(errc::bad_variation)));
+
+        ec.clear();
+        f.make_instance({{make_axis_tag('w', 'd', 't', 'h'), 100}}, ec);
+        REQUIRE((ec == make_error_code(errc::bad_variation)));
+        ec.clear();
+
+        // Switching instances changes advances
+        font_metrics regular_metrics {regular, 32};
+        font_metrics bold_metrics {bold, 32};
+        font_metrics black_metrics {black, 32};
+
+        REQUIRE(regular_metrics.advance('a') == fixed26_6{16});
+        REQUIRE(bold_metrics.advance('a') > regular_metrics.advance('a'));
+        REQUIRE(black_metrics.advance('a') > bold_metrics.advance('a'));
+
+        // Advances may be rounded to whole pixels by hinting
+        REQUIRE(static_cast<double>(black_metrics.advance('a')) == doctest::Approx(25.6).epsilon(0.05));
+
+        // Glyphs that do not vary keep their advance
+        REQUIRE(bold_metrics.advance('i') == regular_metrics.advance('i'));
+
+        // Metrics are not affected by the instance activated last
+        REQUIRE(regular_metrics.advance('a') == fixed26_6{16});
+        REQUIRE(regular_metrics.ink_bounds('a').x1 < bold_metrics.ink_bounds('a').x1);
+
+        // Switching instances changes outlines, outlines are cached per
+        // instance
+        auto outline_width = [] (path<float> const & p) {
+            auto r = control_point_rect(p);
+            return static_cast<double>(r.get_right() - r.get_x());
+        };
+
+        auto regular_outline = regular.glyph_outline<float>('a', 32, ec);
+        REQUIRE_FALSE(static_cast<bool>(ec));
+        auto bold_outline = bold.glyph_outline<float>('a', 32, ec);
+        REQUIRE_FALSE(static_cast<bool>(ec));
+
+        REQUIRE(outline_width(regular_outline) == doctest::Approx(3.2));
+        REQUIRE(outline_width(bold_outline) == doctest::Approx(8.96));
+        REQUIRE(outline_width(regular.glyph_outline<float>('a', 32, ec)) == doctest::Approx(3.2));
+        REQUIRE(outline_width(f.glyph_outline<float>('a', 32, black.get_id(), ec)) == doctest::Approx(12.8));
+        REQUIRE_FALSE(static_cast<bool>(ec));
+
+        // Glyph cache keeps glyphs of each instance
+        glyph_atlas atlas;
+        glyph_cache cache {atlas};
+        auto index = FT_Get_Char_Index(face, 'a');
+
+        auto regular_glyph = cache.get(regular, index, 32, 0, ec);
+        REQUIRE(regular_glyph != nullptr);
+        auto bold_glyph = cache.get(bold, index, 32, 0, ec);
+        REQUIRE(bold_glyph != nullptr);
+
+        REQUIRE(bold_glyph != regular_glyph);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(regular_glyph->advance == fixed26_6{16});
+        REQUIRE(static_cast<double>(bold_glyph->advance) == doctest::Approx(21.76).epsilon(0.01));
+        REQUIRE(bold_glyph->region.width > regular_glyph->region.width);
+
+        REQUIRE(cache.get(regular, index, 32, 0, ec) == regular_glyph);
+        REQUIRE(cache.get(f, index, 32, 0, ec) == regular_glyph);
+        REQUIRE(cache.get(bold, index, 32, 0, ec) == bold_glyph);
+        REQUIRE(cache.size() == 2);
+    }
+
+    FT_Done_FreeType(library);
+}
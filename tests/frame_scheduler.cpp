@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.21 Initial version
+//      2021.07.13 Frame pacing without vsync.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/frame_scheduler.hpp"
+
+using frame_scheduler = pfs::griotte::frame_scheduler;
+
+TEST_CASE("Idle scheduler sleeps") {
+    frame_scheduler s{100.0};
+    s.reset(0.0);
+
+    // First frame is always rendered
+    REQUIRE_FALSE(s.idle());
+    REQUIRE(s.wait_timeout(0.0) == 0.0);
+    REQUIRE(s.begin_frame(0.0) == 0);
+    REQUIRE(s.need_render());
+    s.end_frame(0.001);
+
+    REQUIRE(s.idle());
+    REQUIRE(s.wait_timeout(0.001) < 0);
+
+    // Spurious wake up renders nothing
+    REQUIRE(s.begin_frame(5.0) == 0);
+    REQUIRE_FALSE(s.need_render());
+
+    s.request_redraw();
+    REQUIRE_FALSE(s.idle());
+    REQUIRE(s.begin_frame(6.0) == 0);
+    REQUIRE(s.need_render());
+    REQUIRE(s.frames() == 1);
+}
+
+TEST_CASE("Scheduled redraw") {
+    frame_scheduler s;
+    s.reset(0.0);
+    s.begin_frame(0.0);
+    s.schedule_redraw(0.5);
+
+    REQUIRE(s.wait_timeout(0.2) == doctest::Approx(0.3));
+
+    s.begin_frame(0.2);
+    REQUIRE_FALSE(s.need_render());
+
+    s.begin_frame(0.5);
+    REQUIRE(s.need_render());
+    REQUIRE(s.wait_timeout(0.5) < 0);
+}
+
+TEST_CASE("Fixed timestep ticks") {
+    frame_scheduler s{100.0};
+    s.reset(0.0);
+    s.begin_frame(0.0);
+
+    s.set_animating(true);
+
+    // Idle time is not an animation time
+    REQUIRE(s.begin_frame(10.0) == 0);
+    REQUIRE(s.need_render());
+
+    REQUIRE(s.begin_frame(10.025) == 2);
+    REQUIRE(s.alpha() == doctest::Approx(0.5));
+
+    REQUIRE(s.begin_frame(10.031) == 1);
+    REQUIRE(s.alpha() == doctest::Approx(0.1));
+
+    // Long frame is limited by the maximum number of ticks
+    s.set_max_ticks_per_frame(4);
+    REQUIRE(s.begin_frame(11.0) == 4);
+
+    s.set_animating(false);
+    REQUIRE(s.begin_frame(11.01) == 0);
+    REQUIRE(s.need_render() == false);
+    REQUIRE(s.idle());
+}
+
+TEST_CASE("Frame budget") {
+    frame_scheduler s;
+    s.set_refresh_rate(50.0);
+    s.reset(0.0);
+
+    REQUIRE(s.frame_budget() == doctest::Approx(0.02));
+
+    s.begin_frame(1.0);
+    REQUIRE(s.budget_remaining(1.005) == doctest::Approx(0.015));
+    s.end_frame(1.03);
+
+    REQUIRE(s.over_budget_frames() == 1);
+    REQUIRE(s.last_frame_duration() == doctest::Approx(0.03));
+}
+
+// Multi-window loop: vsync belongs to the first window, when it is closed
+// other windows are rendered without a synchronized swap while animating
+TEST_CASE("Frame pacing without vsync") {
+    frame_scheduler s;
+    s.set_refresh_rate(50.0);
+    s.reset(0.0);
+    s.begin_frame(0.0);
+    s.end_frame(0.001);
+
+    s.set_animating(true);
+
+    // Animation frames do not block on events
+    REQUIRE(s.wait_timeout(0.001) == 0.0);
+
+    // Swap of the first window waits for the vertical retrace
+    s.begin_frame(0.02);
+    REQUIRE(s.need_render());
+    s.end_frame(0.025);
+    REQUIRE(s.pacing_delay(0.025, true) == 0.0);
+
+    // First window closed: the frame is paced by the budget
+    s.begin_frame(0.04);
+    REQUIRE(s.need_render());
+    s.end_frame(0.045);
+    REQUIRE(s.pacing_delay(0.045, false) == doctest::Approx(0.015));
+
+    // Over budget frame does not wait
+    s.begin_frame(0.06);
+    s.end_frame(0.09);
+    REQUIRE(s.pacing_delay(0.09, false) == 0.0);
+
+    // Idle loop blocks on events instead
+    s.set_animating(false);
+    s.begin_frame(0.1);
+    REQUIRE(s.pacing_delay(0.1, false) == 0.0);
+}
@@ -0,0 +1,349 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.08 Initial version
+//      2021.07.10 Added color pages tests.
+//      2021.07.13 Added render modes tests.
+//      2021.07.13 Shared font_path().
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/glyph_cache.hpp"
+#include "test_fonts.hpp"
+#include <string>
+#include <vector>
+
+using namespace pfs::griotte;
+
+TEST_CASE("Glyph atlas packing") {
+    glyph_atlas atlas {64, 32, 2};
+    std::vector<std::uint8_t> bitmap(10 * 10, 0xFF);
+    atlas_region r1, r2, r3;
+
+    REQUIRE(atlas.insert(10, 10, bitmap.data(), 10, r1));
+    REQUIRE(atlas.insert(10, 8, bitmap.data(), 10, r2));
+    REQUIRE(atlas.page_count() == 1);
+
+    // Bitmaps of similar height share a shelf and do not overlap
+    REQUIRE(r1.page == 0);
+    REQUIRE(r2.y == r1.y);
+    REQUIRE(r2.x >= r1.x + r1.width + 1);
+    REQUIRE(atlas.get_pixels(0)[r2.y * 64 + r2.x] == 0xFF);
+    REQUIRE(atlas.get_pixels(0)[r1.y * 64 + r1.x + r1.width] == 0);
+
+    auto dirty = atlas.get_dirty_rect(0);
+    REQUIRE(dirty.x0 == 0);
+    REQUIRE(dirty.x1 == r2.x + 10);
+    atlas.clear_dirty(0);
+    REQUIRE(atlas.get_dirty_rect(0).x0 >= atlas.get_dirty_rect(0).x1);
+
+    // Fill both pages
+    int inserted = 2;
+
+    while (atlas.insert(10, 10, bitmap.data(), 10, r3))
+        ++inserted;
+
+    REQUIRE(atlas.page_count() == 2);
+    REQUIRE(inserted == 2 * 5 * 2);
+    REQUIRE_FALSE(atlas.insert(70, 10, bitmap.data(), 70, r3));
+
+    atlas.clear();
+    REQUIRE(atlas.insert(10, 10, bitmap.data(), 10, r3));
+    REQUIRE(r3.page == 0);
+    REQUIRE(r3.x == 0);
+}
+
+TEST_CASE("Glyph atlas color pages") {
+    glyph_atlas atlas {32, 32, 2};
+    std::vector<std::uint8_t> coverage(8 * 8, 0xFF);
+    std::vector<std::uint8_t> rgba(8 * 8 * 4, 0);
+    atlas_region r1, r2, r3;
+
+    for (std::size_t i = 0; i < rgba.size(); i += 4) {
+        rgba[i] = 0x10;
+        rgba[i + 3] = 0xFF;
+    }
+
+    REQUIRE(atlas.insert(8, 8, coverage.data(), 8, r1));
+    REQUIRE(atlas.insert(8, 8, rgba.data(), 8 * 4, atlas_format::rgba, r2));
+
+    // Color bitmaps go to their own page
+    REQUIRE(atlas.page_count() == 2);
+    REQUIRE(r1.page != r2.page);
+    REQUIRE(atlas.get_format(r1.page) == atlas_format::coverage);
+    REQUIRE(atlas.get_format(r2.page) == atlas_format::rgba);
+
+    auto const * pixels = atlas.get_pixels(r2.page);
+    std::size_t offset = (static_cast<std::size_t>(r2.y) * 32 + r2.x) * 4;
+    REQUIRE(pixels[offset] == 0x10);
+    REQUIRE(pixels[offset + 3] == 0xFF);
+
+    // Color bitmaps share pages
+    REQUIRE(atlas.insert(8, 8, rgba.data(), 8 * 4, atlas_format::rgba, r3));
+    REQUIRE(r3.page == r2.page);
+
+    // Empty pages are reused for any format
+    atlas.clear();
+    REQUIRE(atlas.insert(8, 8, rgba.data(), 8 * 4, atlas_format::rgba, r3));
+    REQUIRE(atlas.insert(8, 8, rgba.data(), 8 * 4, atlas_format::rgba, r3));
+    REQUIRE(atlas.page_count() == 2);
+
+    while (atlas.insert(8, 8, rgba.data(), 8 * 4, atlas_format::rgba, r3))
+        ;
+
+    REQUIRE(atlas.get_format(0) == atlas_format::rgba);
+    REQUIRE(atlas.get_format(1) == atlas_format::rgba);
+    REQUIRE_FALSE(atlas.insert(8, 8, coverage.data(), 8, r1));
+}
+
+TEST_CASE("Color bitmap resampling") {
+    // 4x2 BGRA: left half blue, right half red (premultiplied, opaque)
+    std::uint8_t bgra[] = {
+          0xFF, 0, 0, 0xFF,  0xFF, 0, 0, 0xFF,  0, 0, 0xFF, 0xFF,  0, 0, 0xFF, 0xFF
+        , 0xFF, 0, 0, 0xFF,  0xFF, 0, 0, 0xFF,  0, 0, 0xFF, 0xFF,  0, 0, 0x7F, 0x7F
+    };
+
+    std::vector<std::uint8_t> out;
+    resample_bgra(bgra, 4, 2, 16, 2, 1, out);
+
+    REQUIRE(out.size() == 2 * 4);
+
+    // Channels are swapped into RGBA
+    REQUIRE(out[0] == 0);
+    REQUIRE(out[2] == 0xFF);
+    REQUIRE(out[3] == 0xFF);
+
+    // Box filter
+    REQUIRE(out[4] == (0xFF * 3 + 0x7F + 2) / 4);
+    REQUIRE(out[6] == 0);
+    REQUIRE(out[7] == (0xFF * 3 + 0x7F + 2) / 4);
+
+    // Upscaling repeats pixels
+    resample_bgra(bgra, 4, 2, 16, 8, 4, out);
+    REQUIRE(out.size() == 8 * 4 * 4);
+    REQUIRE(out[0 * 4 + 2] == 0xFF);
+    REQUIRE(out[7 * 4 + 0] == 0xFF);
+}
+
+TEST_CASE("Subpixel phase selection") {
+    int pixel = 0;
+
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10}, 4, pixel) == 0);
+    REQUIRE(pixel == 10);
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.25}, 4, pixel) == 1);
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.5}, 4, pixel) == 2);
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.3}, 4, pixel) == 1);
+    REQUIRE(pixel == 10);
+
+    // Rounds up to the next whole pixel
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.9}, 4, pixel) == 0);
+    REQUIRE(pixel == 11);
+
+    REQUIRE(glyph_cache::select_phase(fixed26_6{-0.25}, 4, pixel) == 3);
+    REQUIRE(pixel == -1);
+
+    // No subpixel positioning: rounding to the nearest pixel
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.4}, 1, pixel) == 0);
+    REQUIRE(pixel == 10);
+    REQUIRE(glyph_cache::select_phase(fixed26_6{10.6}, 1, pixel) == 0);
+    REQUIRE(pixel == 11);
+}
+
+TEST_CASE("Subpixel glyph rasterization") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    glyph_atlas atlas;
+    glyph_cache cache {atlas, 4, 32};
+    std::error_code ec;
+
+    auto index = FT_Get_Char_Index(face, 'l');
+    auto g0 = cache.get(face, index, 16, 0, ec);
+    auto g2 = cache.get(face, index, 16, 2, ec);
+
+    REQUIRE_FALSE(static_cast<bool>(ec));
+    REQUIRE(g0 != nullptr);
+    REQUIRE(g2 != nullptr);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.get(face, index, 16, 2, ec) == g2);
+    REQUIRE(g0->advance > 0);
+    REQUIRE(g0->advance == g2->advance);
+
+    // Shifted variant covers different pixels
+    auto const * pixels = atlas.get_pixels(g0->region.page);
+    double center0 = 0;
+    double center2 = 0;
+    double sum0 = 0;
+    double sum2 = 0;
+
+    for (int y = 0; y < g0->region.height; y++) {
+        for (int x = 0; x < g0->region.width; x++) {
+            double v = pixels[(g0->region.y + y) * atlas.get_width() + g0->region.x + x];
+            center0 += v * (x + g0->bearing_x);
+            sum0 += v;
+        }
+    }
+
+    for (int y = 0; y < g2->region.height; y++) {
+        for (int x = 0; x < g2->region.width; x++) {
+            double v = pixels[(g2->region.y + y) * atlas.get_width() + g2->region.x + x];
+            center2 += v * (x + g2->bearing_x);
+            sum2 += v;
+        }
+    }
+
+    REQUIRE(center2 / sum2 - center0 / sum0 == doctest::Approx(0.5).epsilon(0.1));
+
+    // Quads of a run
+    shaped_run run;
+    run.glyphs.push_back(shaped_glyph{index, 0, fixed26_6{4.25}, fixed26_6{}, fixed26_6{}, fixed26_6{}});
+    run.glyphs.push_back(shaped_glyph{index, 1, fixed26_6{4.25}, fixed26_6{}, fixed26_6{}, fixed26_6{}});
+
+    std::vector<glyph_quad> quads;
+    auto end = cache.build_quads(face, 16, run, fixed26_6{10}, fixed26_6{20}, quads, ec);
+
+    REQUIRE_FALSE(static_cast<bool>(ec));
+    REQUIRE(end == fixed26_6{18.5});
+    REQUIRE(quads.size() == 2);
+    REQUIRE(quads[0].x0 == static_cast<float>(10 + g0->bearing_x));
+    REQUIRE(quads[1].x0 == static_cast<float>(14 + cache.get(face, index, 16, 1, ec)->bearing_x));
+    REQUIRE(quads[0].y0 == static_cast<float>(20 - g0->bearing_y));
+
+    // Large text is not positioned with subpixel precision
+    REQUIRE(cache.phases_for(48) == 1);
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+TEST_CASE("Mono and subpixel bitmap conversion") {
+    std::vector<std::uint8_t> scratch;
+    int width = 0;
+    int height = 0;
+    int pitch = 0;
+    atlas_format format = atlas_format::rgba;
+
+    // 10x1 mono: bits 1010000001
+    std::uint8_t mono[] = {0xA0, 0x40};
+    FT_Bitmap bitmap {};
+    bitmap.width = 10;
+    bitmap.rows = 1;
+    bitmap.pitch = 2;
+    bitmap.buffer = mono;
+    bitmap.pixel_mode = FT_PIXEL_MODE_MONO;
+
+    auto pixels = convert_bitmap(bitmap, scratch, width, height, pitch, format);
+    REQUIRE(pixels != nullptr);
+    REQUIRE(format == atlas_format::coverage);
+    REQUIRE(width == 10);
+    REQUIRE(pitch == 10);
+    REQUIRE(pixels[0] == 0xFF);
+    REQUIRE(pixels[1] == 0);
+    REQUIRE(pixels[2] == 0xFF);
+    REQUIRE(pixels[8] == 0);
+    REQUIRE(pixels[9] == 0xFF);
+
+    // 2x1 LCD (subpixels are adjacent bytes)
+    std::uint8_t lcd[] = {10, 20, 30, 40, 50, 60, 0, 0};
+    bitmap.width = 6;
+    bitmap.rows = 1;
+    bitmap.pitch = 8;
+    bitmap.buffer = lcd;
+    bitmap.pixel_mode = FT_PIXEL_MODE_LCD;
+
+    pixels = convert_bitmap(bitmap, scratch, width, height, pitch, format);
+    REQUIRE(format == atlas_format::lcd);
+    REQUIRE(width == 2);
+    REQUIRE(height == 1);
+    REQUIRE(pitch == 8);
+    REQUIRE(pixels[4] == 40);
+    REQUIRE(pixels[5] == 50);
+    REQUIRE(pixels[6] == 60);
+    REQUIRE(pixels[7] == 60);
+
+    // 1x1 LCD_V (subpixels are adjacent rows)
+    std::uint8_t lcd_v[] = {70, 0, 80, 0, 90, 0};
+    bitmap.width = 1;
+    bitmap.rows = 3;
+    bitmap.pitch = 2;
+    bitmap.buffer = lcd_v;
+    bitmap.pixel_mode = FT_PIXEL_MODE_LCD_V;
+
+    pixels = convert_bitmap(bitmap, scratch, width, height, pitch, format);
+    REQUIRE(format == atlas_format::lcd);
+    REQUIRE(width == 1);
+    REQUIRE(height == 1);
+    REQUIRE(pixels[0] == 70);
+    REQUIRE(pixels[1] == 80);
+    REQUIRE(pixels[2] == 90);
+    REQUIRE(pixels[3] == 90);
+
+    bitmap.pixel_mode = FT_PIXEL_MODE_BGRA;
+    REQUIRE(convert_bitmap(bitmap, scratch, width, height, pitch, format) == nullptr);
+}
+
+TEST_CASE("Render modes") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    glyph_atlas atlas;
+    glyph_cache cache {atlas};
+    std::error_code ec;
+    auto index = FT_Get_Char_Index(face, 'o');
+
+    REQUIRE(cache.get_render_mode() == render_mode::light);
+    REQUIRE(cache.phases_for(12) > 1);
+
+    auto light = cache.get(face, index, 12, 0, ec);
+    REQUIRE(light != nullptr);
+
+    // Every mode has its own entry
+    cache.set_render_mode(render_mode::mono);
+    auto mono = cache.get(face, index, 12, 1, ec);
+    REQUIRE_FALSE(static_cast<bool>(ec));
+    REQUIRE(mono != nullptr);
+    REQUIRE(mono != light);
+    REQUIRE(cache.size() == 2);
+
+    // Phases are ignored by hinted modes
+    REQUIRE(cache.get(face, index, 12, 2, ec) == mono);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(atlas.get_format(mono->region.page) == atlas_format::coverage);
+
+    auto const * pixels = atlas.get_pixels(mono->region.page);
+
+    for (int y = 0; y < mono->region.height; y++) {
+        for (int x = 0; x < mono->region.width; x++) {
+            auto v = pixels[(mono->region.y + y) * atlas.get_width() + mono->region.x + x];
+            REQUIRE((v == 0 || v == 0xFF));
+        }
+    }
+
+    cache.set_render_mode(render_mode::lcd);
+    auto lcd = cache.get(face, index, 12, 0, ec);
+    REQUIRE_FALSE(static_cast<bool>(ec));
+    REQUIRE(lcd != nullptr);
+    REQUIRE(atlas.get_format(lcd->region.page) == atlas_format::lcd);
+    REQUIRE(lcd->region.page != mono->region.page);
+
+    cache.set_render_mode(render_mode::lcd_v);
+    auto lcd_v = cache.get(face, index, 12, 0, ec);
+    REQUIRE(lcd_v != nullptr);
+    REQUIRE(lcd_v->region.page == lcd->region.page);
+
+    cache.set_render_mode(render_mode::normal);
+    REQUIRE(cache.get(face, index, 12, 0, ec) != nullptr);
+    REQUIRE(cache.size() == 5);
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.09 Initial version
+//      2021.07.13 Shared font_path().
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/glyph_outline.hpp"
+#include "test_fonts.hpp"
+#include <cstddef>
+#include <string>
+
+using namespace pfs::griotte;
+
+namespace {
+
+template <typename UnitT>
+std::size_t count_entries (path<UnitT> const & p, path_entry_enum type)
+{
+    std::size_t result = 0;
+
+    for (auto it = p.cbegin(); it != p.cend(); ++it)
+        if (it->type == type)
+            ++result;
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Glyph outline") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    // Outer and inner contours, both closed, conics elevated to cubics
+    outline_path o;
+    REQUIRE(load_outline(face, FT_Get_Char_Index(face, 'o'), o));
+    REQUIRE(count_entries(o, path_entry_enum::move_to) == 2);
+    REQUIRE(count_entries(o, path_entry_enum::close_path) == 2);
+    REQUIRE(count_entries(o, path_entry_enum::curve_to) > 0);
+    REQUIRE(count_entries(o, path_entry_enum::curve_to) % 3 == 0);
+
+    // Straight contour of 'l'
+    outline_path l;
+    REQUIRE(load_outline(face, FT_Get_Char_Index(face, 'l'), l));
+    REQUIRE(count_entries(l, path_entry_enum::move_to) == 1);
+    REQUIRE(count_entries(l, path_entry_enum::curve_to) == 0);
+
+    // Scaled to pixels, y axis down: glyph is above the baseline
+    auto scale = 64.0 / face->units_per_EM;
+    auto p = scale_outline<float>(o, scale);
+    auto r = control_point_rect(p);
+
+    REQUIRE(p.size() == o.size());
+    REQUIRE(r.get_y() < 0);
+    REQUIRE(r.get_bottom() > -2);
+    REQUIRE(r.get_bottom() < 2);
+    REQUIRE(r.get_height() > 25);
+    REQUIRE(r.get_height() < 40);
+    REQUIRE(r.get_x() >= 0);
+
+    // Integral units are rounded
+    auto pi = scale_outline<int>(o, scale);
+    auto ri = control_point_rect(pi);
+
+    REQUIRE(pi.size() == o.size());
+    REQUIRE(ri.get_y() == doctest::Approx(r.get_y()).epsilon(0.05));
+
+    // Glyph without contours (space)
+    outline_path space;
+    REQUIRE(load_outline(face, FT_Get_Char_Index(face, ' '), space));
+    REQUIRE(count_entries(space, path_entry_enum::close_path) == 0);
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/job_system.hpp"
+#include <atomic>
+#include <vector>
+
+using pfs::griotte::job_system;
+
+TEST_CASE("Submitted jobs are executed") {
+    job_system jobs {3};
+    REQUIRE(jobs.thread_count() == 3);
+
+    std::atomic<std::size_t> counter {100};
+    std::atomic<int> sum {0};
+
+    for (int i = 0; i < 100; i++) {
+        jobs.submit([i, & sum, & counter] {
+            sum.fetch_add(i);
+            counter.fetch_sub(1);
+        });
+    }
+
+    jobs.wait(counter);
+    REQUIRE(sum.load() == 4950);
+}
+
+TEST_CASE("Parallel for covers the whole range once") {
+    job_system jobs {4};
+    std::vector<int> hits(10007, 0);
+
+    jobs.parallel_for(hits.size(), 100, [& hits] (std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++)
+            hits[i]++;
+    });
+
+    bool once = true;
+
+    for (auto h: hits)
+        once = once && h == 1;
+
+    REQUIRE(once);
+}
+
+TEST_CASE("Nested parallel for") {
+    job_system jobs {2};
+    std::atomic<int> total {0};
+
+    jobs.parallel_for(8, 1, [& jobs, & total] (std::size_t, std::size_t) {
+        jobs.parallel_for(100, 10, [& total] (std::size_t first, std::size_t last) {
+            total.fetch_add(static_cast<int>(last - first));
+        });
+    });
+
+    REQUIRE(total.load() == 800);
+}
+
+TEST_CASE("Job system without workers") {
+    job_system jobs {0};
+    int count = 0;
+
+    jobs.parallel_for(10, 3, [& count] (std::size_t first, std::size_t last) {
+        count += static_cast<int>(last - first);
+    });
+
+    REQUIRE(count == 10);
+}
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.16 Initial version
+//      2021.07.13 Items destroyed before the layout.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/linear_layout.hpp"
+
+using rect = pfs::griotte::rect<int>;
+using size = pfs::griotte::size<int>;
+using margins = pfs::griotte::margins<int>;
+using paddings = pfs::griotte::paddings<int>;
+using linear_layout = pfs::griotte::linear_layout<int>;
+using orientation = pfs::griotte::orientation;
+
+class counting_item : public pfs::griotte::layout_item<int>
+{
+public:
+    int measure_count {0};
+    int arrange_count {0};
+
+    counting_item (size const & s) : layout_item(s) {}
+
+protected:
+    size do_measure () override
+    {
+        ++measure_count;
+        return layout_item::do_measure();
+    }
+
+    void do_arrange (rect const &) override
+    {
+        ++arrange_count;
+    }
+};
+
+TEST_CASE("Horizontal layout") {
+    counting_item a{size{10, 20}};
+    counting_item b{size{30, 10}};
+    linear_layout l{orientation::horizontal};
+
+    l.set_paddings(paddings{1, 2, 3, 4});
+    l.set_spacing(5);
+    b.set_margins(margins{1, 1, 1, 1});
+    l.add_item(& a);
+    l.add_item(& b);
+
+    REQUIRE(l.measure() == size{4 + 10 + 5 + 1 + 30 + 1 + 2, 1 + 20 + 3});
+
+    l.arrange(rect{0, 0, 100, 50});
+
+    REQUIRE(a.get_geometry() == rect{4, 1, 10, 46});
+    REQUIRE(b.get_geometry() == rect{20, 2, 30, 44});
+}
+
+TEST_CASE("Vertical layout with stretch") {
+    counting_item a{size{10, 10}};
+    counting_item b{size{10, 10}};
+    counting_item c{size{10, 10}};
+    linear_layout l{orientation::vertical};
+
+    b.set_stretch(1);
+    c.set_stretch(2);
+    l.add_item(& a);
+    l.add_item(& b);
+    l.add_item(& c);
+
+    l.arrange(rect{0, 0, 40, 100});
+
+    REQUIRE(a.get_geometry() == rect{0, 0, 40, 10});
+    REQUIRE(b.get_geometry() == rect{0, 10, 40, 33});
+    REQUIRE(c.get_geometry() == rect{0, 43, 40, 57});
+}
+
+TEST_CASE("Incremental relayout") {
+    counting_item a{size{10, 10}};
+    counting_item b{size{10, 10}};
+    counting_item c{size{10, 10}};
+    counting_item d{size{10, 10}};
+    linear_layout root{orientation::vertical};
+    linear_layout row1{orientation::horizontal};
+    linear_layout row2{orientation::horizontal};
+
+    row1.add_item(& a);
+    row1.add_item(& b);
+    row2.add_item(& c);
+    row2.add_item(& d);
+    root.add_item(& row1);
+    root.add_item(& row2);
+
+    root.arrange(rect{0, 0, 100, 100});
+
+    REQUIRE(a.measure_count == 1);
+    REQUIRE(d.measure_count == 1);
+    REQUIRE(d.arrange_count == 1);
+
+    // Same geometry: nothing to do
+    root.arrange(rect{0, 0, 100, 100});
+
+    REQUIRE(a.arrange_count == 1);
+    REQUIRE(d.arrange_count == 1);
+
+    // Resize of the child re-measures the child only, siblings use cache
+    b.set_size_hint(size{20, 30});
+
+    REQUIRE_FALSE(row1.is_measure_valid());
+    REQUIRE_FALSE(root.is_measure_valid());
+    REQUIRE(row2.is_measure_valid());
+
+    root.arrange(rect{0, 0, 100, 100});
+
+    REQUIRE(a.measure_count == 1);
+    REQUIRE(b.measure_count == 2);
+    REQUIRE(c.measure_count == 1);
+    REQUIRE(d.measure_count == 1);
+
+    REQUIRE(b.get_geometry() == rect{10, 0, 20, 30});
+    REQUIRE(c.get_geometry() == rect{0, 30, 10, 10});
+
+    // Window resize: no re-measure, arrange only items which geometry changed
+    root.arrange(rect{0, 0, 200, 100});
+
+    REQUIRE(b.measure_count == 2);
+    REQUIRE(root.is_measure_valid());
+    REQUIRE(row1.get_geometry() == rect{0, 0, 200, 30});
+}
+
+TEST_CASE("Items destroyed before the layout") {
+    counting_item a{size{10, 10}};
+    linear_layout l{orientation::horizontal};
+
+    l.add_item(& a);
+
+    {
+        counting_item b{size{20, 10}};
+        l.add_item(& b);
+        REQUIRE(l.count() == 2);
+        REQUIRE(l.measure() == size{30, 10});
+    }
+
+    REQUIRE(l.count() == 1);
+    REQUIRE_FALSE(l.is_measure_valid());
+    REQUIRE(l.measure() == size{10, 10});
+
+    {
+        linear_layout nested{orientation::vertical};
+        counting_item c{size{5, 5}};
+        nested.add_item(& c);
+        l.add_item(& nested);
+        REQUIRE(l.measure() == size{15, 10});
+
+        // c is destroyed first, then the nested layout
+    }
+
+    REQUIRE(l.count() == 1);
+    REQUIRE(l.item_at(0) == & a);
+    REQUIRE(l.measure() == size{10, 10});
+
+    l.arrange(rect{0, 0, 100, 50});
+    REQUIRE(a.get_geometry() == rect{0, 0, 10, 50});
+
+    // Nested layout destroyed before its child
+    counting_item d{size{5, 5}};
+
+    {
+        linear_layout nested{orientation::vertical};
+        nested.add_item(& d);
+        l.add_item(& nested);
+        REQUIRE(l.measure() == size{15, 10});
+    }
+
+    REQUIRE(d.get_parent() == nullptr);
+    REQUIRE(l.count() == 1);
+    l.arrange(rect{0, 0, 100, 50});
+    REQUIRE(a.get_geometry() == rect{0, 0, 10, 50});
+}
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.01 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/lod.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace pfs::griotte;
+
+using point_type = point<double>;
+using path_type = path<double>;
+
+namespace {
+
+std::vector<point_type> vertices (path_type const & p)
+{
+    std::vector<point_type> result;
+
+    // Default start point is replaced by the first 'move_to'
+    for (auto it = p.cbegin(); it != p.cend(); ++it)
+        result.push_back(it->p);
+
+    return result;
+}
+
+double distance (point_type const & p, point_type const & a, point_type const & b)
+{
+    double dx = b.x() - a.x();
+    double dy = b.y() - a.y();
+    double len2 = dx * dx + dy * dy;
+    double t = len2 > 0 ? ((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / len2 : 0;
+    t = (std::min)((std::max)(t, 0.0), 1.0);
+    return std::hypot(p.x() - a.x() - t * dx, p.y() - a.y() - t * dy);
+}
+
+// Maximum distance from input points to the polyline, points of a segment
+// are matched in order
+double max_deviation (std::vector<point_type> const & input
+    , std::vector<point_type> const & output)
+{
+    double result = 0;
+    std::size_t seg = 0;
+
+    for (auto const & p: input) {
+        double d = distance(p, output[seg], output[seg + 1]);
+
+        while (seg + 2 < output.size()) {
+            double next = distance(p, output[seg + 1], output[seg + 2]);
+
+            if (next > d && !(output[seg + 1].x() == p.x() && output[seg + 1].y() == p.y()))
+                break;
+
+            d = next;
+            ++seg;
+        }
+
+        result = (std::max)(result, d);
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Simplify straight line") {
+    path_simplifier<double> s {0.5};
+    s.move_to(point_type{0, 0});
+
+    for (int i = 1; i <= 1000; i++)
+        s.line_to(point_type{i * 1.0, i * 0.5});
+
+    path_type p;
+    s.build(p);
+
+    auto v = vertices(p);
+    REQUIRE(v.size() == 2);
+    REQUIRE(v[1].x() == 1000);
+    REQUIRE(s.input_count() == 1001);
+}
+
+TEST_CASE("Simplify within tolerance") {
+    double const tolerance = 0.25;
+    path_simplifier<double> s {tolerance, 256};
+    std::vector<point_type> input;
+
+    for (int i = 0; i < 20000; i++) {
+        point_type pt {i * 0.01, 10 * std::sin(i * 0.001) + 0.1 * std::sin(i * 0.7)};
+        input.push_back(pt);
+
+        if (i == 0)
+            s.move_to(pt);
+        else
+            s.line_to(pt);
+
+        // Rebuild commits stable vertices, so the tail stays short
+        if (i % 1000 == 999) {
+            path_type p;
+            s.build(p);
+            REQUIRE(p.size() <= s.committed_count() + 1);
+        }
+    }
+
+    path_type p;
+    s.build(p);
+    auto v = vertices(p);
+
+    REQUIRE(v.front().x() == input.front().x());
+    REQUIRE(v.back().x() == input.back().x());
+    REQUIRE(v.size() < input.size() / 10);
+    REQUIRE(max_deviation(input, v) <= tolerance + 1e-9);
+}
+
+TEST_CASE("Simplify subpaths") {
+    path_simplifier<double> s {0.1};
+    s.move_to(point_type{0, 0});
+    s.line_to(point_type{5, 0});
+    s.line_to(point_type{10, 0});
+    s.move_to(point_type{0, 10});
+    s.line_to(point_type{5, 15});
+    s.line_to(point_type{10, 10});
+
+    path_type p;
+    s.build(p);
+
+    auto v = vertices(p);
+    REQUIRE(p.size() == 5);
+    REQUIRE((p.cbegin() + 2)->type == path_entry_enum::move_to);
+    REQUIRE(v[3].y() == 15);
+}
+
+TEST_CASE("Column decimation") {
+    // 1000 samples per column
+    column_decimator<double> d {0, 1.0};
+    std::vector<double> column_min(100, 1e9);
+    std::vector<double> column_max(100, -1e9);
+
+    for (int i = 0; i < 100000; i++) {
+        double x = i * 0.001;
+        double y = std::sin(i * 0.37) * (1 + i % 7);
+        auto c = static_cast<std::size_t>(x);
+        column_min[c] = (std::min)(column_min[c], y);
+        column_max[c] = (std::max)(column_max[c], y);
+        d.append(point_type{x, y});
+    }
+
+    auto points = d.get_points();
+    REQUIRE(points.size() <= 400);
+    REQUIRE(d.input_count() == 100000);
+
+    // Extremes of every column are kept
+    for (std::size_t c = 0; c < 100; c++) {
+        double ymin = 1e9;
+        double ymax = -1e9;
+
+        for (auto const & pt: points) {
+            if (static_cast<std::size_t>(pt.x()) == c) {
+                ymin = (std::min)(ymin, pt.y());
+                ymax = (std::max)(ymax, pt.y());
+            }
+        }
+
+        REQUIRE(ymin == column_min[c]);
+        REQUIRE(ymax == column_max[c]);
+    }
+
+    path_type p;
+    d.build(p);
+    REQUIRE(p.size() == points.size());
+    REQUIRE(p.cbegin()->type == path_entry_enum::move_to);
+    REQUIRE((p.cend() - 1)->p.x() == points.back().x());
+}
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.05 Initial version
+//      2021.07.13 Appending after a hard line break.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/paragraph.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace pfs::griotte;
+
+namespace {
+
+// Every character is 10 pixels wide
+struct fake_metrics
+{
+    int advance_calls {0};
+    int char_width {10};
+
+    fixed26_6 advance (char32_t)
+    {
+        ++advance_calls;
+        return fixed26_6{char_width};
+    }
+
+    fixed26_6 ascender () const { return fixed26_6{8}; }
+    fixed26_6 descender () const { return fixed26_6{-2}; }
+    fixed26_6 height () const { return fixed26_6{12}; }
+};
+
+template <typename P>
+std::vector<std::string> lines_of (P const & p)
+{
+    std::vector<std::string> result;
+
+    for (std::size_t i = 0; i < p.line_count(); i++) {
+        auto l = p.get_line(i);
+        result.push_back(p.get_text().substr(l.first, l.last - l.first));
+    }
+
+    return result;
+}
+
+std::vector<line_break> breaks_of (std::u32string const & s)
+{
+    std::vector<line_break_class> classes;
+
+    for (auto cp: s)
+        classes.push_back(line_break_class_of(cp));
+
+    std::vector<line_break> result;
+
+    for (std::size_t i = 1; i < classes.size(); i++)
+        result.push_back(line_break_action(classes.data(), i));
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Line break opportunities") {
+    auto p = line_break::prohibited;
+    auto a = line_break::allowed;
+    auto m = line_break::mandatory;
+
+    REQUIRE(breaks_of(U"ab cd") == std::vector<line_break>{p, p, a, p});
+    REQUIRE(breaks_of(U"a-b") == std::vector<line_break>{p, a});
+    REQUIRE(breaks_of(U"a\r\nb") == std::vector<line_break>{p, p, m});
+    REQUIRE(breaks_of(U"a b") == std::vector<line_break>{p, p});
+    REQUIRE(breaks_of(U"a (b)") == std::vector<line_break>{p, a, p, p});
+    REQUIRE(breaks_of(U"1.5") == std::vector<line_break>{p, p});
+    REQUIRE(breaks_of(U"一丁。") == std::vector<line_break>{a, p});
+    REQUIRE(breaks_of(U"éx") == std::vector<line_break>{p, p});
+    REQUIRE(breaks_of(U"a​b") == std::vector<line_break>{p, a});
+}
+
+TEST_CASE("Paragraph wrapping") {
+    fake_metrics m;
+    paragraph<fake_metrics> p {m};
+
+    REQUIRE(p.line_count() == 1);
+
+    p.set_text("The quick brown fox");
+    REQUIRE(p.line_count() == 1);
+    REQUIRE(p.get_line(0).width == 190);
+
+    p.set_width(fixed26_6{100});
+    REQUIRE(lines_of(p) == std::vector<std::string>{"The quick", "brown fox"});
+    REQUIRE(p.get_line(0).width == 90);
+    REQUIRE(p.get_line(1).first == 10);
+    REQUIRE(p.get_line(0).baseline == 8);
+    REQUIRE(p.get_line(1).baseline == 20);
+    REQUIRE(p.get_height() == 24);
+
+    // Hard breaks and trailing empty line
+    p.set_text("ab\ncd\n");
+    REQUIRE(lines_of(p) == std::vector<std::string>{"ab", "cd", ""});
+
+    // Word longer than the width is broken between characters
+    p.set_width(fixed26_6{30});
+    p.set_text("abcdefg hi");
+    REQUIRE(lines_of(p) == std::vector<std::string>{"abc", "def", "g", "hi"});
+}
+
+TEST_CASE("Paragraph alignment") {
+    fake_metrics m;
+    paragraph<fake_metrics> p {m};
+
+    p.set_width(fixed26_6{100});
+    p.set_text("ab cd");
+
+    REQUIRE(p.get_line(0).x == 0);
+    p.set_align(text_align::right);
+    REQUIRE(p.get_line(0).x == 50);
+    p.set_align(text_align::center);
+    REQUIRE(p.get_line(0).x == 25);
+}
+
+TEST_CASE("Paragraph incremental layout") {
+    fake_metrics m;
+    paragraph<fake_metrics> p {m};
+    std::string text;
+
+    for (int i = 0; i < 100; i++)
+        text += "aaaa bbbb cccc\n";
+
+    p.set_width(fixed26_6{100});
+    p.set_text(text);
+    REQUIRE(p.line_count() == 201);
+
+    int calls = m.advance_calls;
+
+    // Lines are the same for both widths
+    p.set_width(fixed26_6{110});
+    REQUIRE(p.get_first_changed_line() == p.line_count());
+    REQUIRE(p.line_count() == 201);
+
+    p.set_width(fixed26_6{60});
+    REQUIRE(p.get_first_changed_line() == 0);
+    REQUIRE(p.line_count() == 301);
+
+    p.set_width(fixed26_6{100});
+    REQUIRE(lines_of(p)[0] == "aaaa bbbb");
+    REQUIRE(lines_of(p)[1] == "cccc");
+    REQUIRE(m.advance_calls == calls);
+
+    // Appending wraps the last line only
+    p.append_text("dddd");
+    REQUIRE(p.get_first_changed_line() == 200);
+    p.append_text(" eeee ffff");
+    REQUIRE(p.get_first_changed_line() == 200);
+    REQUIRE(p.line_count() == 202);
+    REQUIRE(lines_of(p)[200] == "dddd eeee");
+    REQUIRE(lines_of(p)[201] == "ffff");
+
+    // Appending to a word moves it to the next line
+    p.set_text("aaaa bbbb");
+    p.append_text("bb");
+    REQUIRE(lines_of(p) == std::vector<std::string>{"aaaa", "bbbbbb"});
+
+    // Font change measures the text again
+    m.char_width = 20;
+    p.set_font(m);
+    REQUIRE(lines_of(p) == std::vector<std::string>{"aaaa", "bbbbb", "b"});
+}
+
+TEST_CASE("Paragraph incremental layout equals full layout") {
+    fake_metrics m;
+    paragraph<fake_metrics> p {m};
+    std::string text;
+    unsigned seed = 1;
+
+    for (int i = 0; i < 300; i++) {
+        seed = seed * 1103515245 + 12345;
+        int len = 1 + (seed >> 16) % 12;
+        text += std::string(static_cast<std::size_t>(len), 'a' + i % 26);
+        text += (seed >> 8) % 17 == 0 ? "\n" : " ";
+    }
+
+    p.set_text(text);
+
+    // Shrinking, then growing
+    for (int step = 0; step < 40; step++) {
+        int width = step < 20 ? 150 - step * 7 : 10 + (step - 20) * 7;
+        p.set_width(fixed26_6{width});
+
+        paragraph<fake_metrics> full {m};
+        full.set_width(fixed26_6{width});
+        full.set_text(text);
+
+        REQUIRE(lines_of(p) == lines_of(full));
+    }
+
+    // Appending after a hard line break
+    std::vector<std::pair<std::string, std::string>> splits {
+          {"ab\r", "\ncd"}
+        , {"ab\r", "cd"}
+        , {"ab\n", "cd"}
+        , {"ab\n", "\ncd"}
+        , {"ab\r\n", "cd\r"}
+    };
+
+    for (auto const & split: splits) {
+        p.set_width(fixed26_6{});
+        p.set_text(split.first);
+        p.append_text(split.second);
+
+        paragraph<fake_metrics> full {m};
+        full.set_text(split.first + split.second);
+
+        REQUIRE(lines_of(p) == lines_of(full));
+    }
+
+    p.set_text("ab\r");
+    p.append_text("\ncd");
+    REQUIRE(p.line_count() == 2);
+    REQUIRE(p.get_first_changed_line() == 0);
+}
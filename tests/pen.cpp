@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.29 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/pen.hpp"
+#include <type_traits>
+#include <vector>
+
+using namespace pfs::griotte;
+using pen_type = pen<float>;
+
+static_assert(std::is_trivially_copyable<pen_type>::value, "pen must be trivially copyable");
+
+TEST_CASE("Solid pen") {
+    pen_type p {color{255, 0, 0}, 2.0f, cap_style::round, join_style::bevel};
+
+    REQUIRE(p.get_dasharray().empty());
+    REQUIRE(p.get_dash_period() == 0);
+    REQUIRE(p.get_width() == 2.0f);
+    REQUIRE(p.get_cap() == cap_style::round);
+    REQUIRE(p.get_join() == join_style::bevel);
+    REQUIRE(p == pen_type{color{255, 0, 0}, 2.0f, cap_style::round, join_style::bevel});
+    REQUIRE(p != pen_type{color{255, 0, 0}, 1.0f, cap_style::round, join_style::bevel});
+}
+
+TEST_CASE("Inline dash array") {
+    pen_type p {color{}, 1.0f};
+    p.set_dasharray({4, 2, 1, 2});
+
+    REQUIRE(p.get_dasharray().size() == 4);
+    REQUIRE(p.get_dasharray()[2] == 1.0f);
+    REQUIRE(p.get_dash_period() == 9.0f);
+
+    pen_type q = p;
+    REQUIRE(q == p);
+    REQUIRE(q.get_dash_hash() == p.get_dash_hash());
+
+    q.set_dasharray({4, 2, 1, 3});
+    REQUIRE(q != p);
+
+    // Odd number of values is repeated
+    q.set_dasharray({3, 1, 2});
+    REQUIRE(q.get_dash_period() == 12.0f);
+
+    q.add_dash(6);
+    REQUIRE(q.get_dasharray().size() == 4);
+    REQUIRE(q.get_dash_period() == 12.0f);
+
+    q.clear_dasharray();
+    REQUIRE(q.get_dasharray().empty());
+    REQUIRE(q == pen_type{color{}, 1.0f});
+}
+
+TEST_CASE("Interned dash array") {
+    std::vector<float> dashes {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    pen_type p {color{}, 1.0f};
+    pen_type q {color{}, 1.0f};
+    p.set_dasharray(dashes.data(), dashes.size());
+    q.set_dasharray(dashes.data(), dashes.size());
+
+    REQUIRE(p.get_dasharray().size() == 10);
+    REQUIRE(p.get_dasharray()[9] == 10.0f);
+    REQUIRE(p.get_dash_period() == 55.0f);
+
+    // Equal patterns share storage
+    REQUIRE(p.get_dasharray().data() == q.get_dasharray().data());
+    REQUIRE(p == q);
+
+    auto pool_size = dash_pattern_pool<float>::size();
+
+    pen_type r {color{}, 1.0f};
+    r.set_dasharray({1, 2, 3, 4, 5, 6, 7, 8});
+    r.add_dash(9);
+    r.add_dash(10);
+
+    REQUIRE(r == p);
+    REQUIRE(r.get_dasharray().data() == p.get_dasharray().data());
+    // Only the 9-entry intermediate pattern is added
+    REQUIRE(dash_pattern_pool<float>::size() == pool_size + 1);
+
+    r.add_dash(11);
+    REQUIRE(r != p);
+    REQUIRE(r.get_dasharray().size() == 11);
+}
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.04 Initial version
+//      2021.07.13 Font instances.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/shaped_run.hpp"
+#include <string>
+
+using namespace pfs::griotte;
+
+namespace {
+
+struct fake_font
+{
+    int id;
+
+    void const * native_handle () const noexcept
+    {
+        return this;
+    }
+};
+
+// Instance of a variable font sharing its handle
+struct fake_font_instance
+{
+    fake_font const * font;
+    std::uint32_t id;
+
+    void const * native_handle () const noexcept
+    {
+        return font;
+    }
+
+    std::uint32_t get_id () const noexcept
+    {
+        return id;
+    }
+};
+
+// One glyph per byte, advance equals to the pixel size
+struct fake_shaper
+{
+    int calls {0};
+
+    template <typename Font>
+    void shape (Font const &, int pixel_size, char const * text
+        , std::size_t len, script_tag script, text_direction direction
+        , shaped_run & out)
+    {
+        ++calls;
+        out.clear();
+
+        for (std::size_t i = 0; i < len; i++) {
+            shaped_glyph g {static_cast<std::uint8_t>(text[i])
+                , static_cast<std::uint32_t>(i)
+                , fixed26_6{pixel_size}, fixed26_6{}, fixed26_6{}, fixed26_6{}};
+            out.glyphs.push_back(g);
+            out.x_advance += g.x_advance;
+        }
+
+        out.script = script;
+        out.direction = direction == text_direction::rtl
+            ? text_direction::rtl : text_direction::ltr;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Shaped run cache hits") {
+    fake_shaper shaper;
+    shaped_run_cache<fake_shaper> cache {shaper, 4};
+    fake_font font {1};
+
+    auto r1 = cache.shape(font, 16, std::string{"Hello"});
+    auto r2 = cache.shape(font, 16, std::string{"Hello"});
+
+    REQUIRE(r1->glyphs.size() == 5);
+    REQUIRE(r1->x_advance == 5 * 16);
+    REQUIRE(r1.get() == r2.get());
+    REQUIRE(shaper.calls == 1);
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+
+    // Empty text
+    auto e = cache.shape(font, 16, "", 0);
+    REQUIRE(e->glyphs.empty());
+    REQUIRE(cache.shape(font, 16, "", 0).get() == e.get());
+}
+
+TEST_CASE("Shaped run cache keys") {
+    fake_shaper shaper;
+    shaped_run_cache<fake_shaper> cache {shaper};
+    fake_font font1 {1};
+    fake_font font2 {2};
+
+    auto r = cache.shape(font1, 16, std::string{"abc"});
+
+    REQUIRE(cache.shape(font1, 17, std::string{"abc"}).get() != r.get());
+    REQUIRE(cache.shape(font2, 16, std::string{"abc"}).get() != r.get());
+    REQUIRE(cache.shape(font1, 16, std::string{"abd"}).get() != r.get());
+    REQUIRE(cache.shape(font1, 16, std::string{"abc"}, 0, text_direction::rtl).get() != r.get());
+    REQUIRE(cache.shape(font1, 16, std::string{"abc"}, make_script_tag('L', 'a', 't', 'n')).get() != r.get());
+    REQUIRE(cache.shape(font1, 16, std::string{"abc"}).get() == r.get());
+
+    REQUIRE(shaper.calls == 6);
+    REQUIRE(cache.size() == 6);
+}
+
+TEST_CASE("Shaped run cache eviction") {
+    fake_shaper shaper;
+    shaped_run_cache<fake_shaper> cache {shaper, 2};
+    fake_font font {1};
+
+    auto a = cache.shape(font, 16, std::string{"a"});
+    cache.shape(font, 16, std::string{"b"});
+
+    // "a" becomes the most recently used, "b" is evicted
+    REQUIRE(cache.shape(font, 16, std::string{"a"}).get() == a.get());
+    cache.shape(font, 16, std::string{"c"});
+    REQUIRE(cache.size() == 2);
+
+    int calls = shaper.calls;
+    cache.shape(font, 16, std::string{"a"});
+    REQUIRE(shaper.calls == calls);
+    cache.shape(font, 16, std::string{"b"});
+    REQUIRE(shaper.calls == calls + 1);
+
+    // Evicted run stays valid while referenced
+    REQUIRE(a->glyphs.size() == 1);
+}
+
+TEST_CASE("Shaped run cache invalidation") {
+    fake_shaper shaper;
+    shaped_run_cache<fake_shaper> cache {shaper};
+    fake_font font1 {1};
+    fake_font font2 {2};
+
+    cache.shape(font1, 16, std::string{"a"});
+    cache.shape(font1, 20, std::string{"b"});
+    cache.shape(font2, 16, std::string{"a"});
+
+    cache.invalidate(font1);
+    REQUIRE(cache.size() == 1);
+
+    cache.shape(font2, 16, std::string{"a"});
+    REQUIRE(shaper.calls == 3);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("Shaped run cache keys font instances") {
+    fake_shaper shaper;
+    shaped_run_cache<fake_shaper> cache {shaper};
+    fake_font font {1};
+    fake_font_instance regular {& font, 0};
+    fake_font_instance bold {& font, 1};
+
+    auto r = cache.shape(regular, 16, std::string{"abc"});
+    auto b = cache.shape(bold, 16, std::string{"abc"});
+
+    REQUIRE(b.get() != r.get());
+    REQUIRE(cache.shape(regular, 16, std::string{"abc"}).get() == r.get());
+    REQUIRE(cache.shape(bold, 16, std::string{"abc"}).get() == b.get());
+
+    // The default instance and the font itself are the same
+    REQUIRE(cache.shape(font, 16, std::string{"abc"}).get() == r.get());
+    REQUIRE(shaper.calls == 2);
+
+    // Invalidation of the font removes runs of all its instances
+    cache.invalidate(font);
+    REQUIRE(cache.size() == 0);
+}
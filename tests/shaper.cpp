@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.13 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/shaper.hpp"
+#include "test_fonts.hpp"
+#include <string>
+
+using namespace pfs::griotte;
+
+TEST_CASE("Shape text") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    {
+        font f {face};
+        shaper s;
+        shaped_run run;
+        std::string text {"Hello"};
+
+        s.shape(f, 16, text.data(), text.size(), 0, text_direction::automatic, run);
+
+        REQUIRE(run.glyphs.size() == 5);
+        REQUIRE(run.direction == text_direction::ltr);
+        REQUIRE(run.script == make_script_tag('L', 'a', 't', 'n'));
+
+        fixed26_6 advance;
+
+        for (std::size_t i = 0; i < run.glyphs.size(); i++) {
+            REQUIRE(run.glyphs[i].glyph_index == FT_Get_Char_Index(face, text[i]));
+            REQUIRE(run.glyphs[i].cluster == i);
+            REQUIRE(run.glyphs[i].x_advance > 0);
+            REQUIRE(run.glyphs[i].y_advance == 0);
+            advance += run.glyphs[i].x_advance;
+        }
+
+        REQUIRE(run.x_advance == advance);
+
+        // Both 'l' are the same glyph
+        REQUIRE(run.glyphs[2].glyph_index == run.glyphs[3].glyph_index);
+        REQUIRE(run.glyphs[2].x_advance == run.glyphs[3].x_advance);
+
+        // Advances scale with the pixel size
+        shaped_run large;
+        s.shape(f, 32, text.data(), text.size(), 0, text_direction::automatic, large);
+        REQUIRE(large.glyphs.size() == 5);
+        REQUIRE(large.x_advance > run.x_advance);
+
+        // Glyphs of a right-to-left run are in visual order, so clusters
+        // descend
+        shaped_run rtl;
+        s.shape(f, 16, text.data(), text.size(), 0, text_direction::rtl, rtl);
+
+        REQUIRE(rtl.direction == text_direction::rtl);
+        REQUIRE(rtl.glyphs.size() == 5);
+
+        for (std::size_t i = 0; i < rtl.glyphs.size(); i++) {
+            REQUIRE(rtl.glyphs[i].cluster == rtl.glyphs.size() - 1 - i);
+            REQUIRE(rtl.glyphs[i].glyph_index == run.glyphs[4 - i].glyph_index);
+        }
+
+        REQUIRE(rtl.x_advance == run.x_advance);
+
+        s.release(f);
+    }
+
+    FT_Done_FreeType(library);
+}
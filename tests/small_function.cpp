@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.23 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/small_function.hpp"
+#include <memory>
+
+using pfs::griotte::small_function;
+
+TEST_CASE("Empty function") {
+    small_function<int (int)> f;
+    REQUIRE_FALSE(f);
+
+    small_function<int (int)> g {nullptr};
+    REQUIRE_FALSE(g);
+}
+
+TEST_CASE("Call with captures") {
+    int base = 10;
+    small_function<int (int)> f = [base] (int x) { return base + x; };
+
+    REQUIRE(f);
+    REQUIRE(f(5) == 15);
+
+    f = nullptr;
+    REQUIRE_FALSE(f);
+
+    f = [] (int x) { return x * 2; };
+    REQUIRE(f(5) == 10);
+}
+
+TEST_CASE("Copy and move") {
+    auto counter = std::make_shared<int>(0);
+    small_function<void ()> f = [counter] { ++*counter; };
+
+    REQUIRE(counter.use_count() == 2);
+
+    small_function<void ()> g = f;
+    REQUIRE(counter.use_count() == 3);
+
+    g();
+    f();
+    REQUIRE(*counter == 2);
+
+    small_function<void ()> h = std::move(f);
+    REQUIRE_FALSE(f);
+    REQUIRE(counter.use_count() == 3);
+
+    h();
+    REQUIRE(*counter == 3);
+
+    g.reset();
+    h = nullptr;
+    REQUIRE(counter.use_count() == 1);
+}
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.14 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "pfs/griotte/spatial_index.hpp"
+
+using point = pfs::griotte::point<int>;
+using rect = pfs::griotte::rect<int>;
+using spatial_index = pfs::griotte::spatial_index<int, int>;
+
+TEST_CASE("Empty spatial index") {
+    spatial_index index;
+    int hits = 0;
+
+    index.query(point{0, 0}, [& hits] (spatial_index::id_type, int) {
+        ++hits;
+        return true;
+    });
+
+    REQUIRE(index.empty());
+    REQUIRE(hits == 0);
+}
+
+TEST_CASE("Point and rect queries") {
+    spatial_index index{2};
+
+    auto a = index.insert(rect{0, 0, 10, 10}, 1);
+    auto b = index.insert(rect{20, 0, 10, 10}, 2);
+    auto c = index.insert(rect{5, 5, 20, 20}, 3);
+
+    REQUIRE(index.size() == 3);
+    REQUIRE(index.value(a) == 1);
+    REQUIRE(index.value(b) == 2);
+    REQUIRE(index.value(c) == 3);
+
+    std::vector<int> hits;
+    auto collect = [& hits] (spatial_index::id_type, int value) {
+        hits.push_back(value);
+        return true;
+    };
+
+    index.query(point{7, 7}, collect);
+    std::sort(hits.begin(), hits.end());
+    REQUIRE(hits == std::vector<int>{1, 3});
+
+    // Margin must not produce false hits
+    hits.clear();
+    index.query(point{11, 1}, collect);
+    REQUIRE(hits.empty());
+
+    hits.clear();
+    index.query(rect{9, 0, 12, 3}, collect);
+    std::sort(hits.begin(), hits.end());
+    REQUIRE(hits == std::vector<int>{1, 2});
+
+    // Stop the query early
+    int count = 0;
+    index.query(rect{0, 0, 100, 100}, [& count] (spatial_index::id_type, int) {
+        ++count;
+        return false;
+    });
+    REQUIRE(count == 1);
+}
+
+TEST_CASE("Incremental updates") {
+    spatial_index index{4};
+
+    auto id = index.insert(rect{0, 0, 10, 10}, 42);
+
+    // Small move fits into the enlarged bounds
+    REQUIRE_FALSE(index.update(id, rect{2, 2, 10, 10}));
+    REQUIRE(index.bounds(id) == rect{2, 2, 10, 10});
+
+    // Large move restructures the tree
+    REQUIRE(index.update(id, rect{100, 100, 10, 10}));
+
+    int hits = 0;
+    auto count = [& hits] (spatial_index::id_type, int) { ++hits; return true; };
+
+    index.query(point{5, 5}, count);
+    REQUIRE(hits == 0);
+
+    index.query(point{105, 105}, count);
+    REQUIRE(hits == 1);
+
+    index.remove(id);
+    REQUIRE(index.empty());
+
+    hits = 0;
+    index.query(point{105, 105}, count);
+    REQUIRE(hits == 0);
+}
+
+TEST_CASE("Spatial index matches brute force search") {
+    std::mt19937 gen{12345};
+    std::uniform_int_distribution<int> coord{0, 1000};
+    std::uniform_int_distribution<int> extent{1, 30};
+
+    spatial_index index{3};
+    std::vector<rect> rects;
+    std::vector<spatial_index::id_type> ids;
+
+    for (int i = 0; i < 2000; i++) {
+        rects.emplace_back(coord(gen), coord(gen), extent(gen), extent(gen));
+        ids.push_back(index.insert(rects.back(), i));
+    }
+
+    // Move a half of items, remove a quarter
+    for (int i = 0; i < 1000; i++) {
+        rects[i] = rect{coord(gen), coord(gen), extent(gen), extent(gen)};
+        index.update(ids[i], rects[i]);
+    }
+
+    std::vector<bool> removed(rects.size(), false);
+
+    for (int i = 1000; i < 1500; i++) {
+        index.remove(ids[i]);
+        removed[i] = true;
+    }
+
+    REQUIRE(index.size() == 1500);
+
+    // Tree must stay balanced
+    REQUIRE(index.height() < 32);
+
+    for (int k = 0; k < 200; k++) {
+        point p{coord(gen), coord(gen)};
+        std::vector<int> expected;
+        std::vector<int> actual;
+
+        for (int i = 0; i < static_cast<int>(rects.size()); i++) {
+            if (!removed[i] && rects[i].contains(p))
+                expected.push_back(i);
+        }
+
+        index.query(p, [& actual] (spatial_index::id_type, int value) {
+            actual.push_back(value);
+            return true;
+        });
+
+        std::sort(actual.begin(), actual.end());
+        REQUIRE(actual == expected);
+    }
+
+    for (int k = 0; k < 200; k++) {
+        rect r{coord(gen), coord(gen), extent(gen) * 3, extent(gen) * 3};
+        std::vector<int> expected;
+        std::vector<int> actual;
+
+        for (int i = 0; i < static_cast<int>(rects.size()); i++) {
+            if (!removed[i] && rects[i].intersects(r))
+                expected.push_back(i);
+        }
+
+        index.query(r, [& actual] (spatial_index::id_type, int value) {
+            actual.push_back(value);
+            return true;
+        });
+
+        std::sort(actual.begin(), actual.end());
+        REQUIRE(actual == expected);
+    }
+}
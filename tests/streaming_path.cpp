@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.02 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/streaming_path.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace pfs::griotte;
+
+using point_type = point<float>;
+using pen_type = pen<float>;
+
+namespace {
+
+struct polyline_painter
+{
+    int calls = 0;
+    std::vector<point_type> points;
+
+    void draw_polyline (point_type const * p, std::size_t count, pen_type const &)
+    {
+        ++calls;
+        points.assign(p, p + count);
+    }
+};
+
+// Sum of triangle areas
+double area (mesh const & m)
+{
+    double result = 0;
+
+    for (std::size_t i = 0; i + 2 < m.indices.size(); i += 3) {
+        mesh_vertex const & a = m.vertices[m.indices[i]];
+        mesh_vertex const & b = m.vertices[m.indices[i + 1]];
+        mesh_vertex const & c = m.vertices[m.indices[i + 2]];
+        result += std::fabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) / 2;
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Ring of samples") {
+    streaming_path<float> p {4};
+
+    REQUIRE(p.empty());
+
+    for (int i = 0; i < 3; i++)
+        p.append(point_type{static_cast<float>(i), 0});
+
+    REQUIRE(p.size() == 3);
+    REQUIRE(p.front().x() == 0);
+    REQUIRE(p.back().x() == 2);
+
+    for (int i = 3; i < 10; i++)
+        p.append(point_type{static_cast<float>(i), 0});
+
+    // Last four samples, contiguous
+    REQUIRE(p.size() == 4);
+
+    for (std::size_t i = 0; i < p.size(); i++) {
+        REQUIRE(p[i].x() == 6 + i);
+        REQUIRE(p.data()[i].x() == 6 + i);
+    }
+
+    polyline_painter painter;
+    p.stroke(painter, pen_type{color{}, 1.0f});
+
+    REQUIRE(painter.calls == 1);
+    REQUIRE(painter.points.size() == 4);
+    REQUIRE(painter.points.back().x() == 9);
+}
+
+TEST_CASE("Incremental stroke mesh") {
+    streaming_stroke<float> s {100, pen_type{color{255, 0, 0}, 2.0f}};
+
+    auto const & m = s.get_mesh();
+    auto indices = m.indices;
+
+    REQUIRE(m.commands.size() == 1);
+    REQUIRE(m.commands[0].index_count == m.indices.size());
+
+    for (int i = 0; i < 50; i++)
+        s.append(point_type{static_cast<float>(i), 0});
+
+    // Straight line: 49 segments of width 2
+    REQUIRE(area(m) == doctest::Approx(49 * 2));
+
+    // Scrolling: only the last 100 samples are stroked
+    for (int i = 50; i < 1000; i++)
+        s.append(point_type{static_cast<float>(i), 0});
+
+    REQUIRE(s.size() == 100);
+    REQUIRE(area(m) == doctest::Approx(99 * 2));
+
+    // Index buffer never changes
+    REQUIRE(m.indices == indices);
+}
+
+TEST_CASE("Joins of retired segments") {
+    streaming_stroke<float> s {3, pen_type{color{}, 2.0f, cap_style::butt, join_style::bevel}};
+
+    // Zigzag
+    for (int i = 0; i < 20; i++)
+        s.append(point_type{static_cast<float>(i * 10), i % 2 ? 10.0f : 0.0f});
+
+    // Two segments and one join only
+    std::size_t joins = 0;
+    std::size_t segments = 0;
+    auto const & v = s.get_mesh().vertices;
+
+    for (std::size_t slot = 0; slot < s.capacity(); slot++) {
+        auto nonzero = [& v] (std::size_t i) { return v[i].x != 0 || v[i].y != 0; };
+        segments += nonzero(slot * 8) ? 1 : 0;
+        joins += nonzero(slot * 8 + 4) ? 1 : 0;
+    }
+
+    REQUIRE(segments == 2);
+    REQUIRE(joins == 1);
+}
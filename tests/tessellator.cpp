@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.26 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/parallel_tessellator.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace pfs::griotte;
+
+using path_type = path<float>;
+using pen_type = pen<float>;
+
+namespace {
+
+// Sum of triangle areas
+double area (mesh const & m)
+{
+    double result = 0;
+
+    for (std::size_t i = 0; i + 2 < m.indices.size(); i += 3) {
+        mesh_vertex const & a = m.vertices[m.indices[i]];
+        mesh_vertex const & b = m.vertices[m.indices[i + 1]];
+        mesh_vertex const & c = m.vertices[m.indices[i + 2]];
+        result += std::fabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) / 2;
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Flatten") {
+    tessellator<float> t {0.1f};
+    std::error_code ec;
+
+    path_type p;
+    p.move_to(0, 0);
+    p.line_to(10, 0);
+    p.line_to(10, 10);
+    p.close_path();
+    p.move_to(20, 0);
+    p.curve_to(20, 10, 30, 10, 30, 0);
+
+    t.flatten(p, ec);
+    REQUIRE_FALSE(static_cast<bool>(ec));
+
+    auto const & contours = t.get_contours();
+    REQUIRE(contours.size() == 2);
+    REQUIRE(contours[0].count == 3);
+    REQUIRE(contours[0].closed);
+    REQUIRE_FALSE(contours[1].closed);
+    REQUIRE(contours[1].count > 4);
+
+    // Flattened curve points lie on the curve: y(0.5) = 7.5
+    auto const & points = t.get_points();
+    auto const & c = contours[1];
+    REQUIRE(points[c.first + c.count - 1].x == 30);
+
+    float ymax = 0;
+
+    for (std::size_t i = c.first; i < c.first + c.count; i++)
+        ymax = (std::max)(ymax, points[i].y);
+
+    REQUIRE(ymax == doctest::Approx(7.5f).epsilon(0.02));
+}
+
+TEST_CASE("Stroke line caps") {
+    tessellator<float> t;
+    mesh m;
+
+    path_type p;
+    p.move_to(0, 0);
+    p.line_to(100, 0);
+
+    t.stroke(p, pen_type{color{255, 0, 0}, 10}, m);
+    REQUIRE(area(m) == doctest::Approx(1000));
+    REQUIRE(m.commands.size() == 1);
+    REQUIRE(m.commands[0].index_count == m.indices.size());
+
+    m.clear();
+    t.stroke(p, pen_type{color{255, 0, 0}, 10, cap_style::square}, m);
+    REQUIRE(area(m) == doctest::Approx(1100));
+
+    m.clear();
+    t.stroke(p, pen_type{color{255, 0, 0}, 10, cap_style::round}, m);
+    REQUIRE(area(m) == doctest::Approx(1000 + 3.14159 * 25).epsilon(0.01));
+}
+
+TEST_CASE("Stroke joins") {
+    tessellator<float> t;
+    mesh m;
+
+    // Right angle
+    path_type p;
+    p.move_to(0, 0);
+    p.line_to(100, 0);
+    p.line_to(100, 100);
+
+    t.stroke(p, pen_type{color{}, 10, cap_style::butt, join_style::bevel}, m);
+    REQUIRE(area(m) == doctest::Approx(2000 + 12.5));
+
+    m.clear();
+    t.stroke(p, pen_type{color{}, 10, cap_style::butt, join_style::miter}, m);
+    REQUIRE(area(m) == doctest::Approx(2000 + 25));
+
+    m.clear();
+    t.stroke(p, pen_type{color{}, 10, cap_style::butt, join_style::round}, m);
+    REQUIRE(area(m) == doctest::Approx(2000 + 3.14159 * 25 / 4).epsilon(0.01));
+}
+
+TEST_CASE("Fill") {
+    tessellator<float> t;
+    mesh m;
+
+    path_type p;
+    p.move_to(0, 0);
+    p.line_to(10, 0);
+    p.line_to(10, 10);
+    p.line_to(0, 10);
+    p.close_path();
+
+    t.fill(p, color{0, 255, 0}, m);
+    REQUIRE(m.commands.size() == 1);
+    REQUIRE(m.commands[0].type == mesh_command_type::stencil_fan);
+    REQUIRE(area(m) == doctest::Approx(100));
+}
+
+TEST_CASE("Bad path") {
+    tessellator<float> t;
+    mesh m;
+    std::error_code ec;
+
+    path_type p;
+    p.curve_to(point<float>{1, 1}, point<float>{2, 2}, point<float>{3, 3});
+    p.begin()->type = path_entry_enum::curve_to;
+
+    t.stroke(p, pen_type{color{}, 1}, m, ec);
+    REQUIRE(ec.value() == static_cast<int>(errc::bad_path));
+}
+
+TEST_CASE("Parallel tessellation equals sequential") {
+    std::vector<path_type> paths(1000);
+    std::vector<pen_type> pens;
+
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        float y = static_cast<float>(i);
+        paths[i].move_to(0, y);
+
+        for (int x = 1; x < 20; x++)
+            paths[i].line_to(x * 10.0f, y + (x % 2) * 5.0f);
+
+        pens.emplace_back(color{static_cast<int>(i % 3), 0, 0}, 2.0f
+            , cap_style::round, join_style::round);
+    }
+
+    mesh expected;
+    tessellator<float> t;
+
+    for (std::size_t i = 0; i < paths.size(); i++)
+        t.stroke(paths[i], pens[i], expected);
+
+    job_system jobs {3};
+    parallel_tessellator<float> pt {jobs, 0.25f, 16};
+    mesh actual;
+
+    // Twice to check reuse of batch buffers
+    for (int k = 0; k < 2; k++) {
+        for (std::size_t i = 0; i < paths.size(); i++)
+            pt.stroke(paths[i], pens[i]);
+
+        pt.run(actual);
+
+        REQUIRE(pt.count() == 0);
+        REQUIRE(actual.vertices.size() == expected.vertices.size());
+        REQUIRE(actual.indices == expected.indices);
+
+        std::size_t total = 0;
+
+        for (auto const & c: actual.commands)
+            total += c.index_count;
+
+        REQUIRE(total == actual.indices.size());
+    }
+}
@@ -0,0 +1,20 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.13 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <string>
+
+/**
+ * @return Path to the font file @a name from resources/fonts.
+ */
+inline std::string font_path (char const * name)
+{
+    std::string path {__FILE__};
+    path.erase(path.find_last_of("/\\") + 1);
+    return path + "../resources/fonts/" + name;
+}
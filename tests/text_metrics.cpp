@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.07.12 Initial version
+//      2021.07.13 Font metrics of a real face.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/font.hpp"
+#include "pfs/griotte/text_metrics.hpp"
+#include "test_fonts.hpp"
+#include <string>
+#include <vector>
+
+using namespace pfs::griotte;
+
+namespace {
+
+// Every character is 10 pixels wide, ink of 'g' descends below the
+// baseline, space is blank
+struct fake_metrics
+{
+    int calls {0};
+    ink_box box;
+
+    fixed26_6 advance (char32_t)
+    {
+        return fixed26_6{10};
+    }
+
+    ink_box const & ink_bounds (char32_t cp)
+    {
+        ++calls;
+
+        if (cp == ' ')
+            box = ink_box{};
+        else if (cp == 'g')
+            box = ink_box{fixed26_6{1}, fixed26_6{-5}, fixed26_6{9}, fixed26_6{3}};
+        else
+            box = ink_box{fixed26_6{1}, fixed26_6{-7}, fixed26_6{8}, fixed26_6{0}};
+
+        return box;
+    }
+
+    fixed26_6 ascender () const { return fixed26_6{8}; }
+    fixed26_6 descender () const { return fixed26_6{-2}; }
+};
+
+} // namespace
+
+TEST_CASE("Measure text") {
+    fake_metrics m;
+
+    auto e = measure_text(m, std::string{"ag b"});
+
+    REQUIRE(e.advance == fixed26_6{40});
+    REQUIRE(e.ascent == fixed26_6{8});
+    REQUIRE(e.descent == fixed26_6{-2});
+    REQUIRE_FALSE(e.ink.empty());
+    REQUIRE(e.ink.x0 == fixed26_6{1});
+    REQUIRE(e.ink.y0 == fixed26_6{-7});
+    REQUIRE(e.ink.x1 == fixed26_6{38});
+    REQUIRE(e.ink.y1 == fixed26_6{3});
+
+    // Leading blanks do not extend ink
+    e = measure_text(m, std::string{"  a"});
+    REQUIRE(e.advance == fixed26_6{30});
+    REQUIRE(e.ink.x0 == fixed26_6{21});
+
+    // Blank and empty text
+    e = measure_text(m, std::string{"   "});
+    REQUIRE(e.advance == fixed26_6{30});
+    REQUIRE(e.ink.empty());
+
+    e = measure_text(m, "", 0);
+    REQUIRE(e.advance == fixed26_6{0});
+    REQUIRE(e.ink.empty());
+
+    // Code points, not bytes
+    e = measure_text(m, std::string{"\xD0\xB0\xE2\x82\xAC"});
+    REQUIRE(e.advance == fixed26_6{20});
+}
+
+TEST_CASE("Measure text in bulk") {
+    fake_metrics m;
+    std::vector<std::string> cells {"a", "gg", "", "a b"};
+    std::vector<text_extents> out(cells.size());
+
+    measure_text(m, cells.data(), cells.size(), out.data());
+
+    REQUIRE(out[0].advance == fixed26_6{10});
+    REQUIRE(out[1].advance == fixed26_6{20});
+    REQUIRE(out[1].ink.y1 == fixed26_6{3});
+    REQUIRE(out[2].ink.empty());
+    REQUIRE(out[3].advance == fixed26_6{30});
+    REQUIRE(out[3].ink.x1 == fixed26_6{28});
+    REQUIRE(m.calls == 6);
+}
+
+TEST_CASE("Measure text with font metrics") {
+    FT_Library library;
+    REQUIRE(FT_Init_FreeType(& library) == 0);
+
+    FT_Face face;
+    REQUIRE(FT_New_Face(library, font_path("Roboto-Regular.ttf").c_str(), 0, & face) == 0);
+
+    {
+        font f {face};
+        font_metrics m {f, 32};
+        std::string text {"Hg x"};
+
+        // Advances loaded by FreeType directly
+        REQUIRE(FT_Set_Pixel_Sizes(face, 0, 32) == 0);
+        FT_Pos expected = 0;
+
+        for (char c: text) {
+            REQUIRE(FT_Load_Char(face, static_cast<FT_ULong>(c), FT_LOAD_DEFAULT) == 0);
+            expected += face->glyph->advance.x;
+        }
+
+        auto e = measure_text(m, text);
+
+        REQUIRE(e.advance.raw() == expected);
+        REQUIRE(e.ascent == m.ascender());
+        REQUIRE(e.ascent > 0);
+        REQUIRE(e.descent < 0);
+
+        // Ink of 'H' is above the baseline, ink of 'g' descends below it
+        ink_box const & h = m.ink_bounds('H');
+        REQUIRE_FALSE(h.empty());
+        REQUIRE(h.y0 < 0);
+        REQUIRE(h.y1 <= 0);
+
+        ink_box const & g = m.ink_bounds('g');
+        REQUIRE_FALSE(g.empty());
+        REQUIRE(g.y1 > 0);
+
+        REQUIRE(m.ink_bounds(' ').empty());
+        REQUIRE(m.advance(' ') > 0);
+
+        REQUIRE(e.ink.y0 == h.y0);
+        REQUIRE(e.ink.y1 == g.y1);
+
+        // Cached entries give the same result
+        auto e2 = measure_text(m, text);
+        REQUIRE(e2.advance == e.advance);
+        REQUIRE(e2.ink.x1 == e.ink.x1);
+    }
+
+    FT_Done_FreeType(library);
+}
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.27 Initial version
+//      2021.07.13 Added overlapping fills test.
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/griotte_impl.hpp"
+#include "pfs/griotte/tessellator.hpp"
+#include "pfs/griotte/tile_rasterizer.hpp"
+#include <cstring>
+
+using namespace pfs::griotte;
+
+using path_type = path<float>;
+using pen_type = pen<float>;
+
+namespace {
+
+mesh square (float x, float y, float size, color const & c)
+{
+    path_type p;
+    p.move_to(x, y);
+    p.line_to(x + size, y);
+    p.line_to(x + size, y + size);
+    p.line_to(x, y + size);
+    p.close_path();
+
+    mesh m;
+    tessellator<float>{}.fill(p, c, m);
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("Fill spans several tiles") {
+    job_system jobs {2};
+    tile_rasterizer r {jobs, 8, 1};
+    image img {40, 30, color{255, 255, 255}};
+
+    r.draw(square(5, 5, 20, color{255, 0, 0}), img);
+
+    REQUIRE(r.tile_count() == 5 * 4);
+    REQUIRE(img.get_pixel(5, 5) == color{255, 0, 0});
+    REQUIRE(img.get_pixel(24, 24) == color{255, 0, 0});
+    REQUIRE(img.get_pixel(15, 10) == color{255, 0, 0});
+    REQUIRE(img.get_pixel(4, 5) == color{255, 255, 255});
+    REQUIRE(img.get_pixel(25, 24) == color{255, 255, 255});
+    REQUIRE(img.get_pixel(39, 29) == color{255, 255, 255});
+}
+
+TEST_CASE("Overlapping fills of opposite orientation") {
+    job_system jobs {2};
+    tile_rasterizer r {jobs, 8, 1};
+    image img {30, 30, color{255, 255, 255}};
+    color red {255, 0, 0};
+    tessellator<float> t;
+    mesh m;
+
+    // Clockwise
+    path_type p1;
+    p1.move_to(0, 0);
+    p1.line_to(20, 0);
+    p1.line_to(20, 20);
+    p1.line_to(0, 20);
+    p1.close_path();
+
+    // Counter-clockwise
+    path_type p2;
+    p2.move_to(10, 10);
+    p2.line_to(10, 30);
+    p2.line_to(30, 30);
+    p2.line_to(30, 10);
+    p2.close_path();
+
+    t.fill(p1, red, m);
+    t.fill(p2, red, m);
+
+    // Separate fills are separate commands
+    REQUIRE(m.commands.size() == 2);
+
+    r.draw(m, img);
+
+    REQUIRE(img.get_pixel(5, 5) == red);
+    REQUIRE(img.get_pixel(25, 25) == red);
+    REQUIRE(img.get_pixel(15, 15) == red);
+    REQUIRE(img.get_pixel(25, 5) == color{255, 255, 255});
+}
+
+TEST_CASE("Antialiased edge coverage") {
+    job_system jobs {0};
+    tile_rasterizer r {jobs, 16, 2};
+    image img {16, 16, color{0, 0, 0, 0}};
+
+    // Left edge at the middle of the pixel column 2
+    r.draw(square(2.5f, 0, 10, color{0, 0, 255}), img);
+
+    REQUIRE(img.get_pixel(2, 5).get_alpha() == 128);
+    REQUIRE(img.get_pixel(3, 5).get_alpha() == 255);
+    REQUIRE(img.get_pixel(1, 5).get_alpha() == 0);
+}
+
+TEST_CASE("Overlapping stroke triangles are blended once") {
+    job_system jobs {1};
+    tile_rasterizer r {jobs, 8, 1};
+    image img {32, 32, color{255, 255, 255}};
+
+    path_type p;
+    p.move_to(4, 4);
+    p.line_to(28, 4);
+    p.line_to(28, 28);
+
+    mesh m;
+    tessellator<float>{}.stroke(p
+        , pen_type{color{0, 0, 0, 128}, 4, cap_style::butt, join_style::round}, m);
+
+    r.draw(m, img);
+
+    // Segment and join overlap at the corner
+    color corner = img.get_pixel(28, 4);
+    color segment = img.get_pixel(15, 4);
+    REQUIRE(corner == segment);
+    REQUIRE(segment.get_red() == 127);
+}
+
+TEST_CASE("Result does not depend on number of threads") {
+    mesh m;
+    tessellator<float> t;
+
+    for (int i = 0; i < 50; i++) {
+        path_type p;
+        p.move_to(static_cast<float>(i * 3), 0);
+        p.curve_to(100, 50, 0, 150, static_cast<float>(200 - i * 3), 199);
+        t.stroke(p, pen_type{color{i * 5, 100, 200, 200}, 3.5f
+            , cap_style::round, join_style::round}, m);
+    }
+
+    image img1 {200, 200, color{255, 255, 255}};
+    image img2 {200, 200, color{255, 255, 255}};
+
+    job_system seq {0};
+    job_system par {3};
+
+    tile_rasterizer{seq}.draw(m, img1);
+    tile_rasterizer{par, 32}.draw(m, img2);
+
+    REQUIRE(std::memcmp(img1.data(), img2.data(), 200 * 200 * 4) == 0);
+}
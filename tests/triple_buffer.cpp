@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2021 Vladislav Trifochkin
+//
+// This file is part of [pfs-griotte](https://github.com/semenovf/pfs-griotte) library.
+//
+// Changelog:
+//      2021.06.25 Initial version
+////////////////////////////////////////////////////////////////////////////////
+#include "doctest.h"
+#include "pfs/griotte/triple_buffer.hpp"
+#include <thread>
+
+using pfs::griotte::triple_buffer;
+
+TEST_CASE("Latest published value wins") {
+    triple_buffer<int> b;
+
+    REQUIRE_FALSE(b.fetch());
+
+    b.back() = 1;
+    b.publish();
+    b.back() = 2;
+    b.publish();
+
+    REQUIRE(b.has_fresh());
+    REQUIRE(b.fetch());
+    REQUIRE(b.front() == 2);
+    REQUIRE_FALSE(b.fetch());
+    REQUIRE(b.front() == 2);
+
+    b.back() = 3;
+    b.publish();
+    REQUIRE(b.fetch());
+    REQUIRE(b.front() == 3);
+}
+
+TEST_CASE("Consumer sees complete values in order") {
+    struct frame
+    {
+        int seq;
+        int payload[16];
+    };
+
+    triple_buffer<frame> b;
+    int const count = 100000;
+
+    std::thread producer {[&] {
+        for (int i = 1; i <= count; i++) {
+            frame & f = b.back();
+            f.seq = i;
+
+            for (auto & x: f.payload)
+                x = i;
+
+            b.publish();
+        }
+    }};
+
+    int last = 0;
+    bool consistent = true;
+    bool monotonic = true;
+
+    while (last < count) {
+        if (!b.fetch())
+            continue;
+
+        frame const & f = b.front();
+
+        for (auto x: f.payload)
+            consistent = consistent && (x == f.seq);
+
+        monotonic = monotonic && (f.seq > last);
+        last = f.seq;
+    }
+
+    producer.join();
+
+    REQUIRE(consistent);
+    REQUIRE(monotonic);
+    REQUIRE(last == count);
+}